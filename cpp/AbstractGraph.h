@@ -7,6 +7,14 @@
 #ifndef ABSTRACTGRAPH_H_
 #define ABSTRACTGRAPH_H_
 
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+
+#include "components.h"
+#include "Fingerprint.h"
+
 namespace SGL {
 /**
  * \class AbstractGraph
@@ -21,6 +29,8 @@ namespace SGL {
 template <typename T>
 class AbstractGraph {
 public:
+	typedef T vertex_type; /*!< the type of the vertex data */
+
 	virtual ~AbstractGraph() {}
 
 	// Getters (const)
@@ -47,12 +57,26 @@ public:
 	virtual void addEdge(const T&, const T&) = 0;
 	virtual void deleteEdge(const T&, const T&) = 0;
 
+	// Comparison
+	/**
+	 * \brief Order-independent hash of the vertices and edges (see Graph_Fingerprint), the same for equal graphs
+	 * whatever their representation. O(1) when it is kept up to date, O(V+E) otherwise.
+	 */
+	virtual uint64_t fingerprint() const = 0;
+	bool equals(const AbstractGraph &p_other) const;
+
 protected:
 	int m_config;
 	unsigned m_nbVertices;
 
+private:
+	bool _sameEdges(const AbstractGraph &p_other, std::true_type) const;
+	bool _sameEdges(const AbstractGraph &p_other, std::false_type) const;
 };
 
 }
 
+#include "AbstractGraph.hpp"
+
 #endif /* ABSTRACTGRAPH_H_ */
+
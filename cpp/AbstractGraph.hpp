@@ -4,38 +4,73 @@
 //! \version 0.1
 //! \date Oct 22, 2013
 
+#include <unordered_set>
+
 #include "AbstractGraph.h"
 
 using namespace std;
 
-//! \brief Checks the structural equality of the current graph with another (same vertices, same edges)
+namespace SGL {
+
+//! \brief Checks the structural equality of the current graph with another (same vertices, same edges), whatever
+//! their representations. The weights aren't compared.
+//! Different fingerprints answer in O(1) (O(V+E) if one has to be computed again); otherwise the vertices are looked
+//! up and the edge sets compared as hash sets, in O(V+E) (O(E.V) for vertex types with no Vertex_Hash).
 //! \param[in] p_other another graph
 //! \exception bad_alloc if not enough memory
 //! \return true if the graphs are equal, or false
 template <typename T>
 bool AbstractGraph<T>::equals(const AbstractGraph &p_other) const {
-		bool areEqual = true;
+	if ((m_config & UNDIRECTED) != (p_other.m_config & UNDIRECTED) || nbVertices() != p_other.nbVertices()
+			|| fingerprint() != p_other.fingerprint()) {
+		return false;
+	}
+	vector<T> elems = vertices();
 
-		if ((nbVertices() != p_g2.nbVertices()) || (nbEdges() != p_g2.nbEdges())) {
-			areEqual = false;
+	for (unsigned int i = 0; i < elems.size(); i++) {
+		if (!p_other.hasVertex(elems[i])) {
+			return false;
 		}
-		if (areEqual) {
-			vector<T> elems = vertices();
-
-			for (unsigned int i = 0; i < elems.size(); i++) {
-				if (!p_g2.hasVertex(elems[i])) {
-					areEqual = false;
-					break;
-				}
+	}
+	return _sameEdges(p_other, integral_constant<bool, Vertex_Hash<T>::enabled>());
+}
+
+//! \brief Compares the edge sets as hash sets of pairs. Both directions of the undirected edges are put in the sets,
+//! since the graphs don't all list them the same way.
+template <typename T>
+bool AbstractGraph<T>::_sameEdges(const AbstractGraph &p_other, std::true_type) const {
+	typedef unordered_set<pair<T, T>, Vertex_Pair_Hash<T> > Edge_Hash_Set;
+	const bool undirected = (m_config & UNDIRECTED) != 0;
+	vector<pair<T, T> > theEdges[2] = { edges(), p_other.edges() };
+	Edge_Hash_Set sets[2];
+
+	for (unsigned g = 0; g < 2; g++) {
+		sets[g].reserve(theEdges[g].size() * (undirected ? 2 : 1));
+		for (unsigned int i = 0; i < theEdges[g].size(); i++) {
+			sets[g].insert(theEdges[g][i]);
+			if (undirected) {
+				sets[g].insert(pair<T, T>(theEdges[g][i].second, theEdges[g][i].first));
 			}
-			vector<std::pair <T, T> > theEdges = edges();
+		}
+	}
+	return sets[0] == sets[1];
+}
+
+//! \brief Vertex types with no Vertex_Hash: each edge of a graph is looked up in the other
+template <typename T>
+bool AbstractGraph<T>::_sameEdges(const AbstractGraph &p_other, std::false_type) const {
+	const AbstractGraph *graphs[2] = { this, &p_other };
+
+	for (unsigned g = 0; g < 2; g++) {
+		vector<pair<T, T> > theEdges = graphs[g]->edges();
 
-			for (unsigned int i = 0; i < theEdges.size(); i++) {
-				if (!p_g2.hasEdge(theEdges[i].first, theEdges[i].second)) {
-					areEqual = false;
-					break;
-				}
+		for (unsigned int i = 0; i < theEdges.size(); i++) {
+			if (!graphs[1 - g]->hasEdge(theEdges[i].first, theEdges[i].second)) {
+				return false;
 			}
 		}
-		return areEqual;
 	}
+	return true;
+}
+
+} // namespace SGL
@@ -9,23 +9,67 @@
 
 #include <vector>
 #include <string>
+#include <utility>
+#include <type_traits>
 
 #include "AbstractGraph.h"
+#include "VertexIndex.h"
+#include "Fingerprint.h"
+#include "GraphFile.h"
+#include "EdgeSet.h"
+#include "Arena.h"
+#include "Range.h"
+#include "Policies.h"
+#include "PropertyMap.h"
 #include "components.h"
 
 namespace SGL {
 
-template<typename T>
+template<typename, typename, typename> class Adjacency_Matrix;
+template<typename> class Compressed_Sparse_Row;
+
+/**
+ * \class Adjacency_List
+ * \brief Graph stored as one set of outgoing edges per vertex.
+ * The Direction policy (Directed, Undirected or the default Runtime_Direction, see Policies.h) can fix the direction
+ * at compile time; the default reads the UNDIRECTED configuration flag at runtime.
+ * With the Weighted<W> policy each edge stores its weight next to its destination; the default, Unweighted, stores
+ * none (every edge weighs 1).
+ * The Allocator provides the memory of the per-vertex containers (edges and reverse index), not the array of the
+ * vertices. With Arena_Allocator (see Arena.h) each graph gets its own arena, so those millions of small vectors come
+ * out of a few large slabs, freed all at once with the graph or by clear().
+ * It can be converted from an Adjacency_Matrix or a Compressed_Sparse_Row (include their headers) in O(V+E), the
+ * vertex indexes being kept as they are.
+ * save() writes its topology to a binary file, which Mapped_Graph (MappedGraph.h) serves without loading it.
+ */
+template<typename T, typename Direction = Runtime_Direction, typename Weighting = Unweighted,
+		typename Allocator = std::allocator<unsigned> >
 class Adjacency_List : public AbstractGraph<T> {
+	class VertexCursor;
+	class AdjacentCursor;
+	class EdgeCursor;
+
 public:
+	typedef typename Weighting::weight_type weight_type; /*!< the type of the edge weights */
+	typedef Allocator allocator_type; /*!< the allocator of the per-vertex containers */
+	typedef Range<Range_Iterator<VertexCursor> > vertex_range; /*!< lazy range of const T & */
+	typedef Range<Range_Iterator<Value_Cursor<T, Adjacency_List, AdjacentCursor> > > neighbor_range; /*!< lazy range of const T & */
+	typedef Range<Range_Iterator<AdjacentCursor> > adjacent_range; /*!< lazy range of Vertex_Descriptor */
+	typedef Range<Range_Iterator<EdgeCursor> > edge_range; /*!< lazy range of std::pair<const T &, const T &> */
+	typedef Range<Range_Iterator<Weighted_Cursor<AdjacentCursor, weight_type> > > weighted_range; /*!< lazy range of std::pair<Vertex_Descriptor, weight_type> */
 
 	////////////////////////////////////////////////////////////////
 	// Coplien Form
 	////////////////////////////////////////////////////////////////
 	Adjacency_List(configuration p_f = 0);
 	Adjacency_List(const Adjacency_List &);
+	Adjacency_List(Adjacency_List &&) noexcept;
+	template<typename SrcDirection, typename SrcWeighting>
+	explicit Adjacency_List(const Adjacency_Matrix<T, SrcDirection, SrcWeighting> &);
+	explicit Adjacency_List(const Compressed_Sparse_Row<T> &);
 	~Adjacency_List() {}
 	Adjacency_List &operator=(const Adjacency_List &);
+	Adjacency_List &operator=(Adjacency_List &&) noexcept;
 
 	////////////////////////////////////////////////////////////////
 	// Getters (const)
@@ -34,13 +78,14 @@ public:
 	 * \brief Returns the number of vertices in the matrix
 	 * \return the number of vertices in the matrix
 	 */
-	inline unsigned nbVertices() const { return m_nodes.size(); }
+	inline unsigned nbVertices() const { return this->m_nbVertices; }
 
 	/**
-	 * \brief Returns the number of edges in the list
+	 * \brief Returns the number of edges in the list (as listed by edges(), so both directions of an undirected edge count)
+	 * Kept up to date by the mutators: O(1).
 	 * \return the number of edges in the list
 	 */
-	unsigned nbEdges() const { return edges().size(); };
+	inline unsigned nbEdges() const { return m_nbEdges; }
 
 	/**
 	 * \brief Alias of the nbVertices method
@@ -76,55 +121,278 @@ public:
 	unsigned vertexInDegree(const T &) const;
 	unsigned vertexOutDegree(const T &) const;
 	std::vector<T> vertexNeighborhood(const T&, bool p_closed = false) const;
+	std::vector<T> vertexPredecessors(const T&) const;
 	std::vector<T> vertices() const;
 	bool hasEdge(const T &, const T &) const;
+	weight_type edgeWeight(const T &, const T &) const;
 	std::vector<std::pair<T, T> > edges() const;
+	vertex_range vertexRange() const;
+	neighbor_range neighborRange(const T &) const;
+	edge_range edgeRange() const;
+	uint64_t fingerprint() const;
 
+	////////////////////////////////////////////////////////////////
+	// Vertex descriptors: no vertex lookup
+	////////////////////////////////////////////////////////////////
+	Vertex_Descriptor descriptor(const T &) const;
+
+	/**
+	 * \brief Returns the data of a vertex from its descriptor
+	 * \pre p_vd is a valid descriptor of this graph
+	 */
+	inline const T &value(Vertex_Descriptor p_vd) const { return m_nodes[p_vd.index()].m_data; }
+
+	/**
+	 * \brief Upper bound of the indexes of the descriptors (tombstones included), to size per-vertex arrays
+	 */
+	inline unsigned indexBound() const { return m_nodes.size(); }
+
+	/**
+	 * \brief The observers following the vertex indexes, such as the Vertex_Property attached to the graph
+	 */
+	inline Observer_List &observers() const { return m_observers; }
+
+	bool hasEdge(Vertex_Descriptor, Vertex_Descriptor) const;
+	unsigned inDegree(Vertex_Descriptor) const;
+	unsigned outDegree(Vertex_Descriptor) const;
+	adjacent_range neighbors(Vertex_Descriptor) const;
+	weighted_range weightedNeighbors(Vertex_Descriptor) const;
+	weight_type edgeWeight(Vertex_Descriptor, Vertex_Descriptor) const;
+	void addEdge(Vertex_Descriptor, Vertex_Descriptor);
+	void addEdge(Vertex_Descriptor, Vertex_Descriptor, const weight_type &);
+	void setEdgeWeight(Vertex_Descriptor, Vertex_Descriptor, const weight_type &);
+	void deleteEdge(Vertex_Descriptor, Vertex_Descriptor);
 
 	////////////////////////////////////////////////////////////////
 	// Setters (mutators)
 	////////////////////////////////////////////////////////////////
 	void addVertex(const T &);
+	void addVertex(T &&);
+	template<typename... Args> void emplaceVertex(Args &&...);
 	void deleteVertex(const T &);
 	void addEdge(const T&, const T&);
+	void addEdge(const T&, const T&, const weight_type &);
+	void setEdgeWeight(const T&, const T&, const weight_type &);
 	void deleteEdge(const T&, const T&);
+	template<typename InputIterator> void addVertices(InputIterator, InputIterator);
+	template<typename InputIterator> void addEdges(InputIterator, InputIterator);
+	void compact();
+	void clear();
 
 	////////////////////////////////////////////////////////////////
 	// Others
 	////////////////////////////////////////////////////////////////
 	bool operator==(const Adjacency_List &p_rhs) const;
+	void save(const std::string &p_path) const;
+
 
 //	friend inline std::ostream &operator<<(std::ostream &p_stream, const Adjacency_List &p_list) { p_stream << p_list._repr(); return p_stream; }
 
+	template<typename> friend class Compressed_Sparse_Row;
+	template<typename> friend class Graph_Builder;
+	template<typename> friend class Graph_Writer;
+	template<typename, typename, typename> friend class Adjacency_Matrix;
+
 private:
+	typedef typename Weighting::Slot Slot;
+	typedef std::vector<unsigned, typename std::allocator_traits<Allocator>::template rebind_alloc<unsigned> > Index_List;
+
 	/**
 	 * \class Edge
-	 * \brief Internal representation of an edge in the adjacency list.
+	 * \brief Internal representation of an edge in the adjacency list: its destination, and its weight (in the Slot
+	 * base class, empty when the list is unweighted).
 	 */
-	class Edge {
+	class Edge : public Slot {
 	public:
-		Edge(unsigned p_dest_idx, int p_weight=0) : m_dest(p_dest_idx), m_weight(p_weight) {}
+		explicit Edge(unsigned p_dest_idx) : m_dest(p_dest_idx) {}
+		Edge(unsigned p_dest_idx, const Slot &p_slot) : Slot(p_slot), m_dest(p_dest_idx) {}
 		~Edge() {}
 
 		unsigned m_dest;
-		int	m_weight;
 	};
 
+	typedef Edge_Set<Edge, Allocator> Edges;
+
 	/**
 	 * \class Node
 	 * \brief Internal representation of a vertex in the adjacency list.
+	 * Its containers keep the allocator they were built with, also through assignments.
+	 * It moves without copying its edges, so that the reallocations and the shifts of m_nodes are cheap.
 	 */
 	class Node {
 	public:
 		T m_data; /*!< data of a vertex */
-		std::vector<Edge> m_edges; /*!< this list contains all the edges the vertex is the source of */
+		Edges m_edges; /*!< this set contains all the edges the vertex is the source of */
+		Index_List m_inEdges; /*!< indexes of the sources of the edges coming to the vertex (directed graphs with REVERSE_ADJACENCY only) */
+
+		unsigned m_outDegree; /*!< out-degree of the vertex (an undirected loop counts twice) */
+		unsigned m_inDegree; /*!< in-degree of the vertex (an undirected loop counts twice) */
+		bool m_deleted; /*!< tombstone left by a deferred deletion */
+		unsigned m_staleInEdges; /*!< (tombstones only) number of edges still pointing to this slot */
+
+		Node(const T& p_data, const Allocator &p_alloc) : m_data(p_data), m_edges(p_alloc), m_inEdges(p_alloc),
+				m_outDegree(0), m_inDegree(0), m_deleted(false), m_staleInEdges(0) {}
+		Node(T &&p_data, const Allocator &p_alloc) : m_data(std::move(p_data)), m_edges(p_alloc), m_inEdges(p_alloc),
+				m_outDegree(0), m_inDegree(0), m_deleted(false), m_staleInEdges(0) {}
+		Node(const Node & p_src) : m_data(p_src.m_data), m_edges(p_src.m_edges), m_inEdges(p_src.m_inEdges),
+				m_outDegree(p_src.m_outDegree), m_inDegree(p_src.m_inDegree),
+				m_deleted(p_src.m_deleted), m_staleInEdges(p_src.m_staleInEdges) {}
+		Node(const Node & p_src, const Allocator &p_alloc) : m_data(p_src.m_data), m_edges(p_src.m_edges, p_alloc),
+				m_inEdges(p_src.m_inEdges.begin(), p_src.m_inEdges.end(), p_alloc),
+				m_outDegree(p_src.m_outDegree), m_inDegree(p_src.m_inDegree),
+				m_deleted(p_src.m_deleted), m_staleInEdges(p_src.m_staleInEdges) {}
+		Node(Node &&p_src) noexcept(std::is_nothrow_move_constructible<T>::value) :
+				m_data(std::move(p_src.m_data)), m_edges(std::move(p_src.m_edges)), m_inEdges(std::move(p_src.m_inEdges)),
+				m_outDegree(p_src.m_outDegree), m_inDegree(p_src.m_inDegree),
+				m_deleted(p_src.m_deleted), m_staleInEdges(p_src.m_staleInEdges) {}
+		Node &operator=(const Node &p_src) {
+			m_data = p_src.m_data;
+			m_edges = p_src.m_edges;
+			m_inEdges = p_src.m_inEdges;
+			m_outDegree = p_src.m_outDegree;
+			m_inDegree = p_src.m_inDegree;
+			m_deleted = p_src.m_deleted;
+			m_staleInEdges = p_src.m_staleInEdges;
+			return *this;
+		}
+		Node &operator=(Node &&p_src) {
+			m_data = std::move(p_src.m_data);
+			m_edges = std::move(p_src.m_edges);
+			m_inEdges = std::move(p_src.m_inEdges);
+			m_outDegree = p_src.m_outDegree;
+			m_inDegree = p_src.m_inDegree;
+			m_deleted = p_src.m_deleted;
+			m_staleInEdges = p_src.m_staleInEdges;
+			return *this;
+		}
+	};
+	/**
+	 * \class VertexCursor
+	 * \brief Walks the nodes, skipping the tombstones
+	 */
+	class VertexCursor {
+	public:
+		typedef T value_type;
+		typedef const T &reference;
+
+		VertexCursor() : m_list(NULL), m_idx(0) {}
+		VertexCursor(const Adjacency_List *p_list, unsigned p_idx) : m_list(p_list), m_idx(p_idx) { _skip(); }
 
-		Node(const T& p_data) : m_data(p_data) {}
-		Node(const Node & p_src) : m_data(p_src.m_data), m_edges(p_src.m_edges) {}
+		reference get() const { return m_list->m_nodes[m_idx].m_data; }
+		void next() { m_idx++; _skip(); }
+		bool operator==(const VertexCursor &p_rhs) const { return m_idx == p_rhs.m_idx; }
+
+	private:
+		void _skip() {
+			while (m_idx < m_list->m_nodes.size() && m_list->m_nodes[m_idx].m_deleted) {
+				m_idx++;
+			}
+		}
+
+		const Adjacency_List *m_list;
+		unsigned m_idx;
 	};
+
+	/**
+	 * \class AdjacentCursor
+	 * \brief Walks the edge set of a node, skipping the stale edges
+	 */
+	class AdjacentCursor {
+	public:
+		typedef Vertex_Descriptor value_type;
+		typedef Vertex_Descriptor reference;
+
+		AdjacentCursor() : m_list(NULL), m_edges(NULL), m_pos(0) {}
+		AdjacentCursor(const Adjacency_List *p_list, const Edges *p_edges, unsigned p_pos) :
+				m_list(p_list), m_edges(p_edges), m_pos(p_pos) { _skip(); }
+
+		reference get() const { return Vertex_Descriptor((*m_edges)[m_pos].m_dest); }
+		weight_type weight() const { return (*m_edges)[m_pos].weight(); }
+		void next() { m_pos++; _skip(); }
+		bool operator==(const AdjacentCursor &p_rhs) const { return m_pos == p_rhs.m_pos; }
+
+	private:
+		void _skip() {
+			while (m_pos < m_edges->size() && m_list->_isStale((*m_edges)[m_pos])) {
+				m_pos++;
+			}
+		}
+
+		const Adjacency_List *m_list;
+		const Edges *m_edges;
+		unsigned m_pos;
+	};
+
+	/**
+	 * \class EdgeCursor
+	 * \brief Walks the edge sets of all the nodes one after the other, skipping the stale edges
+	 */
+	class EdgeCursor {
+	public:
+		typedef std::pair<T, T> value_type;
+		typedef std::pair<const T &, const T &> reference;
+
+		EdgeCursor() : m_list(NULL), m_src(0), m_pos(0) {}
+		EdgeCursor(const Adjacency_List *p_list, unsigned p_src) : m_list(p_list), m_src(p_src), m_pos(0) { _skip(); }
+
+		reference get() const {
+			const Node &src = m_list->m_nodes[m_src];
+
+			return reference(src.m_data, m_list->m_nodes[src.m_edges[m_pos].m_dest].m_data);
+		}
+		void next() { m_pos++; _skip(); }
+		bool operator==(const EdgeCursor &p_rhs) const { return m_src == p_rhs.m_src && m_pos == p_rhs.m_pos; }
+
+	private:
+		void _skip() {
+			while (m_src < m_list->m_nodes.size()) {
+				const Edges &edges = m_list->m_nodes[m_src].m_edges;
+
+				if (m_pos >= edges.size()) {
+					m_src++;
+					m_pos = 0;
+				} else if (m_list->_isStale(edges[m_pos])) {
+					m_pos++;
+				} else {
+					break;
+				}
+			}
+		}
+
+		const Adjacency_List *m_list;
+		unsigned m_src;
+		unsigned m_pos;
+	};
+
+	Allocator_Source<Allocator> m_allocator; /*!< gives the allocator of the nodes (declared first, so destroyed last) */
 	std::vector<Node> m_nodes; /*!< internal container for the adjacency list nodes */
+	Vertex_Index<T> m_index; /*!< vertex data -> index in m_nodes */
+	unsigned m_nbEdges; /*!< number of edges, as listed by edges() */
+	std::vector<unsigned> m_freeSlots; /*!< tombstoned nodes, reused by addVertex (DEFERRED_DELETION only) */
+	unsigned m_nbStaleEdges; /*!< edges still going to tombstoned nodes, removed lazily (DEFERRED_DELETION only) */
+	mutable Observer_List m_observers; /*!< told about every change of the vertex indexes */
+	mutable Graph_Fingerprint<T> m_fingerprint; /*!< kept up to date by the mutators, or computed again when invalidated */
 
 	void	_copyAdjacencyList(const Adjacency_List &p_src);
+	void	_swap(Adjacency_List &);
+	void	_countEdges();
+	void	_computeFingerprint() const;
+	template<typename W> static Slot _slot(const W &p_weight, std::true_type) { return Slot(p_weight); }
+	template<typename W> static Slot _slot(const W &, std::false_type) { return Slot(); }
+
+	bool	_isUndirected() const { return Direction::isUndirected(this->m_config); }
+	bool	_hasReverseIndex() const { return hasConfiguration(REVERSE_ADJACENCY) && !_isUndirected(); }
+	bool	_isStale(const Edge &p_edge) const { return m_nbStaleEdges > 0 && m_nodes[p_edge.m_dest].m_deleted; }
+	unsigned _outDegree(unsigned) const;
+	void	_insertVertex(T &&);
+
+	void	_addEdge(unsigned, unsigned, const Slot &p_slot = Slot());
+	void	_linkEdge(unsigned, unsigned, const Slot &p_slot = Slot());
+	void	_setEdgeWeight(unsigned, unsigned, const weight_type &);
+	void	_deleteEdge(unsigned, unsigned);
+	void	_tombstone(unsigned);
+	void	_purgeStaleEdges();
+	bool	_find(const T &, unsigned &) const;
 	unsigned _index(const T &p_v) const;
 	unsigned _edgeIndex(unsigned, unsigned) const;
 	const std::string _repr() const;
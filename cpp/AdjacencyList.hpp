@@ -5,6 +5,7 @@
 //! \date Oct 19, 2013
 
 #include <stdexcept>
+#include <algorithm> // std::find, std::sort, std::adjacent_find
 
 using namespace std;
 
@@ -16,229 +17,1117 @@ namespace SGL {
  *  \param[in] p_flags the configuration flags of the graph
  *  \exception bad_alloc in case of insufficient memory
  */
-template<typename T>
-Adjacency_List<T>::Adjacency_List(configuration p_flags) {
-	this->m_config = p_flags;
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+Adjacency_List<T, Direction, Weighting, Allocator>::Adjacency_List(configuration p_flags) :
+		m_nbEdges(0), m_nbStaleEdges(0) {
+	this->m_config = Weighting::configure(Direction::configure(p_flags));
+	this->m_nbVertices = 0;
 }
 
-template<typename T>
-Adjacency_List<T>::Adjacency_List(const Adjacency_List<T> &p_src) {
-	// TODO : refactor this function
-	// copies the nodes and the edges at the same time
-	for (unsigned v = 0; v < p_src.m_nodes.size(); v++) {
-		Node copy(p_src.m_nodes[v]);
-
-		m_nodes.push_back(copy);
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+Adjacency_List<T, Direction, Weighting, Allocator>::Adjacency_List(const Adjacency_List<T, Direction, Weighting, Allocator> &p_src) :
+		m_index(p_src.m_index), m_nbEdges(p_src.m_nbEdges),
+		m_freeSlots(p_src.m_freeSlots), m_nbStaleEdges(p_src.m_nbStaleEdges), m_fingerprint(p_src.m_fingerprint) {
+	// copies the nodes and the edges at the same time, into the memory of this graph
+	m_nodes.reserve(p_src.m_nodes.size());
+	for (unsigned i = 0; i < p_src.m_nodes.size(); i++) {
+		m_nodes.push_back(Node(p_src.m_nodes[i], m_allocator.get()));
 	}
+	this->m_config = p_src.m_config;
 	this->m_nbVertices = p_src.m_nbVertices;
 }
 
-template<typename T>
-bool Adjacency_List<T>::hasVertex(const T & p_elem) const {
-	bool present = true;
+/**
+ * \brief Move constructor: takes the nodes of the source (and their memory) without copying anything
+ * \post The source is an empty graph with the same configuration
+ * Nothing is allocated: the source is left without any arena, it gets a new one with its next vertex.
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+Adjacency_List<T, Direction, Weighting, Allocator>::Adjacency_List(Adjacency_List<T, Direction, Weighting, Allocator> &&p_src) noexcept :
+		m_nbEdges(0), m_nbStaleEdges(0) {
+	this->m_config = p_src.m_config;
+	this->m_nbVertices = 0;
+	_swap(p_src);
+	p_src.m_observers.verticesReset(0);
+}
+
+/**
+ * \brief Conversion from an adjacency matrix, in O(V^2/64 + E): the vertices keep their indexes, and the edges are
+ * read from the bit matrix word by word, straight into edge sets reserved with their final size, without any vertex
+ * lookup nor duplicate check.
+ * The weights are kept when both graphs are weighted.
+ * \param[in] p_src the adjacency matrix to convert, whose configuration is taken
+ * \exception logic_error if the direction of the matrix doesn't match the Direction policy of the list
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+template<typename SrcDirection, typename SrcWeighting>
+Adjacency_List<T, Direction, Weighting, Allocator>::Adjacency_List(const Adjacency_Matrix<T, SrcDirection, SrcWeighting> &p_src) :
+		Adjacency_List(p_src.getConfiguration()) {
+	typedef std::integral_constant<bool, Weighting::isWeighted && SrcWeighting::isWeighted> Keep_Weights;
+	const typename Adjacency_Matrix<T, SrcDirection, SrcWeighting>::Storage &matrix = *p_src.m_matrix;
+	const unsigned nbVertices = p_src.m_elems.size();
+
+	if (_isUndirected() != p_src._isUndirected()) {
+		throw logic_error("Adjacency_List: the matrix doesn't have the same direction");
+	}
+	m_nodes.reserve(nbVertices);
+	for (unsigned v = 0; v < nbVertices; v++) {
+		m_nodes.emplace_back(T(p_src.m_elems[v]), m_allocator.get());
+	}
+	m_index = p_src.m_index;
+	// an undirected matrix only stores the lower triangle (nextEdge): each edge is stored both ways here
+	if (_isUndirected()) {
+		vector<unsigned> degrees(nbVertices, 0);
+
+		for (unsigned src = 0; src < nbVertices; src++) {
+			for (unsigned dest = matrix.nextEdge(src, 0); dest < nbVertices; dest = matrix.nextEdge(src, dest + 1)) {
+				degrees[src]++;
+				degrees[dest] += (dest != src);
+			}
+		}
+		for (unsigned v = 0; v < nbVertices; v++) {
+			m_nodes[v].m_edges.reserve(degrees[v]);
+		}
+	} else {
+		for (unsigned v = 0; v < nbVertices; v++) {
+			m_nodes[v].m_edges.reserve(matrix.outDegree(v)); // popcount of the row
+		}
+	}
+	for (unsigned src = 0; src < nbVertices; src++) {
+		for (unsigned dest = matrix.nextEdge(src, 0); dest < nbVertices; dest = matrix.nextEdge(src, dest + 1)) {
+			Slot slot = _slot(p_src._weight(src, dest), Keep_Weights());
 
-	try {
-		_index(p_elem);
-	} catch (const logic_error &) {
-		present = false;
+			m_nodes[src].m_edges.insert(Edge(dest, slot));
+			if (_isUndirected() && src != dest) {
+				m_nodes[dest].m_edges.insert(Edge(src, slot));
+			}
+		}
+	}
+	this->m_nbVertices = m_nodes.size();
+	_countEdges();
+}
+
+/**
+ * \brief Conversion from a compressed sparse row graph, in O(V+E): the vertices keep their indexes, and each slice
+ * of neighbors becomes an edge set, without any vertex lookup nor duplicate check.
+ * \param[in] p_src the graph to convert, whose configuration is taken
+ * \exception logic_error if the direction of the graph doesn't match the Direction policy of the list
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+Adjacency_List<T, Direction, Weighting, Allocator>::Adjacency_List(const Compressed_Sparse_Row<T> &p_src) :
+		Adjacency_List(p_src.getConfiguration()) {
+	if (_isUndirected() != p_src.hasConfiguration(UNDIRECTED)) {
+		throw logic_error("Adjacency_List: the graph doesn't have the same direction");
+	}
+	m_nodes.reserve(p_src.m_elems.size());
+	// the rows of an undirected graph already hold both directions of each edge
+	for (unsigned v = 0; v < p_src.m_elems.size(); v++) {
+		m_nodes.emplace_back(T(p_src.m_elems[v]), m_allocator.get());
+		m_nodes[v].m_edges.reserve(p_src.m_offsets[v + 1] - p_src.m_offsets[v]);
+		for (unsigned pos = p_src.m_offsets[v]; pos < p_src.m_offsets[v + 1]; pos++) {
+			m_nodes[v].m_edges.insert(Edge(p_src.m_neighbors[pos]));
+		}
 	}
-	return present;
+	m_index = p_src.m_index;
+	this->m_nbVertices = m_nodes.size();
+	_countEdges();
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+Adjacency_List<T, Direction, Weighting, Allocator> &Adjacency_List<T, Direction, Weighting, Allocator>::operator=(const Adjacency_List<T, Direction, Weighting, Allocator> &p_src) {
+	Adjacency_List<T, Direction, Weighting, Allocator> copy(p_src);
+
+	_swap(copy);
+	m_observers.verticesReset(m_nodes.size());
+	return (*this);
+}
+
+/**
+ * \brief Move assignment: the previous content of the graph is freed, the source is left empty
+ * Only the Vertex_Property objects attached to the graph may allocate, to be resized: running out of memory there
+ * terminates the program.
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+Adjacency_List<T, Direction, Weighting, Allocator> &Adjacency_List<T, Direction, Weighting, Allocator>::operator=(Adjacency_List<T, Direction, Weighting, Allocator> &&p_src) noexcept {
+	Adjacency_List<T, Direction, Weighting, Allocator> moved(std::move(p_src));
+
+	_swap(moved);
+	m_observers.verticesReset(m_nodes.size());
+	return (*this);
 }
 
-template<typename T>
-bool Adjacency_List<T>::vertexIsSource(const T &p_elem) const {
-	if (hasConfiguration(UNDIRECTED)) {
+/**
+ * \brief Exchanges the contents of two graphs, but not their observers
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_swap(Adjacency_List<T, Direction, Weighting, Allocator> &p_other) {
+	std::swap(this->m_config, p_other.m_config);
+	std::swap(this->m_nbVertices, p_other.m_nbVertices);
+	// the nodes go with the memory they were allocated from
+	m_allocator.swap(p_other.m_allocator);
+	m_nodes.swap(p_other.m_nodes);
+	std::swap(m_index, p_other.m_index);
+	std::swap(m_nbEdges, p_other.m_nbEdges);
+	m_freeSlots.swap(p_other.m_freeSlots);
+	std::swap(m_nbStaleEdges, p_other.m_nbStaleEdges);
+	std::swap(m_fingerprint, p_other.m_fingerprint);
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+bool Adjacency_List<T, Direction, Weighting, Allocator>::hasVertex(const T & p_elem) const {
+	unsigned idx;
+
+	return _find(p_elem, idx);
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+bool Adjacency_List<T, Direction, Weighting, Allocator>::vertexIsSource(const T &p_elem) const {
+	if (_isUndirected()) {
 		throw logic_error("vertexIsSource: the graph is undirected");
 	}
 	return (vertexInDegree(p_elem) == 0);
 }
 
-template<typename T>
-bool Adjacency_List<T>::vertexIsSink(const T &p_elem) const {
-	if (hasConfiguration(UNDIRECTED)) {
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+bool Adjacency_List<T, Direction, Weighting, Allocator>::vertexIsSink(const T &p_elem) const {
+	if (_isUndirected()) {
 		throw logic_error("vertexIsSink: the graph is undirected");
 	}
 	return (vertexOutDegree(p_elem) == 0);
 }
 
-template<typename T>
-unsigned Adjacency_List<T>::vertexInDegree(const T &p_v) const {
-	unsigned inDeg = 0;
-	unsigned v_idx = _index(p_v); // throws logic error if the elem's not in the graph
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+unsigned Adjacency_List<T, Direction, Weighting, Allocator>::vertexInDegree(const T &p_v) const {
+	return m_nodes[_index(p_v)].m_inDegree; // throws logic error if the elem's not in the graph
+}
 
-	for (unsigned v = 0; v < m_nodes.size(); v++) {
-		for (unsigned edge_idx = 0; edge_idx != m_nodes[v].m_edges.size(); edge_idx++) {
-			if (m_nodes[v].m_edges[edge_idx].m_dest == v_idx) {
-				inDeg++;
-				// if the graph is undirected: a loop counts twice
-				if (v == v_idx && hasConfiguration(UNDIRECTED)) {
-					inDeg++;
-				}
-			}
-		}
-	}
-	return inDeg;
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+unsigned Adjacency_List<T, Direction, Weighting, Allocator>::vertexOutDegree(const T &p_v) const {
+	return _outDegree(_index(p_v)); // throws logic error if the elem's not in the graph
 }
 
-template<typename T>
-unsigned Adjacency_List<T>::vertexOutDegree(const T &p_v) const {
-	unsigned v_idx = _index(p_v); // throws logic error if the elem's not in the graph
-	unsigned outDeg = m_nodes[v_idx].m_edges.size();
-	// if the graph is undirected: a loop counts twice
-	if (hasConfiguration(UNDIRECTED) && hasEdge(p_v, p_v)) {
-		outDeg++;
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+std::vector<T> Adjacency_List<T, Direction, Weighting, Allocator>::vertexNeighborhood(const T &p_v, bool p_closed) const {
+	neighbor_range range = neighborRange(p_v); // throws logic error if the elem's not in the graph
+	vector<T> neighbors(range.begin(), range.end());
+
+	if (p_closed) {
+		neighbors.push_back(p_v);
 	}
-	return outDeg;
+	return neighbors;
 }
 
-template<typename T>
-std::vector<T> Adjacency_List<T>::vertexNeighborhood(const T &p_v, bool p_closed) const {
+/**
+ * \brief Lists the vertices having an edge going to a vertex.
+ * O(in-degree) in a directed graph with REVERSE_ADJACENCY or in an undirected graph, O(V+E) otherwise.
+ * \param[in] p_v the vertex we want the predecessors of
+ * \exception logic_error if the vertex isn't in the graph
+ * \return the data of all the predecessors of the vertex
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+std::vector<T> Adjacency_List<T, Direction, Weighting, Allocator>::vertexPredecessors(const T &p_v) const {
 	unsigned v_idx = _index(p_v); // throws logic error if the elem's not in the graph
-	vector<T> neighbors;
+	vector<T> predecessors;
 
-	for (unsigned edge_idx = 0; edge_idx != m_nodes[v_idx].m_edges.size(); edge_idx++) {
-		unsigned nghbr_idx = m_nodes[v_idx].m_edges[edge_idx].m_dest; // get the neighbor index stored in the edge
+	if (_isUndirected()) {
+		return vertexNeighborhood(p_v);
+	}
+	if (_hasReverseIndex()) {
+		const Index_List &inEdges = m_nodes[v_idx].m_inEdges;
 
-		neighbors.push_back(m_nodes[nghbr_idx].m_data);
+		for (unsigned pos = 0; pos < inEdges.size(); pos++) {
+			predecessors.push_back(m_nodes[inEdges[pos]].m_data);
+		}
+		return predecessors;
 	}
-	if (p_closed) {
-		neighbors.push_back(m_nodes[v_idx].m_data);
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		for (unsigned edge_idx = 0; edge_idx != m_nodes[v].m_edges.size(); edge_idx++) {
+			if (m_nodes[v].m_edges[edge_idx].m_dest == v_idx) {
+				predecessors.push_back(m_nodes[v].m_data);
+			}
+		}
 	}
-	return neighbors;
+	return predecessors;
 }
 
-template<typename T>
-std::vector<T> Adjacency_List<T>::vertices() const {
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+std::vector<T> Adjacency_List<T, Direction, Weighting, Allocator>::vertices() const {
+	vertex_range range = vertexRange();
 	vector<T> vertices;
 
-	for (unsigned idx = 0; idx != m_nodes.size(); idx++) {
-		vertices.push_back(m_nodes[idx].m_data);
-	}
+	vertices.reserve(this->m_nbVertices);
+	vertices.insert(vertices.end(), range.begin(), range.end());
 	return vertices;
 }
 
-template<typename T>
-bool Adjacency_List<T>::hasEdge(const T &p_src, const T &p_dest) const {
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+bool Adjacency_List<T, Direction, Weighting, Allocator>::hasEdge(const T &p_src, const T &p_dest) const {
 	unsigned src_idx = _index(p_src); // throws logic error if the elem's not in the graph
 	unsigned dest_idx = _index(p_dest); // throws logic error if the elem's not in the graph
-	bool present = true;
+	unsigned edge_idx;
 
-	try {
-		_edgeIndex(src_idx, dest_idx);
-	} catch (const logic_error &) {
-		present = false;
-	}
-	return present;
+	return m_nodes[src_idx].m_edges.find(dest_idx, edge_idx);
 }
 
-template<typename T>
-std::vector<std::pair<T, T> > Adjacency_List<T>::edges() const {
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+std::vector<std::pair<T, T> > Adjacency_List<T, Direction, Weighting, Allocator>::edges() const {
+	edge_range range = edgeRange();
 	vector<pair<T, T> > edges;
 
-	for (unsigned idx = 0; idx != m_nodes.size(); idx++) {
-		for (unsigned edge_idx = 0; edge_idx < m_nodes[idx].m_edges.size(); edge_idx++) {
-			unsigned dest_idx = m_nodes[idx].m_edges[edge_idx].m_dest;
-			pair<T, T> newedge = make_pair(m_nodes[idx].m_data, m_nodes[dest_idx].m_data);
-
-			edges.push_back(newedge);
-		}
+	edges.reserve(m_nbEdges);
+	for (typename edge_range::iterator it = range.begin(); it != range.end(); ++it) {
+		edges.push_back(*it);
 	}
 	return edges;
 }
 
-template<typename T>
-void Adjacency_List<T>::addVertex(const T &p_elem) {
+/**
+ * \brief Order-independent hash of the vertices and edges, kept up to date by the mutators: O(1), or O(V+E) after a
+ * bulk load or deferred deletions leaving unindexed stale edges
+ * \return the same value as any equal graph, whatever its representation
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+uint64_t Adjacency_List<T, Direction, Weighting, Allocator>::fingerprint() const {
+	if (!m_fingerprint.isValid()) {
+		_computeFingerprint();
+	}
+	return m_fingerprint.value();
+}
+
+/**
+ * \brief Lazy range over the vertices, in the same order as vertices(), without copying them
+ * \return a forward range of const T &, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+typename Adjacency_List<T, Direction, Weighting, Allocator>::vertex_range Adjacency_List<T, Direction, Weighting, Allocator>::vertexRange() const {
+	return vertex_range(Range_Iterator<VertexCursor>(VertexCursor(this, 0)),
+			Range_Iterator<VertexCursor>(VertexCursor(this, m_nodes.size())));
+}
+
+/**
+ * \brief Lazy range over the neighbors of a vertex (open neighborhood), without copying them
+ * \param[in] p_v the vertex we want the neighbors of
+ * \exception logic_error if the vertex isn't in the graph
+ * \return a forward range of const T &, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+typename Adjacency_List<T, Direction, Weighting, Allocator>::neighbor_range Adjacency_List<T, Direction, Weighting, Allocator>::neighborRange(const T &p_v) const {
+	typedef Value_Cursor<T, Adjacency_List, AdjacentCursor> Cursor;
+	const Edges &edges = m_nodes[_index(p_v)].m_edges; // throws logic error if the elem's not in the graph
+
+	return neighbor_range(Range_Iterator<Cursor>(Cursor(this, AdjacentCursor(this, &edges, 0))),
+			Range_Iterator<Cursor>(Cursor(this, AdjacentCursor(this, &edges, edges.size()))));
+}
+
+/**
+ * \brief Returns the descriptor of a vertex, to use the methods which don't look the vertex up
+ * \param[in] p_v the vertex
+ * \exception logic_error if the vertex isn't in the graph
+ * \return the descriptor of the vertex
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+Vertex_Descriptor Adjacency_List<T, Direction, Weighting, Allocator>::descriptor(const T &p_v) const {
+	return Vertex_Descriptor(_index(p_v)); // throws logic error if the elem's not in the graph
+}
+
+/**
+ * \pre the descriptors are valid descriptors of this graph (they aren't checked)
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+bool Adjacency_List<T, Direction, Weighting, Allocator>::hasEdge(Vertex_Descriptor p_src, Vertex_Descriptor p_dest) const {
+	unsigned edge_idx;
+
+	return m_nodes[p_src.index()].m_edges.find(p_dest.index(), edge_idx);
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+unsigned Adjacency_List<T, Direction, Weighting, Allocator>::inDegree(Vertex_Descriptor p_vd) const {
+	return m_nodes[p_vd.index()].m_inDegree;
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+unsigned Adjacency_List<T, Direction, Weighting, Allocator>::outDegree(Vertex_Descriptor p_vd) const {
+	return _outDegree(p_vd.index());
+}
+
+/**
+ * \brief Lazy range over the descriptors of the neighbors of a vertex (open neighborhood)
+ * \return a forward range of Vertex_Descriptor, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+typename Adjacency_List<T, Direction, Weighting, Allocator>::adjacent_range Adjacency_List<T, Direction, Weighting, Allocator>::neighbors(Vertex_Descriptor p_vd) const {
+	const Edges &edges = m_nodes[p_vd.index()].m_edges;
+
+	return adjacent_range(Range_Iterator<AdjacentCursor>(AdjacentCursor(this, &edges, 0)),
+			Range_Iterator<AdjacentCursor>(AdjacentCursor(this, &edges, edges.size())));
+}
+
+/**
+ * \brief Lazy range over the neighbors of a vertex with the weights of the edges going to them
+ * \return a forward range of std::pair<Vertex_Descriptor, weight_type>, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+typename Adjacency_List<T, Direction, Weighting, Allocator>::weighted_range Adjacency_List<T, Direction, Weighting, Allocator>::weightedNeighbors(Vertex_Descriptor p_vd) const {
+	typedef Range_Iterator<Weighted_Cursor<AdjacentCursor, weight_type> > Iterator;
+	const Edges &edges = m_nodes[p_vd.index()].m_edges;
+
+	return weighted_range(Iterator(Weighted_Cursor<AdjacentCursor, weight_type>(AdjacentCursor(this, &edges, 0))),
+			Iterator(Weighted_Cursor<AdjacentCursor, weight_type>(AdjacentCursor(this, &edges, edges.size()))));
+}
+
+/**
+ * \brief Weight of an edge (1 in an unweighted graph)
+ * \exception logic_error if there's no such edge
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+typename Adjacency_List<T, Direction, Weighting, Allocator>::weight_type Adjacency_List<T, Direction, Weighting, Allocator>::edgeWeight(Vertex_Descriptor p_src, Vertex_Descriptor p_dest) const {
+	return m_nodes[p_src.index()].m_edges[_edgeIndex(p_src.index(), p_dest.index())].weight(); // throws logic error if no such edge
+}
+
+/**
+ * \exception logic_error if the edge already exists
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addEdge(Vertex_Descriptor p_src, Vertex_Descriptor p_dest) {
+	_addEdge(p_src.index(), p_dest.index());
+}
+
+/**
+ * \brief Adds a weighted edge (Weighted policy only)
+ * \exception logic_error if the edge already exists
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addEdge(Vertex_Descriptor p_src, Vertex_Descriptor p_dest, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "addEdge: the graph is unweighted");
+	_addEdge(p_src.index(), p_dest.index(), Slot(p_weight));
+}
+
+/**
+ * \brief Changes the weight of an edge (Weighted policy only)
+ * \exception logic_error if there's no such edge
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::setEdgeWeight(Vertex_Descriptor p_src, Vertex_Descriptor p_dest, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "setEdgeWeight: the graph is unweighted");
+	_setEdgeWeight(p_src.index(), p_dest.index(), p_weight);
+}
+
+/**
+ * \exception logic_error if there's no such edge
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::deleteEdge(Vertex_Descriptor p_src, Vertex_Descriptor p_dest) {
+	_deleteEdge(p_src.index(), p_dest.index());
+}
+
+/**
+ * \brief Lazy range over the edges, in the same order as edges(), without copying them
+ * \return a forward range of std::pair<const T &, const T &> (source, destination),
+ * invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+typename Adjacency_List<T, Direction, Weighting, Allocator>::edge_range Adjacency_List<T, Direction, Weighting, Allocator>::edgeRange() const {
+	return edge_range(Range_Iterator<EdgeCursor>(EdgeCursor(this, 0)),
+			Range_Iterator<EdgeCursor>(EdgeCursor(this, m_nodes.size())));
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addVertex(const T &p_elem) {
 	if (hasVertex(p_elem)) {
 		throw logic_error("This element is already in the graph");
 	}
-	Node newnode(p_elem);
+	_insertVertex(T(p_elem));
+}
 
-	m_nodes.push_back(newnode);
+/**
+ * \brief Adds a vertex, moving its data into the graph
+ * \exception logic_error if the vertex already is in the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addVertex(T &&p_elem) {
+	if (hasVertex(p_elem)) {
+		throw logic_error("This element is already in the graph");
+	}
+	_insertVertex(std::move(p_elem));
+}
+
+/**
+ * \brief Adds a vertex whose data is built from the given arguments.
+ * The data is built once and then moved into its node (the duplicate check needs it before the node exists).
+ * \exception logic_error if the vertex already is in the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+template<typename... Args>
+void Adjacency_List<T, Direction, Weighting, Allocator>::emplaceVertex(Args &&...p_args) {
+	addVertex(T(std::forward<Args>(p_args)...));
+}
+
+/**
+ * \brief Adds a batch of vertices, all or none: the whole batch is checked before the graph is modified.
+ * The storage is reserved once for the batch, and the duplicates are found with one hashed lookup per vertex
+ * (a linear search for the vertex types with no Vertex_Hash, as in addVertex).
+ * \param[in] p_first, p_last the range of the vertex data (input iterators on T)
+ * \exception logic_error if a vertex already is in the graph, or appears twice in the batch
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+template<typename InputIterator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addVertices(InputIterator p_first, InputIterator p_last) {
+	vector<T> batch(p_first, p_last);
+	Vertex_Index<T> inBatch;
+	unsigned idx;
+
+	inBatch.reserve(batch.size());
+	for (unsigned i = 0; i < batch.size(); i++) {
+		bool twice = inBatch.isEnabled() ? inBatch.find(batch[i], idx) :
+				std::find(batch.begin(), batch.begin() + i, batch[i]) != batch.begin() + i;
+
+		if (twice || _find(batch[i], idx)) {
+			throw logic_error("This element is already in the graph");
+		}
+		inBatch.insert(batch[i], i);
+	}
+	m_nodes.reserve(m_nodes.size() + batch.size());
+	m_index.reserve(this->m_nbVertices + batch.size());
+	for (unsigned i = 0; i < batch.size(); i++) {
+		_insertVertex(std::move(batch[i]));
+	}
+}
+
+/**
+ * \brief Adds a batch of edges, all or none: the whole batch is checked before the graph is modified.
+ * The endpoints are resolved in one pass, the duplicates are found by sorting the batch, and the edge set of each
+ * source is reserved once. The edges end up in the same order as with successive calls to addEdge.
+ * \param[in] p_first, p_last the range of the edges (input iterators on std::pair<T, T>, source first)
+ * \exception logic_error if a vertex isn't in the graph, or an edge already exists or appears twice in the batch
+ * (in an undirected graph, (a, b) and (b, a) are the same edge)
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+template<typename InputIterator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addEdges(InputIterator p_first, InputIterator p_last) {
+	vector<pair<unsigned, unsigned> > batch;
+	vector<pair<unsigned, unsigned> > stored; // the edges as stored: both directions of an undirected edge
+	unsigned edge_idx;
+
+	for (; p_first != p_last; ++p_first) {
+		unsigned src_idx = _index((*p_first).first);   // throws logic error if the elem's not in the graph
+		unsigned dest_idx = _index((*p_first).second); // throws logic error if the elem's not in the graph
+
+		batch.push_back(make_pair(src_idx, dest_idx));
+	}
+	stored.reserve(_isUndirected() ? 2 * batch.size() : batch.size());
+	for (unsigned i = 0; i < batch.size(); i++) {
+		stored.push_back(batch[i]);
+		if (_isUndirected() && batch[i].first != batch[i].second) {
+			stored.push_back(make_pair(batch[i].second, batch[i].first));
+		}
+	}
+	std::sort(stored.begin(), stored.end());
+	if (std::adjacent_find(stored.begin(), stored.end()) != stored.end()) {
+		throw logic_error("This edge already exists");
+	}
+	for (unsigned i = 0; i < stored.size(); i++) {
+		if (m_nodes[stored[i].first].m_edges.find(stored[i].second, edge_idx)) {
+			throw logic_error("This edge already exists");
+		}
+	}
+	// the edges of a source are contiguous once sorted
+	for (unsigned i = 0, run; i < stored.size(); i += run) {
+		Edges &edges = m_nodes[stored[i].first].m_edges;
+
+		for (run = 1; i + run < stored.size() && stored[i + run].first == stored[i].first; run++) {}
+		edges.reserve(edges.size() + run);
+	}
+	for (unsigned i = 0; i < batch.size(); i++) {
+		_linkEdge(batch[i].first, batch[i].second);
+	}
+}
+
+/**
+ * \brief Stores a new vertex, in a free slot if there's one
+ * \pre the vertex isn't in the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_insertVertex(T &&p_elem) {
+	if (!m_freeSlots.empty()) { // reuse the slot of a deleted vertex
+		unsigned slot = m_freeSlots.back();
+
+		m_freeSlots.pop_back();
+		// it can only be reused once no edge points to it anymore
+		if (m_nodes[slot].m_staleInEdges > 0) {
+			_purgeStaleEdges();
+		}
+		m_nodes[slot] = Node(std::move(p_elem), m_allocator.get());
+		m_index.insert(m_nodes[slot].m_data, slot);
+		m_fingerprint.addVertex(m_nodes[slot].m_data);
+		m_observers.vertexAdded(slot);
+	} else {
+		m_nodes.emplace_back(std::move(p_elem), m_allocator.get());
+		m_index.insert(m_nodes.back().m_data, m_nodes.size() - 1);
+		m_fingerprint.addVertex(m_nodes.back().m_data);
+		m_observers.vertexAdded(m_nodes.size() - 1);
+	}
 	this->m_nbVertices++;
 }
 
-template<typename T>
-void Adjacency_List<T>::deleteVertex(const T &p_v) {
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::deleteVertex(const T &p_v) {
 	unsigned v_idx = _index(p_v); // throws logic error if the elem's not in the graph
 
+	if (hasConfiguration(DEFERRED_DELETION)) {
+		_tombstone(v_idx);
+		return;
+	}
+	const Edges &ownEdges = m_nodes[v_idx].m_edges;
+	vector<unsigned> newIndexes(m_nodes.size());
+
+	// forget the edges the vertex is the source of (in an undirected graph, that's all the edges of the vertex)
+	m_nbEdges -= ownEdges.size();
+	for (unsigned edge_idx = 0; edge_idx < ownEdges.size(); edge_idx++) {
+		unsigned dest_idx = ownEdges[edge_idx].m_dest;
+
+		m_fingerprint.eraseEdge(p_v, m_nodes[dest_idx].m_data, _isUndirected());
+		if (!_isUndirected()) {
+			m_nodes[dest_idx].m_inDegree--;
+		}
+	}
+	m_fingerprint.eraseVertex(p_v);
 	m_nodes.erase(m_nodes.begin() + v_idx); // erase the node itself
+	m_index.erase(p_v);
+	m_index.shiftAbove(v_idx); // the nodes after it have been shifted by one
+	m_observers.vertexErased(v_idx);
 	// next, erase the edges coming to this vertex in other nodes
 	// and update the referred node indexes for each remaining vertex
+	for (unsigned i = 0; i < newIndexes.size(); i++) {
+		// all the next indexes have been shifted by one
+		newIndexes[i] = (i < v_idx) ? i : i - 1;
+	}
+	newIndexes[v_idx] = Edges::REMOVED;
 	for (unsigned i = 0; i < m_nodes.size(); i++) {
-		// search for the vertex index
-		bool present = false;
-		unsigned erase_idx;
-
-		for (unsigned edge_idx = 0; edge_idx < m_nodes[i].m_edges.size(); edge_idx++) {
-			if (m_nodes[i].m_edges[edge_idx].m_dest == v_idx) {
-				present = true;
-				erase_idx = edge_idx;
-			}
-			else if (m_nodes[i].m_edges[edge_idx].m_dest > v_idx) { // update the vertices indexes
-				m_nodes[i].m_edges[edge_idx].m_dest--; // because all the next indexes have been shifted by one
-			}
-			if (present) {
-				m_nodes[i].m_edges.erase(m_nodes[i].m_edges.begin() + erase_idx); // delete the edge going to the deleted vertex
+		Index_List &inEdges = m_nodes[i].m_inEdges;
+		unsigned dropped = m_nodes[i].m_edges.remap(newIndexes);
+		unsigned kept = 0;
+
+		// drop the edge going to the deleted vertex
+		m_nbEdges -= dropped;
+		m_nodes[i].m_outDegree -= dropped;
+		if (_isUndirected()) {
+			m_nodes[i].m_inDegree -= dropped; // already out of the fingerprint, as an own edge of the vertex
+		} else if (dropped > 0) {
+			m_fingerprint.eraseEdge(m_nodes[i].m_data, p_v, false);
+		}
+
+		for (unsigned pos = 0; pos < inEdges.size(); pos++) {
+			if (inEdges[pos] != v_idx) {
+				inEdges[kept++] = (inEdges[pos] > v_idx) ? inEdges[pos] - 1 : inEdges[pos];
 			}
 		}
+		inEdges.erase(inEdges.begin() + kept, inEdges.end());
 	}
 	this->m_nbVertices--;
 }
 
-template<typename T>
-void Adjacency_List<T>::addEdge(const T &p_src, const T & p_dest) {
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addEdge(const T &p_src, const T & p_dest) {
+	unsigned src_idx = _index(p_src);   // throws logic error if the elem's not in the graph
+	unsigned dest_idx = _index(p_dest); // throws logic error if the elem's not in the graph
+
+	_addEdge(src_idx, dest_idx);
+}
+
+/**
+ * \brief Adds a weighted edge (Weighted policy only)
+ * \exception logic_error if one of the vertices isn't in the graph, or the edge already exists
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::addEdge(const T &p_src, const T & p_dest, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "addEdge: the graph is unweighted");
 	unsigned src_idx = _index(p_src);   // throws logic error if the elem's not in the graph
 	unsigned dest_idx = _index(p_dest); // throws logic error if the elem's not in the graph
 
-	if (hasEdge(p_src, p_dest)) {
+	_addEdge(src_idx, dest_idx, Slot(p_weight));
+}
+
+/**
+ * \brief Weight of an edge (1 in an unweighted graph)
+ * \exception logic_error if one of the vertices isn't in the graph, or there's no such edge
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+typename Adjacency_List<T, Direction, Weighting, Allocator>::weight_type Adjacency_List<T, Direction, Weighting, Allocator>::edgeWeight(const T &p_src, const T & p_dest) const {
+	unsigned src_idx = _index(p_src); // throws logic error if the elem's not in the graph
+	unsigned dest_idx = _index(p_dest); // throws logic error if the elem's not in the graph
+
+	return m_nodes[src_idx].m_edges[_edgeIndex(src_idx, dest_idx)].weight(); // throws logic error if no such edge
+}
+
+/**
+ * \brief Changes the weight of an edge (Weighted policy only)
+ * \exception logic_error if one of the vertices isn't in the graph, or there's no such edge
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::setEdgeWeight(const T &p_src, const T & p_dest, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "setEdgeWeight: the graph is unweighted");
+	unsigned src_idx = _index(p_src); // throws logic error if the elem's not in the graph
+	unsigned dest_idx = _index(p_dest); // throws logic error if the elem's not in the graph
+
+	_setEdgeWeight(src_idx, dest_idx, p_weight);
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::deleteEdge(const T &p_src, const T & p_dest) {
+	unsigned src_idx = _index(p_src); // throws logic error if the elem's not in the graph
+	unsigned dest_idx = _index(p_dest); // throws logic error if the elem's not in the graph
+
+	_deleteEdge(src_idx, dest_idx);
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_addEdge(unsigned p_idx_src, unsigned p_idx_dest, const Slot &p_slot) {
+	unsigned edge_idx;
+
+	if (m_nodes[p_idx_src].m_edges.find(p_idx_dest, edge_idx)) {
 		throw logic_error("This edge already exists");
 	}
-	Edge newedge(dest_idx);
+	// since edges add in pairs in an undirected graph, actually shouldn't happen
+	if (p_idx_src != p_idx_dest && _isUndirected() && m_nodes[p_idx_dest].m_edges.find(p_idx_src, edge_idx)) {
+		throw logic_error("This edge already exists");
+	}
+	_linkEdge(p_idx_src, p_idx_dest, p_slot);
+}
+
+/**
+ * \brief Stores a new edge and updates the counters
+ * \pre the edge isn't in the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_linkEdge(unsigned p_idx_src, unsigned p_idx_dest, const Slot &p_slot) {
+	Edge newedge(p_idx_dest, p_slot);
 
-	m_nodes[src_idx].m_edges.push_back(newedge);
+	m_nodes[p_idx_src].m_edges.insert(newedge);
+	m_nbEdges++;
+	m_nodes[p_idx_src].m_outDegree++;
+	m_nodes[p_idx_dest].m_inDegree++;
+	m_fingerprint.addEdge(m_nodes[p_idx_src].m_data, m_nodes[p_idx_dest].m_data, _isUndirected());
 	// if the graph is undirected : also add an edge in the other way,
 	// except when we do a loop (an edge from a vertex to the same vertex).
-	if (src_idx != dest_idx && hasConfiguration(UNDIRECTED)) {
-		if (hasEdge(p_dest, p_src)) {
-			throw logic_error("This edge already exists"); // since edges add in pairs in an undirected graph, actually shouldn't happen
+	if (p_idx_src != p_idx_dest && _isUndirected()) {
+		Edge newedge(p_idx_src, p_slot);
+
+		m_nodes[p_idx_dest].m_edges.insert(newedge);
+		m_nbEdges++;
+	}
+	// in an undirected graph, an edge adds one to the in and out-degree of both ends (so a loop counts twice)
+	if (_isUndirected()) {
+		m_nodes[p_idx_dest].m_outDegree++;
+		m_nodes[p_idx_src].m_inDegree++;
+	}
+	if (_hasReverseIndex()) {
+		m_nodes[p_idx_dest].m_inEdges.push_back(p_idx_src);
+	}
+}
+
+/**
+ * \brief Sets the weight of an edge, and of its other direction in an undirected graph
+ * \exception logic_error if there's no such edge
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_setEdgeWeight(unsigned p_idx_src, unsigned p_idx_dest, const weight_type &p_weight) {
+	Edges &edges = m_nodes[p_idx_src].m_edges;
+
+	edges[_edgeIndex(p_idx_src, p_idx_dest)].setWeight(p_weight); // throws logic error if no such edge
+	if (p_idx_src != p_idx_dest && _isUndirected()) {
+		m_nodes[p_idx_dest].m_edges[_edgeIndex(p_idx_dest, p_idx_src)].setWeight(p_weight);
+	}
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_deleteEdge(unsigned p_idx_src, unsigned p_idx_dest) {
+	unsigned edge_idx = _edgeIndex(p_idx_src, p_idx_dest); // throws logic error if no such edge
+
+	m_nodes[p_idx_src].m_edges.eraseAt(edge_idx);
+	m_nbEdges--;
+	m_nodes[p_idx_src].m_outDegree--;
+	m_nodes[p_idx_dest].m_inDegree--;
+	m_fingerprint.eraseEdge(m_nodes[p_idx_src].m_data, m_nodes[p_idx_dest].m_data, _isUndirected());
+	// a loop is only stored once, even in an undirected graph
+	if (p_idx_src != p_idx_dest && _isUndirected()) {
+		unsigned edge_idx = _edgeIndex(p_idx_dest, p_idx_src); // throws logic error if no such edge
+
+		m_nodes[p_idx_dest].m_edges.eraseAt(edge_idx);
+		m_nbEdges--;
+	}
+	if (_isUndirected()) {
+		m_nodes[p_idx_dest].m_outDegree--;
+		m_nodes[p_idx_src].m_inDegree--;
+	}
+	if (_hasReverseIndex()) {
+		Index_List &inEdges = m_nodes[p_idx_dest].m_inEdges;
+
+		inEdges.erase(std::find(inEdges.begin(), inEdges.end(), p_idx_src));
+	}
+}
+
+/**
+ * \brief Renumbers the vertices to remove the tombstones left by deferred deletions, in one O(V+E) pass.
+ * The edges still going to deleted vertices are dropped at the same time.
+ * \post The vertex indexes are contiguous again and no slot is free
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::compact() {
+	const unsigned deleted = Edges::REMOVED;
+	vector<unsigned> newIndexes(m_nodes.size());
+	unsigned next = 0;
+
+	for (unsigned i = 0; i < m_nodes.size(); i++) {
+		newIndexes[i] = m_nodes[i].m_deleted ? deleted : next++;
+	}
+	if (next == m_nodes.size()) {
+		return;
+	}
+	for (unsigned i = 0; i < m_nodes.size(); i++) {
+		if (newIndexes[i] == deleted) {
+			continue;
 		}
-		Edge newedge(src_idx);
+		Index_List &inEdges = m_nodes[i].m_inEdges;
 
-		m_nodes[dest_idx].m_edges.push_back(newedge);
+		m_nodes[i].m_outDegree -= m_nodes[i].m_edges.remap(newIndexes);
+		for (unsigned pos = 0; pos < inEdges.size(); pos++) {
+			inEdges[pos] = newIndexes[inEdges[pos]];
+		}
+		if (newIndexes[i] != i) {
+			m_nodes[newIndexes[i]] = std::move(m_nodes[i]);
+		}
+	}
+	m_nodes.erase(m_nodes.begin() + next, m_nodes.end());
+	m_freeSlots.clear();
+	m_nbStaleEdges = 0;
+	m_index.clear();
+	m_index.reserve(next);
+	for (unsigned i = 0; i < next; i++) {
+		m_index.insert(m_nodes[i].m_data, i);
 	}
+	m_observers.verticesRenumbered(newIndexes, next);
 }
 
-template<typename T>
-void Adjacency_List<T>::deleteEdge(const T &p_src, const T & p_dest) {
-	unsigned src_idx = _index(p_src); // throws logic error if the elem's not in the graph
-	unsigned dest_idx = _index(p_dest); // throws logic error if the elem's not in the graph
-	unsigned edge_idx = _edgeIndex(src_idx, dest_idx); // throws logic error if no such edge
+/**
+ * \brief Removes all the vertices and edges, and frees their memory in one go (the whole arena with Arena_Allocator)
+ * \post The graph is empty and keeps its configuration
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::clear() {
+	vector<Node>().swap(m_nodes);
+	m_allocator.reset(); // no container uses the allocator anymore
+	m_index.clear();
+	vector<unsigned>().swap(m_freeSlots);
+	m_nbEdges = 0;
+	m_nbStaleEdges = 0;
+	this->m_nbVertices = 0;
+	m_fingerprint.reset();
+	m_observers.verticesReset(0);
+}
 
-	m_nodes[src_idx].m_edges.erase(m_nodes[src_idx].m_edges.begin() + edge_idx);
-	if (hasConfiguration(UNDIRECTED)) {
-		unsigned edge_idx = _edgeIndex(dest_idx, src_idx); // throws logic error if no such edge
+/**
+ * \brief Structural equality (same vertices, same edges), the weights aren't compared.
+ * O(1) when the counters or the fingerprints differ; otherwise each vertex is looked up once in the other graph and
+ * the edges are compared by index, in O(V+E) (with a Vertex_Hash).
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+bool Adjacency_List<T, Direction, Weighting, Allocator>::operator==(const Adjacency_List &p_rhs) const {
+	if (_isUndirected() != p_rhs._isUndirected() || this->m_nbVertices != p_rhs.m_nbVertices
+			|| m_nbEdges != p_rhs.m_nbEdges || fingerprint() != p_rhs.fingerprint()) {
+		return false;
+	}
+	vector<unsigned> rhsIndexes(m_nodes.size());
 
-		m_nodes[dest_idx].m_edges.erase(m_nodes[dest_idx].m_edges.begin() + edge_idx);
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		if (!m_nodes[v].m_deleted && !p_rhs._find(m_nodes[v].m_data, rhsIndexes[v])) {
+			return false;
+		}
+	}
+	// as many edges on both sides: the inclusion is enough
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		if (m_nodes[v].m_deleted) {
+			continue;
+		}
+		const Edges &edges = m_nodes[v].m_edges;
+		const Edges &rhsEdges = p_rhs.m_nodes[rhsIndexes[v]].m_edges;
+		unsigned edge_idx;
+
+		for (unsigned pos = 0; pos < edges.size(); pos++) {
+			if (!_isStale(edges[pos]) && !rhsEdges.find(rhsIndexes[edges[pos].m_dest], edge_idx)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Writes the topology of the graph to a graph file (see GraphFile.h), for Mapped_Graph to map it.
+ * The vertices are numbered in the order of the list, without the tombstones, and each adjacency list is sorted by
+ * index. The file is written sequentially, with no copy of the graph. The weights aren't saved.
+ * \param[in] p_path the path of the file, replaced at once if it exists (a failed save leaves it as it was)
+ * \exception runtime_error if the file can't be written
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::save(const std::string &p_path) const {
+	static_assert(std::is_trivially_copyable<T>::value, "save: the vertex type must be trivially copyable");
+	const unsigned deleted = Edges::REMOVED;
+	vector<unsigned> newIndexes(m_nodes.size());
+	vector<unsigned> inDegrees(this->m_nbVertices, 0);
+	vector<unsigned> row;
+	unsigned next = 0;
+	unsigned nbLoops = 0;
+	unsigned nbArcs = 0;
+	Graph_File_Writer file(p_path, this->m_config, sizeof(T), this->m_nbVertices);
+
+	file.beginSection(Graph_File_Header::VERTICES);
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		newIndexes[v] = m_nodes[v].m_deleted ? deleted : next++;
+		if (!m_nodes[v].m_deleted) {
+			file.write(m_nodes[v].m_data);
+		}
+	}
+	// the edges still going to tombstones are left out
+	file.beginSection(Graph_File_Header::OFFSETS);
+	file.write(nbArcs);
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		const Edges &edges = m_nodes[v].m_edges;
+
+		if (newIndexes[v] == deleted) {
+			continue;
+		}
+		for (unsigned pos = 0; pos < edges.size(); pos++) {
+			nbArcs += !_isStale(edges[pos]);
+		}
+		file.write(nbArcs);
+	}
+	file.beginSection(Graph_File_Header::NEIGHBORS);
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		const Edges &edges = m_nodes[v].m_edges;
+
+		if (newIndexes[v] == deleted) {
+			continue;
+		}
+		row.clear();
+		for (unsigned pos = 0; pos < edges.size(); pos++) {
+			if (!_isStale(edges[pos])) {
+				row.push_back(newIndexes[edges[pos].m_dest]);
+			}
+		}
+		std::sort(row.begin(), row.end());
+		for (unsigned pos = 0; pos < row.size(); pos++) {
+			inDegrees[row[pos]]++;
+			nbLoops += (row[pos] == newIndexes[v]);
+		}
+		file.write(row.data(), row.size());
+	}
+	file.beginSection(Graph_File_Header::IN_DEGREES);
+	file.write(inDegrees.data(), inDegrees.size());
+	// an undirected list stores both directions of each edge, but a loop once
+	file.finish(_isUndirected() ? (nbArcs + nbLoops) / 2 : nbArcs, nbArcs, 0, fingerprint());
+}
+
+/**
+ * \brief Deferred deletion of a vertex: the node stays in place as a tombstone and its slot goes to the free list.
+ * Its own edges are removed right away, and so are the edges coming to it when they are indexed (undirected graph
+ * or REVERSE_ADJACENCY). Otherwise they are only counted as stale, skipped by the queries, and removed lazily.
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_tombstone(unsigned p_idx) {
+	Node &node = m_nodes[p_idx];
+	unsigned loop = 0;
+	unsigned nbStale = 0;
+
+	for (unsigned edge_idx = 0; edge_idx < node.m_edges.size(); edge_idx++) {
+		unsigned dest_idx = node.m_edges[edge_idx].m_dest;
+		Node &dest = m_nodes[dest_idx];
+
+		if (_isStale(node.m_edges[edge_idx])) {
+			// already taken off the counters and the fingerprint when its destination was tombstoned
+			dest.m_staleInEdges--;
+			m_nbStaleEdges--;
+			nbStale++;
+			continue;
+		}
+		m_fingerprint.eraseEdge(node.m_data, dest.m_data, _isUndirected());
+		if (dest_idx == p_idx) {
+			loop = 1;
+		} else if (_isUndirected()) { // remove the other direction of the edge
+			dest.m_edges.erase(p_idx);
+			dest.m_outDegree--;
+			dest.m_inDegree--;
+			m_nbEdges--;
+		} else {
+			dest.m_inDegree--;
+			if (_hasReverseIndex()) {
+				dest.m_inEdges.erase(std::find(dest.m_inEdges.begin(), dest.m_inEdges.end(), p_idx));
+			}
+		}
+	}
+	m_nbEdges -= node.m_edges.size() - nbStale;
+	node.m_edges.clear();
+	if (!_isUndirected()) {
+		if (_hasReverseIndex()) {
+			for (unsigned pos = 0; pos < node.m_inEdges.size(); pos++) {
+				unsigned src_idx = node.m_inEdges[pos];
+				Node &src = m_nodes[src_idx];
+
+				if (src_idx != p_idx) {
+					src.m_edges.erase(p_idx);
+					src.m_outDegree--;
+					m_nbEdges--;
+					m_fingerprint.eraseEdge(src.m_data, node.m_data, false);
+				}
+			}
+		} else {
+			node.m_staleInEdges = node.m_inDegree - loop;
+			m_nbStaleEdges += node.m_staleInEdges;
+			m_nbEdges -= node.m_staleInEdges;
+			// the sources of the stale edges are unknown until they are walked
+			if (node.m_staleInEdges > 0) {
+				m_fingerprint.invalidate();
+			}
+		}
+	}
+	m_fingerprint.eraseVertex(node.m_data);
+	node.m_inEdges.clear();
+	node.m_outDegree = 0;
+	node.m_inDegree = 0;
+	node.m_deleted = true;
+	m_index.erase(node.m_data);
+	m_freeSlots.push_back(p_idx);
+	this->m_nbVertices--;
+}
+
+/**
+ * \brief Sets the degrees, the reverse index and the number of edges from the edge sets alone, in O(V+E).
+ * The fingerprint is left to be computed on demand.
+ * \pre there's no tombstone, and the degrees, reverse index and counter are still empty
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_countEdges() {
+	m_fingerprint.invalidate();
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		const Edges &edges = m_nodes[v].m_edges;
+
+		m_nbEdges += edges.size();
+		m_nodes[v].m_outDegree += edges.size();
+		for (unsigned edge_idx = 0; edge_idx < edges.size(); edge_idx++) {
+			unsigned dest = edges[edge_idx].m_dest;
+
+			if (_isUndirected()) { // a loop counts twice in the degrees
+				m_nodes[v].m_outDegree += (dest == v);
+				continue;
+			}
+			m_nodes[dest].m_inDegree++;
+			if (_hasReverseIndex()) {
+				m_nodes[dest].m_inEdges.push_back(v);
+			}
+		}
+		if (_isUndirected()) {
+			m_nodes[v].m_inDegree = m_nodes[v].m_outDegree;
+		}
+	}
+}
+
+/**
+ * \brief Computes the fingerprint again from all the vertices and edges, in O(V+E).
+ * An undirected edge is stored both ways, it's only taken from its end of lower index.
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_computeFingerprint() const {
+	m_fingerprint.reset();
+	for (unsigned v = 0; v < m_nodes.size(); v++) {
+		const Node &node = m_nodes[v];
+
+		if (node.m_deleted) {
+			continue;
+		}
+		m_fingerprint.addVertex(node.m_data);
+		for (unsigned edge_idx = 0; edge_idx < node.m_edges.size(); edge_idx++) {
+			unsigned dest_idx = node.m_edges[edge_idx].m_dest;
+
+			if (!_isStale(node.m_edges[edge_idx]) && (!_isUndirected() || v <= dest_idx)) {
+				m_fingerprint.addEdge(node.m_data, m_nodes[dest_idx].m_data, _isUndirected());
+			}
+		}
 	}
 }
 
-template<typename T>
-unsigned Adjacency_List<T>::_index(const T &p_v) const {
+/**
+ * \brief Removes all the edges still going to tombstones, in one O(V+E) pass.
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+void Adjacency_List<T, Direction, Weighting, Allocator>::_purgeStaleEdges() {
+	vector<unsigned> newIndexes(m_nodes.size());
+
+	// same numbering, minus the tombstones
+	for (unsigned i = 0; i < m_nodes.size(); i++) {
+		newIndexes[i] = m_nodes[i].m_deleted ? Edges::REMOVED : i;
+	}
 	for (unsigned i = 0; i < m_nodes.size(); i++) {
-		if (m_nodes[i].m_data == p_v) {
-			return i;
+		m_nodes[i].m_outDegree -= m_nodes[i].m_edges.remap(newIndexes);
+		m_nodes[i].m_staleInEdges = 0;
+	}
+	m_nbStaleEdges = 0;
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+unsigned Adjacency_List<T, Direction, Weighting, Allocator>::_outDegree(unsigned p_idx) const {
+	unsigned outDeg = m_nodes[p_idx].m_outDegree;
+
+	// the counter still includes the edges going to tombstones that haven't been removed yet
+	if (m_nbStaleEdges > 0) {
+		const Edges &edges = m_nodes[p_idx].m_edges;
+
+		for (unsigned edge_idx = 0; edge_idx < edges.size(); edge_idx++) {
+			outDeg -= m_nodes[edges[edge_idx].m_dest].m_deleted;
 		}
 	}
-	throw logic_error("This element is not in the graph");
+	return outDeg;
 }
 
-template<typename T>
-unsigned Adjacency_List<T>::_edgeIndex(unsigned p_idx_src, unsigned p_idx_dest) const {
-	for (unsigned edge_idx = 0; edge_idx < m_nodes[p_idx_src].m_edges.size(); edge_idx++) {
-		if (m_nodes[p_idx_src].m_edges[edge_idx].m_dest == p_idx_dest) {
-			return edge_idx;
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+unsigned Adjacency_List<T, Direction, Weighting, Allocator>::_index(const T &p_v) const {
+	unsigned idx;
+
+	if (!_find(p_v, idx)) {
+		throw logic_error("This element is not in the graph");
+	}
+	return idx;
+}
+
+/**
+ * \brief Looks up the index of a vertex, without throwing
+ * \return false if the vertex isn't in the graph
+ */
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+bool Adjacency_List<T, Direction, Weighting, Allocator>::_find(const T &p_v, unsigned &p_idx) const {
+	if (m_index.isEnabled()) {
+		return m_index.find(p_v, p_idx);
+	}
+	// no hasher for this vertex type: linear search
+	for (unsigned i = 0; i < m_nodes.size(); i++) {
+		if (!m_nodes[i].m_deleted && m_nodes[i].m_data == p_v) {
+			p_idx = i;
+			return true;
 		}
 	}
+	return false;
+}
+
+template<typename T, typename Direction, typename Weighting, typename Allocator>
+unsigned Adjacency_List<T, Direction, Weighting, Allocator>::_edgeIndex(unsigned p_idx_src, unsigned p_idx_dest) const {
+	unsigned edge_idx;
+
+	if (m_nodes[p_idx_src].m_edges.find(p_idx_dest, edge_idx)) {
+		return edge_idx;
+	}
 	throw logic_error("No such edge in the graph");
 }
 
@@ -14,27 +14,64 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 
 #include "AbstractGraph.h"
+#include "BitOperations.h"
+#include "VertexIndex.h"
+#include "Fingerprint.h"
+#include "GraphFile.h"
+#include "Range.h"
+#include "Policies.h"
+#include "PropertyMap.h"
 #include "components.h"
 
 namespace SGL {
+
+template<typename, typename, typename, typename> class Adjacency_List;
+template<typename> class Compressed_Sparse_Row;
+
 /**
  * \class Adjacency_Matrix
  *
  * \brief Class representing an adjacency matrix
  * for internal use by a graph
+ * The Direction policy (Directed, Undirected or the default Runtime_Direction, see Policies.h) picks the matrix
+ * storage: with a fixed direction it is chosen at compile time and called without any virtual dispatch,
+ * with the default it depends on the UNDIRECTED configuration flag and goes through the IMatrix interface.
+ * With the Weighted<W> policy, the weights of the edges are kept next to the bit matrix in a hash map keyed by cell;
+ * the default, Unweighted, stores none (every edge weighs 1).
+ * Copies duplicate the storage as it is, and conversions from an Adjacency_List or a Compressed_Sparse_Row (include
+ * their headers) set the bits straight from their indexes: none of them looks up a vertex per edge.
+ * save() writes its topology and its bit matrix to a binary file, which Mapped_Graph (MappedGraph.h) serves without
+ * loading it.
  */
-template <typename T>
+template<typename T, typename Direction = Runtime_Direction, typename Weighting = Unweighted>
 class Adjacency_Matrix : public AbstractGraph<T> {
+	class AdjacentCursor;
+	class EdgeCursor;
+
 public:
+	typedef typename Weighting::weight_type weight_type; /*!< the type of the edge weights */
+	typedef Range<typename std::vector<T>::const_iterator> vertex_range; /*!< lazy range of const T & */
+	typedef Range<Range_Iterator<Value_Cursor<T, Adjacency_Matrix, AdjacentCursor> > > neighbor_range; /*!< lazy range of const T & */
+	typedef Range<Range_Iterator<AdjacentCursor> > adjacent_range; /*!< lazy range of Vertex_Descriptor */
+	typedef Range<Range_Iterator<EdgeCursor> > edge_range; /*!< lazy range of std::pair<const T &, const T &> */
+	typedef Range<Range_Iterator<Weighted_Cursor<AdjacentCursor, weight_type> > > weighted_range; /*!< lazy range of std::pair<Vertex_Descriptor, weight_type> */
 	////////////////////////////////////////////////////////////////
 	// Coplien Form
 	////////////////////////////////////////////////////////////////
 	Adjacency_Matrix(configuration p_f = 0);
 	Adjacency_Matrix(const Adjacency_Matrix &);
-	~Adjacency_Matrix() { delete m_matrix; }
+	Adjacency_Matrix(Adjacency_Matrix &&) noexcept;
+	template<typename SrcDirection, typename SrcWeighting, typename SrcAllocator>
+	explicit Adjacency_Matrix(const Adjacency_List<T, SrcDirection, SrcWeighting, SrcAllocator> &);
+	explicit Adjacency_Matrix(const Compressed_Sparse_Row<T> &);
+	~Adjacency_Matrix() { if (!_hasEmptyMatrix()) delete m_matrix; }
 	Adjacency_Matrix &operator=(const Adjacency_Matrix &);
+	Adjacency_Matrix &operator=(Adjacency_Matrix &&) noexcept;
 
 	////////////////////////////////////////////////////////////////
 	// Getters (const)
@@ -87,83 +124,367 @@ public:
 	std::vector<T> vertexNeighborhood(const T&, bool p_closed = false) const;
 	std::vector<T> vertices() const;
 	bool hasEdge(const T &, const T &) const;
+	weight_type edgeWeight(const T &, const T &) const;
 	std::vector<std::pair<T, T> > edges() const;
+	vertex_range vertexRange() const;
+	neighbor_range neighborRange(const T &) const;
+	edge_range edgeRange() const;
+	uint64_t fingerprint() const;
+
+	////////////////////////////////////////////////////////////////
+	// Vertex descriptors: no vertex lookup
+	////////////////////////////////////////////////////////////////
+	Vertex_Descriptor descriptor(const T &) const;
 
+	/**
+	 * \brief Returns the data of a vertex from its descriptor
+	 * \pre p_vd is a valid descriptor of this graph
+	 */
+	inline const T &value(Vertex_Descriptor p_vd) const { return m_elems[p_vd.index()]; }
+
+	/**
+	 * \brief Upper bound of the indexes of the descriptors, to size per-vertex arrays
+	 */
+	inline unsigned indexBound() const { return m_elems.size(); }
+
+	/**
+	 * \brief The observers following the vertex indexes, such as the Vertex_Property attached to the graph
+	 */
+	inline Observer_List &observers() const { return m_observers; }
+
+	bool hasEdge(Vertex_Descriptor, Vertex_Descriptor) const;
+	unsigned inDegree(Vertex_Descriptor) const;
+	unsigned outDegree(Vertex_Descriptor) const;
+	adjacent_range neighbors(Vertex_Descriptor) const;
+	weighted_range weightedNeighbors(Vertex_Descriptor) const;
+	weight_type edgeWeight(Vertex_Descriptor, Vertex_Descriptor) const;
+	void addEdge(Vertex_Descriptor, Vertex_Descriptor);
+	void addEdge(Vertex_Descriptor, Vertex_Descriptor, const weight_type &);
+	void setEdgeWeight(Vertex_Descriptor, Vertex_Descriptor, const weight_type &);
+	void deleteEdge(Vertex_Descriptor, Vertex_Descriptor);
 
 	////////////////////////////////////////////////////////////////
 	// Setters (mutators)
 	////////////////////////////////////////////////////////////////
 	void addVertex(const T &);
+	void addVertex(T &&);
+	template<typename... Args> void emplaceVertex(Args &&...);
+	void reserveVertices(unsigned);
 	void deleteVertex(const T &);
 	void addEdge(const T&, const T&);
+	void addEdge(const T&, const T&, const weight_type &);
+	void setEdgeWeight(const T&, const T&, const weight_type &);
 	void deleteEdge(const T&, const T&);
+	template<typename InputIterator> void addVertices(InputIterator, InputIterator);
+	template<typename InputIterator> void addEdges(InputIterator, InputIterator);
 
 	////////////////////////////////////////////////////////////////
 	// Others
 	////////////////////////////////////////////////////////////////
 	bool operator==(const Adjacency_Matrix &p_rhs) const;
+	void save(const std::string &p_path) const;
+
 
 	friend inline std::ostream &operator<<(std::ostream &p_stream, const Adjacency_Matrix &p_matrix) { p_stream << p_matrix._repr(); return p_stream; }
 
+	template<typename> friend class Compressed_Sparse_Row;
+	template<typename> friend class Graph_Builder;
+	template<typename, typename, typename, typename> friend class Adjacency_List;
 
 private:
+	/**
+	 * \class IMatrix
+	 * \brief Virtual interface of the two storages, only used when the direction is chosen at runtime
+	 */
 	class IMatrix {
 	public:
 		virtual ~IMatrix() {}
 
+		virtual IMatrix *clone() const = 0;
 		virtual bool hasEdge(unsigned, unsigned) const = 0;
 		virtual unsigned nbEdges() const = 0;
-		virtual void edges(std::vector<std::vector<int> > &) const = 0;
+		virtual unsigned outDegree(unsigned) const = 0;
+		virtual unsigned inDegree(unsigned) const = 0;
+		virtual unsigned nextNeighbor(unsigned, unsigned) const = 0;
+		virtual unsigned nextEdge(unsigned, unsigned) const = 0;
 
 		virtual void addVertex() = 0;
+		virtual void reserveVertices(unsigned) = 0;
 		virtual void deleteVertex(unsigned) = 0;
 		virtual void addEdge(unsigned, unsigned) = 0;
 		virtual void deleteEdge(unsigned, unsigned) = 0;
 	};
 
-	class DirectedMatrix : public IMatrix {
+	/**
+	 * \class DirectedMatrix
+	 * \brief Bit-packed square matrix: one bit per cell, rows of 64-bit words stored one after the other
+	 * in a single buffer.
+	 * Every row starts on a word boundary, and the bits past the last vertex are always 0,
+	 * so whole rows or the whole matrix can be counted with popcount.
+	 * The row stride (m_rowWords) doubles when the columns run out, so adding vertices is amortized O(1).
+	 */
+	class DirectedMatrix {
 	public:
-		DirectedMatrix() {}
+		DirectedMatrix() : m_nbVertices(0), m_rowWords(0) {}
 		~DirectedMatrix() {}
 
 		bool hasEdge(unsigned, unsigned) const;
 		unsigned nbEdges() const;
-		void edges(std::vector<std::vector<int> > &) const;
+		unsigned outDegree(unsigned) const;
+		unsigned inDegree(unsigned) const;
+		unsigned nextNeighbor(unsigned, unsigned) const;
+		unsigned nextEdge(unsigned p_idx, unsigned p_from) const { return nextNeighbor(p_idx, p_from); }
 
 		void addVertex();
+		void reserveVertices(unsigned);
 		void deleteVertex(unsigned);
 		void addEdge(unsigned, unsigned);
 		void deleteEdge(unsigned, unsigned);
 
 	private:
-		std::vector<std::vector<int> > m_matrix;
+		uint64_t *_row(unsigned p_row) { return m_matrix.data() + static_cast<std::size_t>(p_row) * m_rowWords; }
+		const uint64_t *_row(unsigned p_row) const { return m_matrix.data() + static_cast<std::size_t>(p_row) * m_rowWords; }
+		void _resizeRows(unsigned);
+
+		unsigned m_nbVertices; /*!< number of rows (and used columns) */
+		unsigned m_rowWords; /*!< number of 64-bit words in a row */
+		std::vector<uint64_t> m_matrix; /*!< row i is stored in the words [i * m_rowWords, (i + 1) * m_rowWords) */
 	};
 
-	class UndirectedMatrix : public IMatrix {
+	/**
+	 * \class UndirectedMatrix
+	 * \brief Bit-packed lower triangle of a symmetric matrix.
+	 * The cell (i, j) with j <= i is the bit i * (i + 1) / 2 + j, so the row i is a run of i + 1 contiguous bits
+	 * and the rest of the column i is found one bit per following row.
+	 */
+	class UndirectedMatrix {
 	public:
-		UndirectedMatrix() {}
+		UndirectedMatrix() : m_nbVertices(0) {}
 		~UndirectedMatrix() {}
 
 		bool hasEdge(unsigned, unsigned) const;
 		unsigned nbEdges() const;
-		void edges(std::vector<std::vector<int> > &) const;
+		unsigned outDegree(unsigned) const;
+		unsigned inDegree(unsigned) const;
+		unsigned nextNeighbor(unsigned, unsigned) const;
+		unsigned nextEdge(unsigned, unsigned) const;
 
 		void addVertex();
+		void reserveVertices(unsigned);
 		void deleteVertex(unsigned);
 		void addEdge(unsigned, unsigned);
 		void deleteEdge(unsigned, unsigned);
 
 	private:
-		unsigned _calcActualIndex(unsigned, unsigned) const;
-		unsigned _nbVertices() const;
+		/**
+		 * \brief Position of the first bit of a row (the cell (p_row, 0))
+		 */
+		static std::size_t _rowStart(unsigned p_row) { return static_cast<std::size_t>(p_row) * (p_row + 1) / 2; }
+		std::size_t _calcActualIndex(unsigned, unsigned) const;
+		unsigned _nextInRow(unsigned, unsigned) const;
+
+		unsigned m_nbVertices; /*!< number of vertices, stored rather than derived from the triangle size */
+		std::vector<uint64_t> m_matrix; /*!< the triangle bits, row after row */
+	};
+
+	/**
+	 * \class AdjacentCursor
+	 * \brief Jumps from a neighbor to the next one with IMatrix::nextNeighbor, which skips the empty words
+	 */
+	class AdjacentCursor {
+	public:
+		typedef Vertex_Descriptor value_type;
+		typedef Vertex_Descriptor reference;
+
+		AdjacentCursor() : m_graph(NULL), m_idx(0), m_dest(0) {}
+		AdjacentCursor(const Adjacency_Matrix *p_graph, unsigned p_idx, unsigned p_dest) :
+				m_graph(p_graph), m_idx(p_idx), m_dest(p_dest) {}
+
+		reference get() const { return Vertex_Descriptor(m_dest); }
+		weight_type weight() const { return m_graph->_weight(m_idx, m_dest); }
+		void next() { m_dest = m_graph->m_matrix->nextNeighbor(m_idx, m_dest + 1); }
+		bool operator==(const AdjacentCursor &p_rhs) const { return m_dest == p_rhs.m_dest; }
+
+	private:
+		const Adjacency_Matrix *m_graph;
+		unsigned m_idx;
+		unsigned m_dest; /*!< current neighbor, or the number of vertices at the end */
+	};
+
+	/**
+	 * \class EdgeCursor
+	 * \brief Walks the cells set row after row with IMatrix::nextEdge
+	 */
+	class EdgeCursor {
+	public:
+		typedef std::pair<T, T> value_type;
+		typedef std::pair<const T &, const T &> reference;
+
+		EdgeCursor() : m_graph(NULL), m_src(0), m_dest(0) {}
+		EdgeCursor(const Adjacency_Matrix *p_graph, unsigned p_src) : m_graph(p_graph), m_src(p_src), m_dest(0) { _seek(0); }
+
+		reference get() const { return reference(m_graph->m_elems[m_src], m_graph->m_elems[m_dest]); }
+		void next() { _seek(m_dest + 1); }
+		bool operator==(const EdgeCursor &p_rhs) const { return m_src == p_rhs.m_src && m_dest == p_rhs.m_dest; }
+
+	private:
+		void _seek(unsigned p_from) {
+			unsigned nbVertices = m_graph->m_elems.size();
+
+			for (; m_src < nbVertices; m_src++, p_from = 0) {
+				m_dest = m_graph->m_matrix->nextEdge(m_src, p_from);
+				if (m_dest < nbVertices) {
+					return;
+				}
+			}
+			m_dest = 0;
+		}
+
+		const Adjacency_Matrix *m_graph;
+		unsigned m_src;
+		unsigned m_dest;
+	};
+
+	/**
+	 * \class MatrixAdapter
+	 * \brief Exposes a storage through the IMatrix interface
+	 */
+	template<typename Matrix>
+	class MatrixAdapter : public IMatrix {
+	public:
+		IMatrix *clone() const { return new MatrixAdapter(*this); }
+		bool hasEdge(unsigned p_v1, unsigned p_v2) const { return m_storage.hasEdge(p_v1, p_v2); }
+		unsigned nbEdges() const { return m_storage.nbEdges(); }
+		unsigned outDegree(unsigned p_v) const { return m_storage.outDegree(p_v); }
+		unsigned inDegree(unsigned p_v) const { return m_storage.inDegree(p_v); }
+		unsigned nextNeighbor(unsigned p_v, unsigned p_from) const { return m_storage.nextNeighbor(p_v, p_from); }
+		unsigned nextEdge(unsigned p_v, unsigned p_from) const { return m_storage.nextEdge(p_v, p_from); }
+
+		void addVertex() { m_storage.addVertex(); }
+		void reserveVertices(unsigned p_nb) { m_storage.reserveVertices(p_nb); }
+		void deleteVertex(unsigned p_v) { m_storage.deleteVertex(p_v); }
+		void addEdge(unsigned p_v1, unsigned p_v2) { m_storage.addEdge(p_v1, p_v2); }
+		void deleteEdge(unsigned p_v1, unsigned p_v2) { m_storage.deleteEdge(p_v1, p_v2); }
 
-		std::vector<int> m_matrix;
+	private:
+		Matrix m_storage;
 	};
 
+	/**
+	 * \class NoWeights
+	 * \brief Weights of an unweighted matrix: nothing is stored, every edge weighs 1
+	 */
+	class NoWeights {
+	public:
+		weight_type get(uint64_t) const { return 1; }
+		void set(uint64_t, const weight_type &) {}
+		void erase(uint64_t) {}
+		void deleteVertex(unsigned) {}
+	};
+
+	/**
+	 * \class WeightMap
+	 * \brief Weights of a weighted matrix, keyed by cell (see _cell). The edges added without a weight have no entry
+	 * and weigh weight_type().
+	 */
+	class WeightMap {
+	public:
+		weight_type get(uint64_t p_cell) const {
+			typename std::unordered_map<uint64_t, weight_type>::const_iterator it = m_weights.find(p_cell);
+
+			return (it == m_weights.end()) ? weight_type() : it->second;
+		}
+		void set(uint64_t p_cell, const weight_type &p_weight) { m_weights[p_cell] = p_weight; }
+		void erase(uint64_t p_cell) { m_weights.erase(p_cell); }
+		void deleteVertex(unsigned);
+
+	private:
+		std::unordered_map<uint64_t, weight_type> m_weights;
+	};
+
+	/**
+	 * \brief The type of m_weights, chosen by the Weighting policy
+	 */
+	typedef typename std::conditional<Weighting::isWeighted, WeightMap, NoWeights>::type Weights;
+
+	/**
+	 * \brief The type of m_matrix: the storage itself for a fixed direction, the virtual interface otherwise
+	 */
+	typedef typename std::conditional<!Direction::isFixed, IMatrix,
+			typename std::conditional<Direction::undirected, UndirectedMatrix, DirectedMatrix>::type>::type Storage;
+
 	std::vector<T> m_elems; /*!< all the vertices */
-	IMatrix *m_matrix; /*!< the adjacency matrix itself */
+	Vertex_Index<T> m_index; /*!< vertex data -> index in m_elems */
+	Storage *m_matrix; /*!< the adjacency matrix itself, or the shared empty one of its type (moved-from graph) */
+	Weights m_weights; /*!< the weights of the edges (nothing if unweighted) */
+	mutable Observer_List m_observers; /*!< told about every change of the vertex indexes */
+	mutable Graph_Fingerprint<T> m_fingerprint; /*!< kept up to date by the mutators, or computed again when invalidated */
+
+	bool _isUndirected() const { return Direction::isUndirected(this->m_config); }
+	void _swap(Adjacency_Matrix &);
+	void _insertVertex(T &&);
+	void _setEdge(unsigned, unsigned);
+	void _clearEdge(unsigned, unsigned);
+	void _computeFingerprint() const;
+
+	static DirectedMatrix *_newMatrix(configuration, DirectedMatrix *) { return new DirectedMatrix(); }
+	static UndirectedMatrix *_newMatrix(configuration, UndirectedMatrix *) { return new UndirectedMatrix(); }
+	static IMatrix *_newMatrix(configuration p_f, IMatrix *) {
+		if (p_f & UNDIRECTED) {
+			return new MatrixAdapter<UndirectedMatrix>();
+		}
+		return new MatrixAdapter<DirectedMatrix>();
+	}
+	static DirectedMatrix *_cloneMatrix(const DirectedMatrix *p_src) { return new DirectedMatrix(*p_src); }
+	static UndirectedMatrix *_cloneMatrix(const UndirectedMatrix *p_src) { return new UndirectedMatrix(*p_src); }
+	static IMatrix *_cloneMatrix(const IMatrix *p_src) { return p_src->clone(); }
 
+	/**
+	 * \brief One empty matrix per storage type, never modified nor freed, left to the moved-from graphs
+	 * so that moving allocates nothing
+	 */
+	static DirectedMatrix *_emptyMatrix(configuration, DirectedMatrix *) { static DirectedMatrix empty; return &empty; }
+	static UndirectedMatrix *_emptyMatrix(configuration, UndirectedMatrix *) { static UndirectedMatrix empty; return &empty; }
+	static IMatrix *_emptyMatrix(configuration p_f, IMatrix *) {
+		static MatrixAdapter<DirectedMatrix> directed;
+		static MatrixAdapter<UndirectedMatrix> undirected;
+
+		if (p_f & UNDIRECTED) {
+			return &undirected;
+		}
+		return &directed;
+	}
+	bool _hasEmptyMatrix() const { return m_matrix == _emptyMatrix(this->m_config, static_cast<Storage *>(NULL)); }
+
+	/**
+	 * \brief Gives the graph a matrix of its own before its first change since it was moved from
+	 * \exception bad_alloc in case of insufficient memory
+	 */
+	void _ownMatrix() {
+		if (_hasEmptyMatrix()) {
+			m_matrix = _newMatrix(this->m_config, static_cast<Storage *>(NULL));
+		}
+	}
+
+	bool _find(const T &, unsigned &) const;
 	unsigned _index(const T &p_v) const;
+	/**
+	 * \brief Key of the cell of an edge in m_weights: (row, column), or (greatest, lowest) index in an undirected graph
+	 */
+	uint64_t _cell(unsigned p_v1, unsigned p_v2) const {
+		if (_isUndirected() && p_v1 < p_v2) {
+			std::swap(p_v1, p_v2);
+		}
+		return (static_cast<uint64_t>(p_v1) << 32) | p_v2;
+	}
+	weight_type _weight(unsigned p_v1, unsigned p_v2) const { return m_weights.get(_cell(p_v1, p_v2)); }
+	template<typename W> void _copyWeight(unsigned p_v1, unsigned p_v2, const W &p_weight, std::true_type) {
+		m_weights.set(_cell(p_v1, p_v2), p_weight);
+	}
+	template<typename W> void _copyWeight(unsigned, unsigned, const W &, std::false_type) {}
+
+	unsigned _inDegree(unsigned) const;
+	unsigned _outDegree(unsigned) const;
 	const std::string _repr() const;
 };
 
@@ -9,7 +9,8 @@
  */
 
 #include <stdexcept>
-#include <algorithm> // std::find
+#include <algorithm> // std::copy, std::min, std::find
+#include <sstream>
 using namespace std;
 
 namespace SGL {
@@ -25,43 +26,95 @@ namespace SGL {
  * \post The current graph is initialized with the given configuration
  * \exception bad_alloc in case of insufficient memory
  */
-template<typename T>
-Adjacency_Matrix<T>::Adjacency_Matrix(configuration p_f) {
-	this->m_config = p_f;
+template<typename T, typename Direction, typename Weighting>
+Adjacency_Matrix<T, Direction, Weighting>::Adjacency_Matrix(configuration p_f) {
+	this->m_config = Weighting::configure(Direction::configure(p_f));
 	this->m_nbVertices = 0;
-	if (p_f & UNDIRECTED) {
-		m_matrix = new UndirectedMatrix();
-	} else {
-		m_matrix = new DirectedMatrix();
-	}
+	m_matrix = _newMatrix(this->m_config, static_cast<Storage *>(NULL));
 }
 
 /**
- * \brief Copy constructor
+ * \brief Copy constructor: the vertices, their index and the bit matrix are copied as they are, in O(V + V^2/64)
  * \param[in] p_src the source graph that will be copied
  * \post The current graph is initialized with the same data as the source
  * \exception bad_alloc in case of insufficient memory
  */
-template<typename T>
-Adjacency_Matrix<T>::Adjacency_Matrix(const Adjacency_Matrix<T> &p_src) :
-		m_matrix(NULL) {
+template<typename T, typename Direction, typename Weighting>
+Adjacency_Matrix<T, Direction, Weighting>::Adjacency_Matrix(const Adjacency_Matrix<T, Direction, Weighting> &p_src) :
+		m_elems(p_src.m_elems), m_index(p_src.m_index), m_matrix(NULL), m_weights(p_src.m_weights),
+		m_fingerprint(p_src.m_fingerprint) {
 	this->m_config = p_src.m_config;
-	this->m_nbVertices = 0;
-	if (this->m_config & UNDIRECTED) {
-		m_matrix = new UndirectedMatrix();
-	} else {
-		m_matrix = new DirectedMatrix();
+	this->m_nbVertices = p_src.m_nbVertices;
+	m_matrix = _cloneMatrix(p_src.m_matrix);
+}
+
+/**
+ * \brief Conversion from an adjacency list, in O(V^2/64 + E): the vertices are numbered in the order of the list
+ * (its tombstones left out) and each edge sets its bit straight away, without any vertex lookup.
+ * The weights are kept when both graphs are weighted.
+ * \param[in] p_src the adjacency list to convert, whose configuration is taken
+ * \exception logic_error if the direction of the list doesn't match the Direction policy of the matrix
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting>
+template<typename SrcDirection, typename SrcWeighting, typename SrcAllocator>
+Adjacency_Matrix<T, Direction, Weighting>::Adjacency_Matrix(const Adjacency_List<T, SrcDirection, SrcWeighting, SrcAllocator> &p_src) :
+		Adjacency_Matrix(p_src.getConfiguration()) {
+	typedef std::integral_constant<bool, Weighting::isWeighted && SrcWeighting::isWeighted> Keep_Weights;
+	const unsigned deleted = ~0u;
+	vector<unsigned> newIndexes(p_src.m_nodes.size());
+
+	if (_isUndirected() != p_src._isUndirected()) {
+		throw logic_error("Adjacency_Matrix: the list doesn't have the same direction");
 	}
-	vector<T> vertices = p_src.vertices();
-	// add the vertices
-	for (unsigned i = 0; i < vertices.size(); i++) {
-		addVertex(vertices[i]);
+	reserveVertices(p_src.nbVertices());
+	for (unsigned v = 0; v < p_src.m_nodes.size(); v++) {
+		newIndexes[v] = p_src.m_nodes[v].m_deleted ? deleted : m_elems.size();
+		if (!p_src.m_nodes[v].m_deleted) {
+			_insertVertex(T(p_src.m_nodes[v].m_data));
+		}
 	}
-	// add the edges
-	vector<pair<T, T> > edges = p_src.edges();
-	for (unsigned pos = 0; pos < edges.size(); pos++) {
-		addEdge(edges[pos].first, edges[pos].second);
+	// an undirected list stores both directions of each edge: they set the same bit
+	for (unsigned v = 0; v < p_src.m_nodes.size(); v++) {
+		if (newIndexes[v] == deleted) {
+			continue;
+		}
+		for (unsigned edge_idx = 0; edge_idx < p_src.m_nodes[v].m_edges.size(); edge_idx++) {
+			const typename Adjacency_List<T, SrcDirection, SrcWeighting, SrcAllocator>::Edge &edge = p_src.m_nodes[v].m_edges[edge_idx];
+			unsigned dest_idx = newIndexes[edge.m_dest];
+
+			if (dest_idx != deleted) { // not a stale edge
+				m_matrix->addEdge(newIndexes[v], dest_idx);
+				_copyWeight(newIndexes[v], dest_idx, edge.weight(), Keep_Weights());
+			}
+		}
 	}
+	m_fingerprint.invalidate();
+}
+
+/**
+ * \brief Conversion from a compressed sparse row graph, in O(V^2/64 + E): the vertices keep their indexes and each
+ * neighbor sets its bit straight away, without any vertex lookup.
+ * \param[in] p_src the graph to convert, whose configuration is taken
+ * \exception logic_error if the direction of the graph doesn't match the Direction policy of the matrix
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting>
+Adjacency_Matrix<T, Direction, Weighting>::Adjacency_Matrix(const Compressed_Sparse_Row<T> &p_src) :
+		Adjacency_Matrix(p_src.getConfiguration()) {
+	if (_isUndirected() != p_src.hasConfiguration(UNDIRECTED)) {
+		throw logic_error("Adjacency_Matrix: the graph doesn't have the same direction");
+	}
+	reserveVertices(p_src.nbVertices());
+	for (unsigned v = 0; v < p_src.m_elems.size(); v++) {
+		_insertVertex(T(p_src.m_elems[v]));
+	}
+	for (unsigned v = 0; v < p_src.m_elems.size(); v++) {
+		for (unsigned pos = p_src.m_offsets[v]; pos < p_src.m_offsets[v + 1]; pos++) {
+			m_matrix->addEdge(v, p_src.m_neighbors[pos]);
+		}
+	}
+	m_fingerprint.invalidate();
 }
 
 /**
@@ -71,32 +124,70 @@ Adjacency_Matrix<T>::Adjacency_Matrix(const Adjacency_Matrix<T> &p_src) :
  * \exception bad_alloc in case of insufficient memory
  * \return the current class returns itself
  */
-template<typename T>
-Adjacency_Matrix<T> &Adjacency_Matrix<T>::operator=(const Adjacency_Matrix<T> & p_src) {
-	Adjacency_Matrix<T> copy(p_src);
+template<typename T, typename Direction, typename Weighting>
+Adjacency_Matrix<T, Direction, Weighting> &Adjacency_Matrix<T, Direction, Weighting>::operator=(const Adjacency_Matrix<T, Direction, Weighting> & p_src) {
+	Adjacency_Matrix<T, Direction, Weighting> copy(p_src);
+
+	_swap(copy);
+	m_observers.verticesReset(m_elems.size());
+	return (*this);
+}
 
+/**
+ * \brief Move constructor: takes the matrix and the vertices of the source without copying them
+ * \param[in] p_src the source graph, left empty with the same configuration
+ * Nothing is allocated: the source is left with the shared empty matrix, and gets its own with its next vertex.
+ */
+template<typename T, typename Direction, typename Weighting>
+Adjacency_Matrix<T, Direction, Weighting>::Adjacency_Matrix(Adjacency_Matrix<T, Direction, Weighting> &&p_src) noexcept {
 	this->m_config = p_src.m_config;
-	this->m_nbVertices = p_src.m_nbVertices;
-	std::swap(m_elems, copy.m_elems);
-	std::swap(m_matrix, copy.m_matrix);
+	this->m_nbVertices = 0;
+	m_matrix = _emptyMatrix(this->m_config, static_cast<Storage *>(NULL));
+	_swap(p_src);
+	p_src.m_observers.verticesReset(0);
+}
+
+/**
+ * \brief Move assignment operator overloading
+ * \param[in] p_src the source graph, left empty with the same configuration
+ * \post The current graph holds the data of the source, and its previous data is freed
+ * Only the Vertex_Property objects attached to the graph may allocate, to be resized: running out of memory there
+ * terminates the program.
+ * \return the current class returns itself
+ */
+template<typename T, typename Direction, typename Weighting>
+Adjacency_Matrix<T, Direction, Weighting> &Adjacency_Matrix<T, Direction, Weighting>::operator=(Adjacency_Matrix<T, Direction, Weighting> &&p_src) noexcept {
+	Adjacency_Matrix<T, Direction, Weighting> moved(std::move(p_src));
+
+	_swap(moved);
+	m_observers.verticesReset(m_elems.size());
 	return (*this);
 }
 
+/**
+ * \brief Exchanges the contents of two graphs, but not their observers
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::_swap(Adjacency_Matrix<T, Direction, Weighting> &p_other) {
+	std::swap(this->m_config, p_other.m_config);
+	std::swap(this->m_nbVertices, p_other.m_nbVertices);
+	m_elems.swap(p_other.m_elems);
+	std::swap(m_index, p_other.m_index);
+	std::swap(m_matrix, p_other.m_matrix);
+	std::swap(m_weights, p_other.m_weights);
+	std::swap(m_fingerprint, p_other.m_fingerprint);
+}
+
 /**
  * \brief verifies that a vertex is in the matrix
  * \param[in] p_v the element we search the vertex of
  * \return whether the matrix contains this vertex or not
  */
-template<typename T>
-bool Adjacency_Matrix<T>::hasVertex(const T &p_v) const {
-	bool isHere = true;
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::hasVertex(const T &p_v) const {
+	unsigned pos;
 
-	try {
-		_index(p_v);
-	} catch (const logic_error &le) {
-		isHere = false;
-	}
-	return isHere;
+	return _find(p_v, pos);
 }
 
 /**
@@ -107,8 +198,8 @@ bool Adjacency_Matrix<T>::hasVertex(const T &p_v) const {
  * \exception logic_error if one of the two vertices isn't in the matrix
  * \return whether the matrix contains this edge or not
  */
-template<typename T>
-bool Adjacency_Matrix<T>::hasEdge(const T &p_v1, const T &p_v2) const {
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::hasEdge(const T &p_v1, const T &p_v2) const {
 	int index_s1, index_s2;
 
 	try {
@@ -129,26 +220,16 @@ bool Adjacency_Matrix<T>::hasEdge(const T &p_v1, const T &p_v2) const {
  * \exception logic_error if the vertex isn't in the matrix
  * \return the number of edges to other vertices the vertex is the destination of
  */
-template<typename T>
-unsigned Adjacency_Matrix<T>::vertexInDegree(const T & p_v) const {
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::vertexInDegree(const T & p_v) const {
 	unsigned index_s;
-	unsigned indegree = 0;
 
 	try {
 		index_s = _index(p_v);
 	} catch (const logic_error &le) {
 		throw logic_error("vertexInDegree: the vertex isn't in the graph");
 	}
-	for (unsigned i = 0; i < m_elems.size(); i++) {
-		if (m_matrix->hasEdge(i, index_s)) {
-			indegree++;
-			// if the graph is undirected: a loop counts twice
-			if (i == index_s && hasConfiguration(UNDIRECTED)) {
-				indegree++;
-			}
-		}
-	}
-	return indegree;
+	return _inDegree(index_s);
 }
 
 /**
@@ -159,26 +240,16 @@ unsigned Adjacency_Matrix<T>::vertexInDegree(const T & p_v) const {
  * \exception logic_error if the vertex isn't in the graph
  * \return the number of edges to other vertices the vertex is the source of
  */
-template<typename T>
-unsigned Adjacency_Matrix<T>::vertexOutDegree(const T & p_v) const {
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::vertexOutDegree(const T & p_v) const {
 	unsigned index_s;
-	unsigned outdegree = 0;
 
 	try {
 		index_s = _index(p_v);
 	} catch (const logic_error &le) {
 		throw logic_error("vertexOutDegree: the vertex isn't in the graph");
 	}
-	for (unsigned i = 0; i < m_elems.size(); i++) {
-		if (m_matrix->hasEdge(index_s, i)) {
-			outdegree++;
-			// if the graph is undirected: a loop counts twice
-			if (i == index_s && hasConfiguration(UNDIRECTED)) {
-				outdegree++;
-			}
-		}
-	}
-	return outdegree;
+	return _outDegree(index_s);
 }
 
 /**
@@ -188,10 +259,10 @@ unsigned Adjacency_Matrix<T>::vertexOutDegree(const T & p_v) const {
  * \exception logic_error if the function is called with an undirected graph
  * \return (boolean) whether the vertex is a source or not
  */
-template<typename T>
-bool Adjacency_Matrix<T>::vertexIsSource(const T &p_v) const {
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::vertexIsSource(const T &p_v) const {
 	// no such thing as a source in an undirected graph (as the edges are undirected, they don't "come from" any vertex)
-	if (this->m_config & UNDIRECTED) {
+	if (_isUndirected()) {
 		throw logic_error("vertexIsSource: the graph is undirected");
 	}
 	return (vertexInDegree(p_v) == 0);
@@ -204,10 +275,10 @@ bool Adjacency_Matrix<T>::vertexIsSource(const T &p_v) const {
  * \exception logic_error if the function is called with an undirected graph
  * \return (boolean) whether the vertex is a sink or not
  */
-template<typename T>
-bool Adjacency_Matrix<T>::vertexIsSink(const T &p_v) const {
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::vertexIsSink(const T &p_v) const {
 	// no such thing as a source in an undirected graph (as the edges are undirected, they don't "come to" any vertex)
-	if (this->m_config & UNDIRECTED) {
+	if (_isUndirected()) {
 		throw logic_error("vertexIsSource: the graph is undirected");
 	}
 	return (vertexOutDegree(p_v) == 0);
@@ -225,8 +296,8 @@ bool Adjacency_Matrix<T>::vertexIsSink(const T &p_v) const {
  * \exception logic_error if the vertex isn't in the graph
  * \return A vector containing the data of all neighbor vertices of the vertex
  */
-template<typename T>
-vector<T> Adjacency_Matrix<T>::vertexNeighborhood(const T &p_v,
+template<typename T, typename Direction, typename Weighting>
+vector<T> Adjacency_Matrix<T, Direction, Weighting>::vertexNeighborhood(const T &p_v,
 		bool p_closed) const {
 	unsigned index;
 
@@ -235,16 +306,15 @@ vector<T> Adjacency_Matrix<T>::vertexNeighborhood(const T &p_v,
 	} catch (const logic_error &le) {
 		throw logic_error("vertexNeighborhood: the vertex isn't in the graph");
 	}
+	// the vertex is looked up once: the row is walked from its descriptor
+	adjacent_range adjacents = neighbors(Vertex_Descriptor(index));
 	vector<T> neighbors;
 
-	for (unsigned i = 0; i < m_elems.size(); i++) {
-		if (m_matrix->hasEdge(index, i)) {
-			neighbors.push_back(m_elems[i]);
-		}
+	neighbors.reserve(m_matrix->outDegree(index) + 1);
+	for (typename adjacent_range::iterator it = adjacents.begin(); it != adjacents.end(); ++it) {
+		neighbors.push_back(m_elems[(*it).index()]);
 	}
-	if (p_closed
-			&& std::find(neighbors.begin(), neighbors.end(), p_v)
-					== neighbors.end()) {
+	if (p_closed && !m_matrix->hasEdge(index, index)) {
 		neighbors.push_back(p_v);
 	}
 	return neighbors;
@@ -259,14 +329,90 @@ vector<T> Adjacency_Matrix<T>::vertexNeighborhood(const T &p_v,
  * \exception bad_alloc in case of insufficient memory
  * \exception logic_error if the vertex already is in the graph
  */
-template<typename T>
-void Adjacency_Matrix<T>::addVertex(const T &p_elem) {
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::addVertex(const T &p_elem) {
+	if (hasVertex(p_elem)) {
+		throw logic_error("addVertex: this element already is a vertex");
+	}
+	_insertVertex(T(p_elem));
+}
+
+/**
+ * \brief Adds a vertex to the graph, moving its data into it
+ * \param[in] p_elem the new element to put in the graph
+ * \post The graph counts one more vertex
+ * \exception bad_alloc in case of insufficient memory
+ * \exception logic_error if the vertex already is in the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::addVertex(T &&p_elem) {
 	if (hasVertex(p_elem)) {
 		throw logic_error("addVertex: this element already is a vertex");
 	}
-	m_elems.push_back(p_elem);
+	_insertVertex(std::move(p_elem));
+}
+
+/**
+ * \brief Adds a vertex whose data is built from the given arguments.
+ * The data is built once and then moved into the graph (the duplicate check needs it first).
+ * \param[in] p_args the arguments of a constructor of T
+ * \post The graph counts one more vertex
+ * \exception bad_alloc in case of insufficient memory
+ * \exception logic_error if the vertex already is in the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+template<typename... Args>
+void Adjacency_Matrix<T, Direction, Weighting>::emplaceVertex(Args &&...p_args) {
+	addVertex(T(std::forward<Args>(p_args)...));
+}
+
+/**
+ * \brief Stores a new vertex at the end
+ * \pre the vertex isn't in the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::_insertVertex(T &&p_elem) {
+	_ownMatrix();
+	m_elems.push_back(std::move(p_elem));
+	m_index.insert(m_elems.back(), m_elems.size() - 1);
 	m_matrix->addVertex();
+	m_fingerprint.addVertex(m_elems.back());
 	this->m_nbVertices++;
+	m_observers.vertexAdded(m_elems.size() - 1);
+}
+
+/**
+ * \brief Sets the bit of a new edge and adds it to the fingerprint
+ * \pre the edge isn't in the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::_setEdge(unsigned p_v1, unsigned p_v2) {
+	m_matrix->addEdge(p_v1, p_v2);
+	m_fingerprint.addEdge(m_elems[p_v1], m_elems[p_v2], _isUndirected());
+}
+
+/**
+ * \brief Clears the bit of an edge and takes it out of the fingerprint
+ * \pre the edge is in the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::_clearEdge(unsigned p_v1, unsigned p_v2) {
+	m_matrix->deleteEdge(p_v1, p_v2);
+	m_fingerprint.eraseEdge(m_elems[p_v1], m_elems[p_v2], _isUndirected());
+}
+
+/**
+ * \brief Preallocates the storage of the graph for a given number of vertices,
+ * so that the next vertex additions up to this number don't reallocate anything.
+ * \param[in] p_nb the number of vertices to make room for
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::reserveVertices(unsigned p_nb) {
+	_ownMatrix();
+	m_elems.reserve(p_nb);
+	m_index.reserve(p_nb);
+	m_matrix->reserveVertices(p_nb);
 }
 
 /**
@@ -276,8 +422,8 @@ void Adjacency_Matrix<T>::addVertex(const T &p_elem) {
  * \post The graph counts one less vertex
  * \exception logic_error if the vertex isn't in the graph
  */
-template<typename T>
-void Adjacency_Matrix<T>::deleteVertex(const T &p_v) {
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::deleteVertex(const T &p_v) {
 	int index_s;
 
 	try {
@@ -285,9 +431,25 @@ void Adjacency_Matrix<T>::deleteVertex(const T &p_v) {
 	} catch (const logic_error &le) {
 		throw logic_error("deleteVertex: the vertex isn't in the graph");
 	}
+	// take the edges of the vertex out of the fingerprint: its row (all its edges if undirected), then its column
+	for (unsigned dest = m_matrix->nextNeighbor(index_s, 0); dest < m_elems.size(); dest = m_matrix->nextNeighbor(index_s, dest + 1)) {
+		m_fingerprint.eraseEdge(p_v, m_elems[dest], _isUndirected());
+	}
+	if (!_isUndirected()) {
+		for (unsigned src = 0; src < m_elems.size(); src++) {
+			if (src != static_cast<unsigned>(index_s) && m_matrix->hasEdge(src, index_s)) {
+				m_fingerprint.eraseEdge(m_elems[src], p_v, false);
+			}
+		}
+	}
+	m_fingerprint.eraseVertex(p_v);
 	this->m_matrix->deleteVertex(index_s);
+	m_weights.deleteVertex(index_s);
 	m_elems.erase(m_elems.begin() + index_s);
+	m_index.erase(p_v);
+	m_index.shiftAbove(index_s); // the vertices after it have been shifted by one
 	this->m_nbVertices--;
+	m_observers.vertexErased(index_s);
 }
 
 /**
@@ -301,8 +463,8 @@ void Adjacency_Matrix<T>::deleteVertex(const T &p_v) {
  * \exception logic_error if one of the two vertices isn't in the graph
  * \exception logic_error if the edge already exists
  */
-template<typename T>
-void Adjacency_Matrix<T>::addEdge(const T &p_v1, const T &p_v2) {
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::addEdge(const T &p_v1, const T &p_v2) {
 	int index_s1, index_s2;
 	try {
 		index_s1 = _index(p_v1);
@@ -313,7 +475,7 @@ void Adjacency_Matrix<T>::addEdge(const T &p_v1, const T &p_v2) {
 	if (m_matrix->hasEdge(index_s1, index_s2)) {
 		throw logic_error("addEdge: this edge already exists");
 	}
-	m_matrix->addEdge(index_s1, index_s2);
+	_setEdge(index_s1, index_s2);
 }
 
 /**
@@ -324,8 +486,8 @@ void Adjacency_Matrix<T>::addEdge(const T &p_v1, const T &p_v2) {
  * \post The graph counts one less edge
  * \exception logic_error if one of the two vertices isn't in the graph
  */
-template<typename T>
-void Adjacency_Matrix<T>::deleteEdge(const T &p_v1, const T &p_v2) {
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::deleteEdge(const T &p_v1, const T &p_v2) {
 	int index_s1, index_s2;
 	try {
 		index_s1 = _index(p_v1);
@@ -336,7 +498,130 @@ void Adjacency_Matrix<T>::deleteEdge(const T &p_v1, const T &p_v2) {
 	if (!m_matrix->hasEdge(index_s1, index_s2)) {
 		throw logic_error("deleteEdge: no edge between the two vertices");
 	}
-	m_matrix->deleteEdge(index_s1, index_s2);
+	_clearEdge(index_s1, index_s2);
+	m_weights.erase(_cell(index_s1, index_s2));
+}
+
+/**
+ * \brief Adds a weighted edge in the graph (Weighted policy only)
+ * \param[in] p_v1 the source vertex of the edge
+ * \param[in] p_v2 the destination vertex of the edge
+ * \param[in] p_weight the weight of the edge
+ * \exception logic_error if one of the two vertices isn't in the graph
+ * \exception logic_error if the edge already exists
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::addEdge(const T &p_v1, const T &p_v2, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "addEdge: the graph is unweighted");
+	unsigned index_s1, index_s2;
+
+	if (!_find(p_v1, index_s1) || !_find(p_v2, index_s2)) {
+		throw logic_error("addEdge: one of the vertices isn't in the graph");
+	}
+	addEdge(Vertex_Descriptor(index_s1), Vertex_Descriptor(index_s2), p_weight);
+}
+
+/**
+ * \brief Returns the weight of an edge (1 in an unweighted graph)
+ * \param[in] p_v1 the source vertex of the edge
+ * \param[in] p_v2 the destination vertex of the edge
+ * \exception logic_error if one of the two vertices isn't in the graph
+ * \exception logic_error if there's no edge between the two vertices
+ */
+template<typename T, typename Direction, typename Weighting>
+typename Adjacency_Matrix<T, Direction, Weighting>::weight_type Adjacency_Matrix<T, Direction, Weighting>::edgeWeight(const T &p_v1, const T &p_v2) const {
+	unsigned index_s1, index_s2;
+
+	if (!_find(p_v1, index_s1) || !_find(p_v2, index_s2)) {
+		throw logic_error("edgeWeight: one of the vertices isn't in the graph");
+	}
+	return edgeWeight(Vertex_Descriptor(index_s1), Vertex_Descriptor(index_s2));
+}
+
+/**
+ * \brief Changes the weight of an edge (Weighted policy only)
+ * \param[in] p_v1 the source vertex of the edge
+ * \param[in] p_v2 the destination vertex of the edge
+ * \param[in] p_weight the new weight of the edge
+ * \exception logic_error if one of the two vertices isn't in the graph
+ * \exception logic_error if there's no edge between the two vertices
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::setEdgeWeight(const T &p_v1, const T &p_v2, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "setEdgeWeight: the graph is unweighted");
+	unsigned index_s1, index_s2;
+
+	if (!_find(p_v1, index_s1) || !_find(p_v2, index_s2)) {
+		throw logic_error("setEdgeWeight: one of the vertices isn't in the graph");
+	}
+	setEdgeWeight(Vertex_Descriptor(index_s1), Vertex_Descriptor(index_s2), p_weight);
+}
+
+/**
+ * \brief Adds a batch of vertices, all or none: the whole batch is checked before the graph is modified.
+ * The storage is reserved once for the batch (see reserveVertices), and the duplicates are found with one hashed
+ * lookup per vertex (a linear search for the vertex types with no Vertex_Hash, as in addVertex).
+ * \param[in] p_first, p_last the range of the vertex data (input iterators on T)
+ * \post The graph counts as many more vertices as there are in the batch
+ * \exception logic_error if a vertex already is in the graph, or appears twice in the batch
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting>
+template<typename InputIterator>
+void Adjacency_Matrix<T, Direction, Weighting>::addVertices(InputIterator p_first, InputIterator p_last) {
+	vector<T> batch(p_first, p_last);
+	Vertex_Index<T> inBatch;
+	unsigned pos;
+
+	inBatch.reserve(batch.size());
+	for (unsigned i = 0; i < batch.size(); i++) {
+		bool twice = inBatch.isEnabled() ? inBatch.find(batch[i], pos) :
+				std::find(batch.begin(), batch.begin() + i, batch[i]) != batch.begin() + i;
+
+		if (twice || _find(batch[i], pos)) {
+			throw logic_error("addVertices: this element already is a vertex");
+		}
+		inBatch.insert(batch[i], i);
+	}
+	reserveVertices(m_elems.size() + batch.size());
+	for (unsigned i = 0; i < batch.size(); i++) {
+		_insertVertex(std::move(batch[i]));
+	}
+}
+
+/**
+ * \brief Adds a batch of edges, all or none.
+ * The endpoints are all resolved before the matrix is modified. Since the cells are preallocated, the edges are then
+ * set one by one, the matrix itself finding the duplicates in O(1): the batch is rolled back on the first one.
+ * \param[in] p_first, p_last the range of the edges (input iterators on std::pair<T, T>, source first)
+ * \exception logic_error if one of the vertices isn't in the graph
+ * \exception logic_error if an edge already exists or appears twice in the batch
+ * (in an undirected graph, (a, b) and (b, a) are the same edge)
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T, typename Direction, typename Weighting>
+template<typename InputIterator>
+void Adjacency_Matrix<T, Direction, Weighting>::addEdges(InputIterator p_first, InputIterator p_last) {
+	vector<pair<unsigned, unsigned> > batch;
+
+	for (; p_first != p_last; ++p_first) {
+		unsigned index_s1, index_s2;
+
+		if (!_find((*p_first).first, index_s1) || !_find((*p_first).second, index_s2)) {
+			throw logic_error("addEdges: one of the vertices isn't in the graph");
+		}
+		batch.push_back(make_pair(index_s1, index_s2));
+	}
+	for (unsigned i = 0; i < batch.size(); i++) {
+		if (m_matrix->hasEdge(batch[i].first, batch[i].second)) {
+			// the edges added so far are all distinct: removing them restores the graph
+			while (i-- > 0) {
+				_clearEdge(batch[i].first, batch[i].second);
+			}
+			throw logic_error("addEdges: this edge already exists");
+		}
+		_setEdge(batch[i].first, batch[i].second);
+	}
 }
 
 /**
@@ -347,8 +632,8 @@ void Adjacency_Matrix<T>::deleteEdge(const T &p_v1, const T &p_v2) {
  * \exception bad_alloc in case of insufficient memory
  * \return a vector containing all the vertices of the graph
  */
-template<typename T>
-vector<T> Adjacency_Matrix<T>::vertices() const {
+template<typename T, typename Direction, typename Weighting>
+vector<T> Adjacency_Matrix<T, Direction, Weighting>::vertices() const {
 	vector<T> verts(m_elems);
 
 	return verts;
@@ -362,252 +647,673 @@ vector<T> Adjacency_Matrix<T>::vertices() const {
  * \exception bad_alloc in case of insufficient memory
  * \return A vector of pairs of elements organized as (source, destination)
  */
-template<typename T>
-vector<pair<T, T> > Adjacency_Matrix<T>::edges() const {
+template<typename T, typename Direction, typename Weighting>
+vector<pair<T, T> > Adjacency_Matrix<T, Direction, Weighting>::edges() const {
+	edge_range range = edgeRange();
 	vector<pair<T, T> > edges;
-	vector<vector<int> > edge_indexes;
 
-	m_matrix->edges(edge_indexes);
-	for (unsigned src = 0; src < edge_indexes.size(); src++) {
-		vector<pair<T, T> > vertex_edges;
-		for (unsigned dest = 0; dest < edge_indexes[src].size(); dest++) {
-			edges.push_back(make_pair(m_elems[src], m_elems[edge_indexes[src][dest]]));
-		}
+	edges.reserve(nbEdges());
+	for (typename edge_range::iterator it = range.begin(); it != range.end(); ++it) {
+		edges.push_back(*it);
 	}
 	return edges;
 }
 
 /**
- * \brief Checks the structural equality of two matrices.
+ * \brief Lazy range over the vertices, in the same order as vertices(), without copying them
+ * \return a forward range of const T &, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+typename Adjacency_Matrix<T, Direction, Weighting>::vertex_range Adjacency_Matrix<T, Direction, Weighting>::vertexRange() const {
+	return vertex_range(m_elems.begin(), m_elems.end());
+}
+
+/**
+ * \brief Lazy range over the neighbors of a vertex (open neighborhood), without copying them.
+ * The empty words of the matrix are skipped 64 cells at a time.
+ * \param[in] p_v the vertex we want the neighbors of
+ * \exception logic_error if the vertex isn't in the graph
+ * \return a forward range of const T &, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+typename Adjacency_Matrix<T, Direction, Weighting>::neighbor_range Adjacency_Matrix<T, Direction, Weighting>::neighborRange(const T &p_v) const {
+	unsigned index;
+
+	try {
+		index = _index(p_v);
+	} catch (const logic_error &le) {
+		throw logic_error("neighborRange: the vertex isn't in the graph");
+	}
+	typedef Value_Cursor<T, Adjacency_Matrix, AdjacentCursor> Cursor;
+
+	return neighbor_range(Range_Iterator<Cursor>(Cursor(this, AdjacentCursor(this, index, m_matrix->nextNeighbor(index, 0)))),
+			Range_Iterator<Cursor>(Cursor(this, AdjacentCursor(this, index, m_elems.size()))));
+}
+
+/**
+ * \brief Lazy range over the edges, in the same order as edges(), without copying them.
+ * The empty words of the matrix are skipped 64 cells at a time.
+ * \return a forward range of std::pair<const T &, const T &> (source, destination),
+ * invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+typename Adjacency_Matrix<T, Direction, Weighting>::edge_range Adjacency_Matrix<T, Direction, Weighting>::edgeRange() const {
+	return edge_range(Range_Iterator<EdgeCursor>(EdgeCursor(this, 0)),
+			Range_Iterator<EdgeCursor>(EdgeCursor(this, m_elems.size())));
+}
+
+/**
+ * \brief Returns the descriptor of a vertex, to use the methods which don't look the vertex up
+ * \param[in] p_v the vertex
+ * \exception logic_error if the vertex isn't in the graph
+ * \return the descriptor of the vertex
+ */
+template<typename T, typename Direction, typename Weighting>
+Vertex_Descriptor Adjacency_Matrix<T, Direction, Weighting>::descriptor(const T &p_v) const {
+	try {
+		return Vertex_Descriptor(_index(p_v));
+	} catch (const logic_error &le) {
+		throw logic_error("descriptor: the vertex isn't in the graph");
+	}
+}
+
+/**
+ * \brief verifies that an edge is in the matrix
+ * \pre the descriptors are valid descriptors of this graph (they aren't checked)
+ */
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::hasEdge(Vertex_Descriptor p_v1, Vertex_Descriptor p_v2) const {
+	return m_matrix->hasEdge(p_v1.index(), p_v2.index());
+}
+
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::inDegree(Vertex_Descriptor p_v) const {
+	return _inDegree(p_v.index());
+}
+
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::outDegree(Vertex_Descriptor p_v) const {
+	return _outDegree(p_v.index());
+}
+
+/**
+ * \brief Lazy range over the descriptors of the neighbors of a vertex (open neighborhood)
+ * \return a forward range of Vertex_Descriptor, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+typename Adjacency_Matrix<T, Direction, Weighting>::adjacent_range Adjacency_Matrix<T, Direction, Weighting>::neighbors(Vertex_Descriptor p_v) const {
+	unsigned index = p_v.index();
+
+	return adjacent_range(Range_Iterator<AdjacentCursor>(AdjacentCursor(this, index, m_matrix->nextNeighbor(index, 0))),
+			Range_Iterator<AdjacentCursor>(AdjacentCursor(this, index, m_elems.size())));
+}
+
+/**
+ * \brief Adds an edge in the graph
+ * \exception logic_error if the edge already exists
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::addEdge(Vertex_Descriptor p_v1, Vertex_Descriptor p_v2) {
+	if (m_matrix->hasEdge(p_v1.index(), p_v2.index())) {
+		throw logic_error("addEdge: this edge already exists");
+	}
+	_setEdge(p_v1.index(), p_v2.index());
+}
+
+/**
+ * \brief Lazy range over the neighbors of a vertex with the weights of the edges going to them
+ * \return a forward range of std::pair<Vertex_Descriptor, weight_type>, invalidated by any modification of the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+typename Adjacency_Matrix<T, Direction, Weighting>::weighted_range Adjacency_Matrix<T, Direction, Weighting>::weightedNeighbors(Vertex_Descriptor p_v) const {
+	typedef Weighted_Cursor<AdjacentCursor, weight_type> Cursor;
+	unsigned index = p_v.index();
+
+	return weighted_range(Range_Iterator<Cursor>(Cursor(AdjacentCursor(this, index, m_matrix->nextNeighbor(index, 0)))),
+			Range_Iterator<Cursor>(Cursor(AdjacentCursor(this, index, m_elems.size()))));
+}
+
+/**
+ * \brief Returns the weight of an edge (1 in an unweighted graph)
+ * \exception logic_error if there's no edge between the two vertices
+ */
+template<typename T, typename Direction, typename Weighting>
+typename Adjacency_Matrix<T, Direction, Weighting>::weight_type Adjacency_Matrix<T, Direction, Weighting>::edgeWeight(Vertex_Descriptor p_v1, Vertex_Descriptor p_v2) const {
+	if (!m_matrix->hasEdge(p_v1.index(), p_v2.index())) {
+		throw logic_error("edgeWeight: no edge between the two vertices");
+	}
+	return _weight(p_v1.index(), p_v2.index());
+}
+
+/**
+ * \brief Adds a weighted edge in the graph (Weighted policy only)
+ * \exception logic_error if the edge already exists
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::addEdge(Vertex_Descriptor p_v1, Vertex_Descriptor p_v2, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "addEdge: the graph is unweighted");
+	addEdge(p_v1, p_v2);
+	m_weights.set(_cell(p_v1.index(), p_v2.index()), p_weight);
+}
+
+/**
+ * \brief Changes the weight of an edge (Weighted policy only)
+ * \exception logic_error if there's no edge between the two vertices
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::setEdgeWeight(Vertex_Descriptor p_v1, Vertex_Descriptor p_v2, const weight_type &p_weight) {
+	static_assert(Weighting::isWeighted, "setEdgeWeight: the graph is unweighted");
+	if (!m_matrix->hasEdge(p_v1.index(), p_v2.index())) {
+		throw logic_error("setEdgeWeight: no edge between the two vertices");
+	}
+	m_weights.set(_cell(p_v1.index(), p_v2.index()), p_weight);
+}
+
+/**
+ * \brief Deletes an edge in the graph
+ * \exception logic_error if there's no edge between the two vertices
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::deleteEdge(Vertex_Descriptor p_v1, Vertex_Descriptor p_v2) {
+	if (!m_matrix->hasEdge(p_v1.index(), p_v2.index())) {
+		throw logic_error("deleteEdge: no edge between the two vertices");
+	}
+	_clearEdge(p_v1.index(), p_v2.index());
+	m_weights.erase(_cell(p_v1.index(), p_v2.index()));
+}
+
+/**
+ * \brief Order-independent hash of the vertices and edges, kept up to date by the mutators: O(1), or O(V^2/64 + E)
+ * after a conversion
+ * \return the same value as any equal graph, whatever its representation
+ */
+template<typename T, typename Direction, typename Weighting>
+uint64_t Adjacency_Matrix<T, Direction, Weighting>::fingerprint() const {
+	if (!m_fingerprint.isValid()) {
+		_computeFingerprint();
+	}
+	return m_fingerprint.value();
+}
+
+/**
+ * \brief Computes the fingerprint again from all the vertices and edges (each undirected edge listed once)
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::_computeFingerprint() const {
+	edge_range range = edgeRange();
+
+	m_fingerprint.reset();
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		m_fingerprint.addVertex(m_elems[v]);
+	}
+	for (typename edge_range::iterator it = range.begin(); it != range.end(); ++it) {
+		m_fingerprint.addEdge((*it).first, (*it).second, _isUndirected());
+	}
+}
+
+/**
+ * \brief Checks the structural equality of two matrices, whatever the order of their vertices.
+ * The weights aren't compared.
+ * O(1) when the counters or the fingerprints differ; otherwise each vertex is looked up once in the other graph and
+ * the edges are compared by index, in O(V^2/64 + E) (with a Vertex_Hash).
  * \param[in] p_rhs the graph we want to compare the current one to
  * \return true if the matrices are identical, else false
  */
-template<typename T>
-bool Adjacency_Matrix<T>::operator==(const Adjacency_Matrix &p_rhs) const {
-	bool areEqual = true;
-	// first check number of edges/vertices
-	areEqual = (nbEdges() == p_rhs.nbEdges() || nbVertices() == p_rhs.nbVertices());
-	// then check that vertices and edges are the same (don't do it if one of the first checks was already wrong)
-	if (areEqual) {
-		areEqual = (vertices() == p_rhs.vertices() && edges() == p_rhs.edges());
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::operator==(const Adjacency_Matrix &p_rhs) const {
+	if (_isUndirected() != p_rhs._isUndirected() || nbVertices() != p_rhs.nbVertices()
+			|| nbEdges() != p_rhs.nbEdges() || fingerprint() != p_rhs.fingerprint()) {
+		return false;
+	}
+	vector<unsigned> rhsIndexes(m_elems.size());
+
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		if (!p_rhs._find(m_elems[v], rhsIndexes[v])) {
+			return false;
+		}
 	}
-	return areEqual;
+	// as many edges on both sides: the inclusion is enough
+	for (unsigned src = 0; src < m_elems.size(); src++) {
+		for (unsigned dest = m_matrix->nextEdge(src, 0); dest < m_elems.size(); dest = m_matrix->nextEdge(src, dest + 1)) {
+			if (!p_rhs.m_matrix->hasEdge(rhsIndexes[src], rhsIndexes[dest])) {
+				return false;
+			}
+		}
+	}
+	return true;
 }
 
 /**
- * \brief Output function.
+ * \brief Writes the topology of the graph to a graph file (see GraphFile.h), for Mapped_Graph to map it, in
+ * O(V^2/64 + E). Besides the adjacency lists, the file holds the square bit matrix (also for an undirected graph,
+ * whose storage only keeps a triangle), so that the mapped graph answers hasEdge in O(1). The weights aren't saved.
+ * \param[in] p_path the path of the file, replaced at once if it exists (a failed save leaves it as it was)
+ * \exception runtime_error if the file can't be written
+ * \exception bad_alloc in case of insufficient memory
  */
-template<typename T>
-const string Adjacency_Matrix<T>::_repr() const {
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::save(const std::string &p_path) const {
+	static_assert(std::is_trivially_copyable<T>::value, "save: the vertex type must be trivially copyable");
+	const unsigned nbVertices = m_elems.size();
+	const unsigned rowWords = (nbVertices + 63) / 64;
+	vector<unsigned> inDegrees(nbVertices, 0);
+	vector<uint64_t> bits(rowWords);
+	vector<unsigned> row;
+	unsigned nbArcs = 0;
+
+	Graph_File_Writer file(p_path, this->m_config, sizeof(T), nbVertices);
+
+	file.beginSection(Graph_File_Header::VERTICES);
+	file.write(m_elems.data(), nbVertices);
+	// the neighbors come out of nextNeighbor in index order: the rows are written as they are read
+	file.beginSection(Graph_File_Header::OFFSETS);
+	file.write(nbArcs);
+	for (unsigned src = 0; src < nbVertices; src++) {
+		for (unsigned dest = m_matrix->nextNeighbor(src, 0); dest < nbVertices; dest = m_matrix->nextNeighbor(src, dest + 1)) {
+			nbArcs++;
+		}
+		file.write(nbArcs);
+	}
+	file.beginSection(Graph_File_Header::NEIGHBORS);
+	for (unsigned src = 0; src < nbVertices; src++) {
+		row.clear();
+		for (unsigned dest = m_matrix->nextNeighbor(src, 0); dest < nbVertices; dest = m_matrix->nextNeighbor(src, dest + 1)) {
+			inDegrees[dest]++;
+			row.push_back(dest);
+		}
+		file.write(row.data(), row.size());
+	}
+	file.beginSection(Graph_File_Header::IN_DEGREES);
+	file.write(inDegrees.data(), inDegrees.size());
+	file.beginSection(Graph_File_Header::BITS);
+	for (unsigned src = 0; src < nbVertices; src++) {
+		std::fill(bits.begin(), bits.end(), 0);
+		for (unsigned dest = m_matrix->nextNeighbor(src, 0); dest < nbVertices; dest = m_matrix->nextNeighbor(src, dest + 1)) {
+			bits[dest / 64] |= uint64_t(1) << (dest % 64);
+		}
+		file.write(bits.data(), bits.size());
+	}
+	file.finish(nbEdges(), nbArcs, rowWords, fingerprint());
+}
+
+/**
+ * \brief Output function: the counts, then one "vertex: neighbors" line per vertex (in index order).
+ * For big graphs, Graph_Writer (GraphWriter.h) writes the same without building a string.
+ */
+template<typename T, typename Direction, typename Weighting>
+const string Adjacency_Matrix<T, Direction, Weighting>::_repr() const {
 	stringstream stream;
-//
-//	stream << "Matrix vertices number: " << nbVertices() << endl;
-//	stream << "Matrix edges number: " << nbEdges() << endl;
-//	stream << "Matrix composition:" << endl;
-//	if (nbVertices() == 0) {
-//		stream << "null";
-//	} else {
-//		stream << "\t";
-//	}
-//	for (unsigned i = 0; i < m_elems.size(); i++) {
-//		stream << m_elems[i] << "\t";
-//	}
-//	stream << endl;
-//	for (unsigned i = 0; i < m_matrix.size(); i++) {
-//		stream << m_elems[i] << "\t";
-//		for (unsigned j = 0; j < m_matrix[i].size(); j++) {
-//			stream << m_matrix[i][j] << "\t";
-//		}
-//		stream << endl;
-//	}
+
+	stream << (_isUndirected() ? "Undirected" : "Directed") << " matrix: " << nbVertices() << " vertices, "
+			<< nbEdges() << " edges" << endl;
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		stream << m_elems[v] << ":";
+		for (unsigned dest = m_matrix->nextNeighbor(v, 0); dest < m_elems.size(); dest = m_matrix->nextNeighbor(v, dest + 1)) {
+			stream << " " << m_elems[dest];
+		}
+		stream << endl;
+	}
 	return stream.str();
 }
 
 /**
  * \brief Private function used to retrieve the index in the intern adjacency list of an element
+ * Goes through the vertex hash index, or does a linear search if the vertex type has no hasher.
  * \pre The vertex is in the graph
  * \param[in] p_v the vertex to search
  * \exception logic_error the vertex isn't in the graph
  * \return the index in the adjacency list of the given vertex's node
  */
-template<typename T>
-unsigned Adjacency_Matrix<T>::_index(const T &p_v) const {
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::_index(const T &p_v) const {
+	unsigned pos;
+
+	if (!_find(p_v, pos)) {
+		throw logic_error("Vertex not in the graph");
+	}
+	return pos;
+}
+
+/**
+ * \brief Looks up the index of a vertex, without throwing
+ * \param[in] p_v the vertex to search
+ * \param[out] p_pos the index of the vertex, if found
+ * \return false if the vertex isn't in the graph
+ */
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::_find(const T &p_v, unsigned &p_pos) const {
+	if (m_index.isEnabled()) {
+		return m_index.find(p_v, p_pos);
+	}
 	for (unsigned pos = 0; pos < m_elems.size(); pos++) {
 		if (m_elems[pos] == p_v) {
-			return pos;
+			p_pos = pos;
+			return true;
 		}
 	}
-	throw logic_error("Vertex not in the graph");
+	return false;
+}
+
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::_inDegree(unsigned p_idx) const {
+	unsigned indegree = m_matrix->inDegree(p_idx);
+
+	// if the graph is undirected: a loop counts twice
+	if (_isUndirected() && m_matrix->hasEdge(p_idx, p_idx)) {
+		indegree++;
+	}
+	return indegree;
+}
+
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::_outDegree(unsigned p_idx) const {
+	unsigned outdegree = m_matrix->outDegree(p_idx);
+
+	// if the graph is undirected: a loop counts twice
+	if (_isUndirected() && m_matrix->hasEdge(p_idx, p_idx)) {
+		outdegree++;
+	}
+	return outdegree;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Internal matrices methods: Directed matrix
+// Weights of a weighted matrix
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template<typename T>
-unsigned Adjacency_Matrix<T>::DirectedMatrix::nbEdges() const {
-	unsigned nbEdges = 0;
+/**
+ * \brief Drops the weights of the edges of a deleted vertex and renumbers the others, in O(E).
+ * The renumbering keeps the order of the indexes, so the keys of an undirected graph stay (greatest, lowest).
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::WeightMap::deleteVertex(unsigned p_idx) {
+	std::unordered_map<uint64_t, weight_type> weights;
 
-	for (unsigned pos = 0; pos != m_matrix.size(); pos++) {
-		for (unsigned i = 0; i < m_matrix[pos].size(); i++) {
-			if (m_matrix[pos][i] == 1) {
-				nbEdges++;
-			}
+	weights.reserve(m_weights.size());
+	for (typename std::unordered_map<uint64_t, weight_type>::const_iterator it = m_weights.begin(); it != m_weights.end(); ++it) {
+		unsigned row = it->first >> 32;
+		unsigned column = it->first & 0xFFFFFFFFu;
+
+		if (row != p_idx && column != p_idx) {
+			row -= (row > p_idx);
+			column -= (column > p_idx);
+			weights[(static_cast<uint64_t>(row) << 32) | column] = it->second;
 		}
 	}
-	return nbEdges;
+	m_weights.swap(weights);
 }
 
-template<typename T>
-bool Adjacency_Matrix<T>::DirectedMatrix::hasEdge(unsigned p_idx_v1,
-		unsigned p_idx_v2) const {
-	return (m_matrix[p_idx_v1][p_idx_v2] != 0);
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Internal matrices methods: Directed matrix
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::nbEdges() const {
+	// the padding bits are always 0, so the whole buffer can be counted at once
+	return popCount(m_matrix.data(), m_matrix.size());
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::DirectedMatrix::addVertex() {
-	vector<int> newline(m_matrix.size(), 0);
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::outDegree(unsigned p_idx) const {
+	return popCount(_row(p_idx), m_rowWords);
+}
 
-	m_matrix.push_back(newline);
-	for (unsigned i = 0; i < m_matrix.size(); i++) {
-		m_matrix[i].push_back(0);
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::inDegree(unsigned p_idx) const {
+	unsigned word = p_idx / WORD_BITS;
+	uint64_t mask = 1ULL << (p_idx % WORD_BITS);
+	unsigned indegree = 0;
+
+	// same word and mask in every row: walk down the column
+	for (unsigned pos = 0; pos < m_nbVertices; pos++) {
+		indegree += ((_row(pos)[word] & mask) != 0);
+	}
+	return indegree;
+}
+
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::hasEdge(unsigned p_idx_v1,
+		unsigned p_idx_v2) const {
+	return ((_row(p_idx_v1)[p_idx_v2 / WORD_BITS] >> (p_idx_v2 % WORD_BITS)) & 1) != 0;
+}
+
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::addVertex() {
+	// out of columns: double the row stride, so that the rows are moved O(log n) times overall
+	if (m_nbVertices == m_rowWords * WORD_BITS) {
+		_resizeRows(std::max(1u, 2 * m_rowWords));
 	}
+	m_nbVertices++;
+	m_matrix.resize(static_cast<std::size_t>(m_nbVertices) * m_rowWords, 0);
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::DirectedMatrix::deleteVertex(unsigned p_index) {
-	for (unsigned pos = 0; pos != m_matrix.size(); pos++) {
-		m_matrix[pos].erase(m_matrix[pos].begin() + p_index);
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::deleteVertex(unsigned p_index) {
+	unsigned word = p_index / WORD_BITS;
+	unsigned bit = p_index % WORD_BITS;
+	std::size_t rowStart = static_cast<std::size_t>(p_index) * m_rowWords;
+
+	// remove the row
+	m_matrix.erase(m_matrix.begin() + rowStart, m_matrix.begin() + rowStart + m_rowWords);
+	m_nbVertices--;
+	// remove the column: in every row, the bits after it are shifted down by one
+	for (unsigned pos = 0; pos < m_nbVertices; pos++) {
+		uint64_t *row = _row(pos);
+
+		row[word] = (row[word] & lowMask(bit)) | ((row[word] >> 1) & ~lowMask(bit));
+		for (unsigned w = word; w + 1 < m_rowWords; w++) {
+			row[w] |= (row[w + 1] & 1) << (WORD_BITS - 1);
+			row[w + 1] >>= 1;
+		}
 	}
-	m_matrix.erase(m_matrix.begin() + p_index);
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::DirectedMatrix::addEdge(unsigned p_idx_v1,
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::addEdge(unsigned p_idx_v1,
 		unsigned p_idx_v2) {
-	m_matrix[p_idx_v1][p_idx_v2] = 1;
+	_row(p_idx_v1)[p_idx_v2 / WORD_BITS] |= 1ULL << (p_idx_v2 % WORD_BITS);
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::DirectedMatrix::deleteEdge(unsigned p_idx_v1,
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::deleteEdge(unsigned p_idx_v1,
 		unsigned p_idx_v2) {
-	m_matrix[p_idx_v1][p_idx_v2] = 0;
+	_row(p_idx_v1)[p_idx_v2 / WORD_BITS] &= ~(1ULL << (p_idx_v2 % WORD_BITS));
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::DirectedMatrix::edges(
-		vector<vector<int> > & p_edges_indexes) const {
-	for (unsigned i = 0; i < m_matrix.size(); i++) {
-		vector<int> vertex_edges_dests;
+/**
+ * \brief Finds the first neighbor of a vertex from a given column, word by word
+ * \return the index of the neighbor, or the number of vertices if there's none
+ */
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::nextNeighbor(unsigned p_idx, unsigned p_from) const {
+	const uint64_t *row = _row(p_idx);
+	unsigned w = p_from / WORD_BITS;
+	uint64_t bits;
 
-		for (unsigned j = 0; j < m_matrix[i].size(); j++) {
-			if (m_matrix[i][j] != 0) {
-				vertex_edges_dests.push_back(j);
-			}
+	if (p_from >= m_nbVertices) {
+		return m_nbVertices;
+	}
+	// the padding bits are always 0, so no set bit can be found past the last vertex
+	for (bits = row[w] & ~lowMask(p_from % WORD_BITS); bits == 0; bits = row[w]) {
+		if (++w == m_rowWords) {
+			return m_nbVertices;
 		}
-		p_edges_indexes.push_back(vertex_edges_dests);
 	}
+	return w * WORD_BITS + lowestBit(bits);
+}
+
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::reserveVertices(unsigned p_nb) {
+	if (p_nb > m_rowWords * WORD_BITS) {
+		_resizeRows(static_cast<unsigned>(wordsFor(p_nb)));
+	}
+	m_matrix.reserve(static_cast<std::size_t>(p_nb) * m_rowWords);
+}
+
+/**
+ * \brief Changes the number of words of every row, moving the rows to their new place in a single new buffer.
+ */
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::DirectedMatrix::_resizeRows(unsigned p_rowWords) {
+	vector<uint64_t> resized;
+	unsigned kept = std::min(m_rowWords, p_rowWords);
+
+	resized.reserve(std::max(m_matrix.size(), m_matrix.capacity()) / std::max(1u, m_rowWords) * p_rowWords);
+	resized.resize(static_cast<std::size_t>(m_nbVertices) * p_rowWords, 0);
+	for (unsigned pos = 0; pos < m_nbVertices; pos++) {
+		std::copy(_row(pos), _row(pos) + kept, resized.begin() + static_cast<std::size_t>(pos) * p_rowWords);
+	}
+	m_matrix.swap(resized);
+	m_rowWords = p_rowWords;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Internal matrices methods: Undirected matrix
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template<typename T>
-unsigned Adjacency_Matrix<T>::UndirectedMatrix::nbEdges() const {
-	unsigned nbEdges = 0;
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::nbEdges() const {
+	// the padding bits are always 0, so the whole buffer can be counted at once
+	return popCount(m_matrix.data(), m_matrix.size());
+}
 
-	for (unsigned i = 0; i != m_matrix.size(); i++) {
-		if (m_matrix[i] != 0) {
-			nbEdges++;
-		}
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::outDegree(unsigned p_idx) const {
+	// the row part: cells (p_idx, 0..p_idx)
+	unsigned degree = popCount(m_matrix.data(), _rowStart(p_idx), p_idx + 1);
+
+	// the column part: cells (p_idx+1..n-1, p_idx)
+	for (unsigned row = p_idx + 1; row < m_nbVertices; row++) {
+		std::size_t bit = _rowStart(row) + p_idx;
+
+		degree += (m_matrix[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
 	}
-	return nbEdges;
+	return degree;
 }
 
-template<typename T>
-bool Adjacency_Matrix<T>::UndirectedMatrix::hasEdge(unsigned p_idx_v1,
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::inDegree(unsigned p_idx) const {
+	return outDegree(p_idx); // symmetric matrix
+}
+
+template<typename T, typename Direction, typename Weighting>
+bool Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::hasEdge(unsigned p_idx_v1,
 		unsigned p_idx_v2) const {
-	return (m_matrix[_calcActualIndex(p_idx_v1, p_idx_v2)] != 0);
+	std::size_t bit = _calcActualIndex(p_idx_v1, p_idx_v2);
+
+	return ((m_matrix[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1) != 0;
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::UndirectedMatrix::edges(
-		vector<vector<int> > & p_edges_indexes) const {
-	vector<int> vertex_edges_dests;
+/**
+ * \brief Finds the first neighbor of a vertex from a given index: in its row word by word, then down its column
+ * \return the index of the neighbor, or the number of vertices if there's none
+ */
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::nextNeighbor(unsigned p_idx, unsigned p_from) const {
+	if (p_from <= p_idx) {
+		unsigned col = _nextInRow(p_idx, p_from);
 
-	for (unsigned idx = 0; idx < _nbVertices(); idx++) {
-		vector<int> vertex_edges_dests;
+		if (col <= p_idx) {
+			return col;
+		}
+		p_from = p_idx + 1;
+	}
+	for (unsigned row = p_from; row < m_nbVertices; row++) {
+		std::size_t bit = _rowStart(row) + p_idx;
 
-		unsigned startIndex = (idx + 1) * idx / 2;
-		for (unsigned pos = 0; pos < (idx + 1); pos++) {
-			if (m_matrix[startIndex + pos] != 0) {
-				vertex_edges_dests.push_back(pos);
-			}
+		if ((m_matrix[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1) {
+			return row;
 		}
-		p_edges_indexes.push_back(vertex_edges_dests);
 	}
+	return m_nbVertices;
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::UndirectedMatrix::addVertex() {
-	unsigned matrixSize = m_matrix.size();
+/**
+ * \brief Finds the next edge stored in a row (each edge is only stored once, with its destination <= its source)
+ * \return the index of the destination, or the number of vertices if there's none
+ */
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::nextEdge(unsigned p_idx, unsigned p_from) const {
+	unsigned col = (p_from <= p_idx) ? _nextInRow(p_idx, p_from) : p_idx + 1;
 
-	for (unsigned i = 0; i < matrixSize + 1; i++) {
-		m_matrix.push_back(0);
-	}
+	return (col <= p_idx) ? col : m_nbVertices;
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::UndirectedMatrix::deleteVertex(unsigned p_index) {
-	// first, remove the edges of the vertices following this one
-	for (unsigned pos = _nbVertices() - 1; pos != p_index; pos--) {
-		int edgeIndex = (pos + 1) * pos / 2 + p_index;
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::addVertex() {
+	m_nbVertices++;
+	m_matrix.resize(wordsFor(_rowStart(m_nbVertices)), 0);
+}
+
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::reserveVertices(unsigned p_nb) {
+	m_matrix.reserve(wordsFor(_rowStart(p_nb)));
+}
 
-		m_matrix.erase(m_matrix.begin() + edgeIndex);
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::deleteVertex(unsigned p_index) {
+	vector<uint64_t> matrix(wordsFor(_rowStart(m_nbVertices - 1)), 0);
+	// the rows before the vertex are unchanged
+	std::size_t dest = _rowStart(p_index);
+
+	copyBits(matrix.data(), 0, m_matrix.data(), 0, dest);
+	// the rows after it lose their cell in the vertex column
+	for (unsigned row = p_index + 1; row < m_nbVertices; row++) {
+		std::size_t src = _rowStart(row);
+
+		copyBits(matrix.data(), dest, m_matrix.data(), src, p_index);
+		copyBits(matrix.data(), dest + p_index, m_matrix.data(), src + p_index + 1, row - p_index);
+		dest += row;
 	}
-	// grab the index of the "vertex-0" edge, the first of this vertex edges
-	unsigned startIndex = (p_index + 1) * p_index / 2;
-	// next, remove all the edges of the vertex itself
-	m_matrix.erase(m_matrix.begin() + startIndex,
-			m_matrix.begin() + startIndex + (p_index + 1));
+	m_matrix.swap(matrix);
+	m_nbVertices--;
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::UndirectedMatrix::addEdge(unsigned p_idx_v1,
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::addEdge(unsigned p_idx_v1,
 		unsigned p_idx_v2) {
-	m_matrix[_calcActualIndex(p_idx_v1, p_idx_v2)] = 1;
+	std::size_t bit = _calcActualIndex(p_idx_v1, p_idx_v2);
+
+	m_matrix[bit / WORD_BITS] |= 1ULL << (bit % WORD_BITS);
 }
 
-template<typename T>
-void Adjacency_Matrix<T>::UndirectedMatrix::deleteEdge(unsigned p_idx_v1,
+template<typename T, typename Direction, typename Weighting>
+void Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::deleteEdge(unsigned p_idx_v1,
 		unsigned p_idx_v2) {
-	m_matrix[_calcActualIndex(p_idx_v1, p_idx_v2)] = 0;
+	std::size_t bit = _calcActualIndex(p_idx_v1, p_idx_v2);
+
+	m_matrix[bit / WORD_BITS] &= ~(1ULL << (bit % WORD_BITS));
 }
 
-template<typename T>
-unsigned Adjacency_Matrix<T>::UndirectedMatrix::_nbVertices() const {
-	unsigned nbVertices = 0;
-	unsigned step = 2;
-	unsigned cpt = 1;
+/**
+ * \brief First cell set in the row part of a vertex (cells (p_row, p_from..p_row)), skipping the empty words
+ * \return the column of the cell, or p_row + 1 if there's none
+ */
+template<typename T, typename Direction, typename Weighting>
+unsigned Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::_nextInRow(unsigned p_row, unsigned p_from) const {
+	std::size_t start = _rowStart(p_row);
+	std::size_t end = start + p_row + 1;
+
+	for (std::size_t pos = start + p_from; pos < end; pos += WORD_BITS - pos % WORD_BITS) {
+		uint64_t bits = m_matrix[pos / WORD_BITS] & ~lowMask(pos % WORD_BITS);
+
+		if (bits != 0) {
+			std::size_t bit = pos - pos % WORD_BITS + lowestBit(bits);
 
-	while (cpt <= m_matrix.size()) {
-		nbVertices++;
-		cpt += step;
-		step++;
+			return (bit < end) ? static_cast<unsigned>(bit - start) : p_row + 1;
+		}
 	}
-	return nbVertices;
+	return p_row + 1;
 }
 
-template<typename T>
-unsigned Adjacency_Matrix<T>::UndirectedMatrix::_calcActualIndex(
+template<typename T, typename Direction, typename Weighting>
+std::size_t Adjacency_Matrix<T, Direction, Weighting>::UndirectedMatrix::_calcActualIndex(
 		unsigned p_idx_v1, unsigned p_idx_v2) const {
-	unsigned index;
+	std::size_t index;
 
 	if (p_idx_v1 > p_idx_v2) {
-		index = (p_idx_v1 + 1) * p_idx_v1 / 2 + p_idx_v2;
+		index = _rowStart(p_idx_v1) + p_idx_v2;
 	} else {
-		index = (p_idx_v2 + 1) * p_idx_v2 / 2 + p_idx_v1;
+		index = _rowStart(p_idx_v2) + p_idx_v1;
 	}
 	return index;
 }
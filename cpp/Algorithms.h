@@ -0,0 +1,152 @@
+//! \file Algorithms.h
+//! \brief Generic graph algorithms, instantiated for each concrete graph class (no virtual calls)
+//! \version 0.1
+
+#ifndef ALGORITHMS_H_
+#define ALGORITHMS_H_
+
+#include <vector>
+#include <deque>
+#include <utility>
+#include <type_traits>
+
+#include "VertexIndex.h"
+
+namespace SGL {
+
+/**
+ * \brief Helper of Is_Static_Graph: void whatever its (valid) parameters are
+ */
+template<typename...>
+struct Void_Type {
+	typedef void type;
+};
+
+/**
+ * \class Is_Static_Graph
+ * \brief Tells at compile time whether a graph class provides the descriptor interface the algorithms are built on:
+ * - vertex_type, the type of the vertex data,
+ * - Vertex_Descriptor descriptor(const vertex_type &) const and value(Vertex_Descriptor) const,
+ * - unsigned indexBound() const, above all the descriptor indexes,
+ * - neighbors(Vertex_Descriptor) const, a forward range of Vertex_Descriptor.
+ * Adjacency_List, Adjacency_Matrix and Compressed_Sparse_Row model it. The algorithms are templates on the
+ * concrete class, so all those calls are resolved statically and can be inlined, unlike the AbstractGraph virtuals.
+ */
+template<typename Graph, typename Enable = void>
+struct Is_Static_Graph : public std::false_type {};
+
+template<typename Graph>
+struct Is_Static_Graph<Graph, typename Void_Type<
+		typename Graph::vertex_type,
+		decltype(std::declval<const Graph &>().descriptor(std::declval<const typename Graph::vertex_type &>())),
+		decltype(std::declval<const Graph &>().value(Vertex_Descriptor())),
+		decltype(std::declval<const Graph &>().indexBound()),
+		decltype(std::declval<const Graph &>().neighbors(Vertex_Descriptor()).begin())>::type> :
+	public std::integral_constant<bool, std::is_same<
+		typename std::decay<decltype(*std::declval<const Graph &>().neighbors(Vertex_Descriptor()).begin())>::type,
+		Vertex_Descriptor>::value> {};
+
+/**
+ * \brief Distance returned by shortestPathLengths for the vertices that can't be reached
+ */
+static const unsigned UNREACHABLE = ~0u;
+
+/**
+ * \brief Breadth-first traversal from a vertex, following the edges in their direction.
+ * \param[in] p_graph the graph
+ * \param[in] p_start the descriptor of the first vertex
+ * \param[in] p_visit functor called as p_visit(Vertex_Descriptor, unsigned depth) on each reached vertex,
+ * in breadth-first order (p_start first, with depth 0)
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename Graph, typename Visitor>
+void breadthFirstSearch(const Graph &p_graph, Vertex_Descriptor p_start, Visitor p_visit) {
+	static_assert(Is_Static_Graph<Graph>::value, "breadthFirstSearch: the graph doesn't provide the descriptor interface");
+	typedef typename Graph::adjacent_range Adjacents;
+	std::vector<bool> seen(p_graph.indexBound(), false);
+	std::deque<std::pair<Vertex_Descriptor, unsigned> > queue;
+
+	seen[p_start.index()] = true;
+	queue.push_back(std::make_pair(p_start, 0u));
+	while (!queue.empty()) {
+		Vertex_Descriptor v = queue.front().first;
+		unsigned depth = queue.front().second;
+		Adjacents adjacents = p_graph.neighbors(v);
+
+		queue.pop_front();
+		p_visit(v, depth);
+		for (typename Adjacents::iterator it = adjacents.begin(); it != adjacents.end(); ++it) {
+			if (!seen[(*it).index()]) {
+				seen[(*it).index()] = true;
+				queue.push_back(std::make_pair(*it, depth + 1));
+			}
+		}
+	}
+}
+
+/**
+ * \brief Depth-first traversal from a vertex, following the edges in their direction.
+ * Iterative (an explicit stack of neighbor iterators), so it doesn't overflow the call stack on long paths.
+ * \param[in] p_graph the graph
+ * \param[in] p_start the descriptor of the first vertex
+ * \param[in] p_visit functor called as p_visit(Vertex_Descriptor) on each reached vertex, in preorder
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename Graph, typename Visitor>
+void depthFirstSearch(const Graph &p_graph, Vertex_Descriptor p_start, Visitor p_visit) {
+	static_assert(Is_Static_Graph<Graph>::value, "depthFirstSearch: the graph doesn't provide the descriptor interface");
+	typedef typename Graph::adjacent_range Adjacents;
+	std::vector<bool> seen(p_graph.indexBound(), false);
+	std::vector<std::pair<typename Adjacents::iterator, typename Adjacents::iterator> > stack;
+	Adjacents adjacents = p_graph.neighbors(p_start);
+
+	seen[p_start.index()] = true;
+	p_visit(p_start);
+	stack.push_back(std::make_pair(adjacents.begin(), adjacents.end()));
+	while (!stack.empty()) {
+		if (stack.back().first == stack.back().second) {
+			stack.pop_back();
+			continue;
+		}
+		Vertex_Descriptor next = *stack.back().first;
+
+		++stack.back().first;
+		if (!seen[next.index()]) {
+			seen[next.index()] = true;
+			p_visit(next);
+			adjacents = p_graph.neighbors(next);
+			stack.push_back(std::make_pair(adjacents.begin(), adjacents.end()));
+		}
+	}
+}
+
+/**
+ * \brief Functor of shortestPathLengths: records the depth of each vertex
+ */
+class Depth_Recorder {
+public:
+	explicit Depth_Recorder(std::vector<unsigned> &p_lengths) : m_lengths(p_lengths) {}
+	void operator()(Vertex_Descriptor p_v, unsigned p_depth) const { m_lengths[p_v.index()] = p_depth; }
+
+private:
+	std::vector<unsigned> &m_lengths;
+};
+
+/**
+ * \brief Number of edges on the shortest paths from a vertex to all the others (unweighted graph)
+ * \param[in] p_graph the graph
+ * \param[in] p_start the descriptor of the source vertex
+ * \exception bad_alloc in case of insufficient memory
+ * \return the lengths, indexed by descriptor index, UNREACHABLE for the vertices with no path from p_start
+ */
+template<typename Graph>
+std::vector<unsigned> shortestPathLengths(const Graph &p_graph, Vertex_Descriptor p_start) {
+	std::vector<unsigned> lengths(p_graph.indexBound(), UNREACHABLE);
+
+	breadthFirstSearch(p_graph, p_start, Depth_Recorder(lengths));
+	return lengths;
+}
+
+} // namespace SGL
+
+#endif /* ALGORITHMS_H_ */
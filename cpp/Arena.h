@@ -0,0 +1,214 @@
+//! \file Arena.h
+//! \brief Pool arena for the per-vertex edge storage of the adjacency lists
+//! \version 0.1
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace SGL {
+
+/**
+ * \class Arena
+ * \brief Memory pool carving small blocks out of large slabs.
+ * The requests are rounded up to a power of two (MIN_BLOCK at least); a freed block goes to the free list of its
+ * size and is reused by the next request of that size, so the doubling of a growing vector recycles its old blocks.
+ * The blocks above MAX_BLOCK come from the global heap and go back to it when freed.
+ * The slabs are only freed all at once, by release() or by the destructor.
+ * An arena isn't thread-safe.
+ */
+class Arena {
+public:
+	static const std::size_t SLAB_SIZE = 1u << 20; /*!< bytes per slab */
+	static const std::size_t MIN_BLOCK = 16; /*!< smallest block, which keeps every block aligned on max_align_t */
+	static const std::size_t MAX_BLOCK = 1u << 16; /*!< biggest block taken from the slabs */
+
+	Arena() : m_current(NULL), m_left(0) {
+		for (unsigned i = 0; i < NB_CLASSES; i++) {
+			m_freeLists[i] = NULL;
+		}
+	}
+	~Arena() { release(); }
+
+	/**
+	 * \brief Returns a block of at least p_bytes bytes, aligned on max_align_t
+	 * \exception bad_alloc in case of insufficient memory
+	 */
+	void *allocate(std::size_t p_bytes) {
+		if (p_bytes > MAX_BLOCK) {
+			return ::operator new(p_bytes);
+		}
+		unsigned sizeClass = _class(p_bytes);
+		std::size_t size = MIN_BLOCK << sizeClass;
+		Block *block = m_freeLists[sizeClass];
+
+		if (block != NULL) {
+			m_freeLists[sizeClass] = block->m_next;
+			return block;
+		}
+		if (m_left < size) { // the end of the current slab is left unused
+			m_slabs.reserve(m_slabs.size() + 1);
+			m_current = static_cast<char *>(::operator new(SLAB_SIZE));
+			m_slabs.push_back(m_current);
+			m_left = SLAB_SIZE;
+		}
+		block = reinterpret_cast<Block *>(m_current);
+		m_current += size;
+		m_left -= size;
+		return block;
+	}
+
+	/**
+	 * \brief Gives a block back to the arena
+	 * \pre p_ptr was returned by allocate(p_bytes), with the same p_bytes
+	 */
+	void deallocate(void *p_ptr, std::size_t p_bytes) {
+		if (p_bytes > MAX_BLOCK) {
+			::operator delete(p_ptr);
+			return;
+		}
+		unsigned sizeClass = _class(p_bytes);
+		Block *block = static_cast<Block *>(p_ptr);
+
+		block->m_next = m_freeLists[sizeClass];
+		m_freeLists[sizeClass] = block;
+	}
+
+	/**
+	 * \brief Frees all the slabs in one go
+	 * \pre no block of the slabs is in use anymore
+	 */
+	void release() {
+		for (unsigned i = 0; i < m_slabs.size(); i++) {
+			::operator delete(m_slabs[i]);
+		}
+		std::vector<char *>().swap(m_slabs);
+		m_current = NULL;
+		m_left = 0;
+		for (unsigned i = 0; i < NB_CLASSES; i++) {
+			m_freeLists[i] = NULL;
+		}
+	}
+
+	/**
+	 * \brief Number of bytes held in slabs
+	 */
+	inline std::size_t capacity() const { return m_slabs.size() * SLAB_SIZE; }
+
+private:
+	static const unsigned NB_CLASSES = 13; /*!< MIN_BLOCK << (NB_CLASSES - 1) == MAX_BLOCK */
+
+	struct Block {
+		Block *m_next;
+	};
+
+	Arena(const Arena &);
+	Arena &operator=(const Arena &);
+
+	static unsigned _class(std::size_t p_bytes) {
+		unsigned sizeClass = 0;
+
+		while ((MIN_BLOCK << sizeClass) < p_bytes) {
+			sizeClass++;
+		}
+		return sizeClass;
+	}
+
+	std::vector<char *> m_slabs; /*!< all the slabs */
+	char *m_current; /*!< the free part of the last slab */
+	std::size_t m_left; /*!< bytes left after m_current */
+	Block *m_freeLists[NB_CLASSES]; /*!< the freed blocks of each size */
+};
+
+/**
+ * \class Arena_Allocator
+ * \brief Standard allocator drawing from an Arena, which must outlive the containers using it.
+ * Two allocators are equal when they share the same arena. There's no default constructor: the arena is always given.
+ */
+template<typename U>
+class Arena_Allocator {
+public:
+	typedef U value_type;
+
+	explicit Arena_Allocator(Arena *p_arena) : m_arena(p_arena) {}
+	template<typename V>
+	Arena_Allocator(const Arena_Allocator<V> &p_src) : m_arena(p_src.arena()) {}
+
+	U *allocate(std::size_t p_nb) {
+		static_assert(alignof(U) <= Arena::MIN_BLOCK, "Arena_Allocator: the type is over-aligned");
+		return static_cast<U *>(m_arena->allocate(p_nb * sizeof(U)));
+	}
+	void deallocate(U *p_ptr, std::size_t p_nb) { m_arena->deallocate(p_ptr, p_nb * sizeof(U)); }
+
+	inline Arena *arena() const { return m_arena; }
+
+	template<typename V>
+	bool operator==(const Arena_Allocator<V> &p_rhs) const { return m_arena == p_rhs.arena(); }
+	template<typename V>
+	bool operator!=(const Arena_Allocator<V> &p_rhs) const { return m_arena != p_rhs.arena(); }
+
+private:
+	Arena *m_arena;
+};
+
+/**
+ * \class Allocator_Source
+ * \brief Owned by a graph, gives the allocator instance of its containers.
+ * A standard allocator is default-constructed, and is supposed to be usable from several threads at once
+ * (isConcurrent), like std::allocator.
+ */
+template<typename A>
+class Allocator_Source {
+public:
+	static const bool isConcurrent = true;
+
+	inline A get() const { return A(); }
+	void reset() {}
+	void swap(Allocator_Source &) noexcept {}
+};
+
+/**
+ * \brief An Arena_Allocator comes with its own arena, freed with the source.
+ * The arena is on the heap, so that it stays in place when two sources are swapped. It's only created by the first
+ * get(), so that an empty source (e.g. the one of a moved-from graph) costs no allocation.
+ */
+template<typename U>
+class Allocator_Source<Arena_Allocator<U> > {
+public:
+	static const bool isConcurrent = false;
+
+	Allocator_Source() noexcept {}
+
+	/**
+	 * \exception bad_alloc in case of insufficient memory (for the arena itself, on the first call)
+	 */
+	inline Arena_Allocator<U> get() const {
+		if (!m_arena) {
+			m_arena.reset(new Arena());
+		}
+		return Arena_Allocator<U>(m_arena.get());
+	}
+	inline const Arena &arena() const { return *get().arena(); }
+
+	/**
+	 * \brief Frees the whole arena
+	 * \pre no container uses it anymore
+	 */
+	void reset() {
+		if (m_arena) {
+			m_arena->release();
+		}
+	}
+	void swap(Allocator_Source &p_other) noexcept { m_arena.swap(p_other.m_arena); }
+
+private:
+	mutable std::unique_ptr<Arena> m_arena; /*!< null until the first get() */
+};
+
+} // namespace SGL
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,210 @@
+//! \file BitOperations.h
+//! \brief Word-level bit manipulation helpers used by the bit-packed graph storages
+//! \version 0.1
+
+#ifndef BITOPERATIONS_H_
+#define BITOPERATIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+#if defined(__AVX2__)
+# include <immintrin.h>
+#endif
+
+namespace SGL {
+
+/**
+ * \brief Number of bits in a storage word of the bit-packed matrices
+ */
+static const unsigned WORD_BITS = 64;
+
+/**
+ * \brief Number of words needed to hold a given number of bits
+ * \param[in] p_bits the number of bits
+ * \return the number of 64-bit words
+ */
+inline std::size_t wordsFor(std::size_t p_bits) {
+	return (p_bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+/**
+ * \brief Counts the bits set in a word (hardware popcount when the compiler provides it)
+ * \param[in] p_w the word
+ * \return the number of bits set to 1
+ */
+inline unsigned popCount(uint64_t p_w) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(p_w);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return static_cast<unsigned>(__popcnt64(p_w));
+#else
+	p_w = p_w - ((p_w >> 1) & 0x5555555555555555ULL);
+	p_w = (p_w & 0x3333333333333333ULL) + ((p_w >> 2) & 0x3333333333333333ULL);
+	p_w = (p_w + (p_w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return static_cast<unsigned>((p_w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * \brief Counts the bits set in a contiguous run of words.
+ * Uses an AVX2 nibble-lookup kernel when available, or the word popcount otherwise.
+ * \param[in] p_words the first word
+ * \param[in] p_nb the number of words
+ * \return the number of bits set to 1
+ */
+inline std::size_t popCount(const uint64_t *p_words, std::size_t p_nb) {
+	std::size_t count = 0;
+	std::size_t i = 0;
+
+#if defined(__AVX2__)
+	const __m256i lookup = _mm256_setr_epi8(
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+	__m256i acc = _mm256_setzero_si256();
+
+	for (; i + 4 <= p_nb; i += 4) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p_words + i));
+		__m256i lo = _mm256_and_si256(v, nibbleMask);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibbleMask);
+		__m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+
+		acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+	}
+	count += static_cast<std::size_t>(_mm256_extract_epi64(acc, 0)) + static_cast<std::size_t>(_mm256_extract_epi64(acc, 1))
+			+ static_cast<std::size_t>(_mm256_extract_epi64(acc, 2)) + static_cast<std::size_t>(_mm256_extract_epi64(acc, 3));
+#endif
+	for (; i < p_nb; i++) {
+		count += popCount(p_words[i]);
+	}
+	return count;
+}
+
+/**
+ * \brief Index of the lowest bit set in a word (find-first-set)
+ * \pre p_w != 0
+ * \param[in] p_w the word
+ * \return the index (0..63) of the lowest bit set
+ */
+inline unsigned lowestBit(uint64_t p_w) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(p_w);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long idx;
+
+	_BitScanForward64(&idx, p_w);
+	return static_cast<unsigned>(idx);
+#else
+	unsigned idx = 0;
+
+	while ((p_w & 1) == 0) {
+		p_w >>= 1;
+		idx++;
+	}
+	return idx;
+#endif
+}
+
+/**
+ * \brief Mask of the bits strictly below a position
+ * \param[in] p_bit a bit position (0..64)
+ * \return a word with the bits [0, p_bit) set
+ */
+inline uint64_t lowMask(unsigned p_bit) {
+	return (p_bit >= WORD_BITS) ? ~0ULL : ((1ULL << p_bit) - 1);
+}
+
+/**
+ * \brief Reads up to 64 consecutive bits starting at any bit position of a word array
+ * \param[in] p_words the word array
+ * \param[in] p_pos the position of the first bit
+ * \param[in] p_len the number of bits to read (1..64)
+ * \return the bits, in the low bits of the returned word
+ */
+inline uint64_t readBits(const uint64_t *p_words, std::size_t p_pos, unsigned p_len) {
+	std::size_t word = p_pos / WORD_BITS;
+	unsigned shift = p_pos % WORD_BITS;
+	uint64_t bits = p_words[word] >> shift;
+
+	if (shift != 0 && shift + p_len > WORD_BITS) {
+		bits |= p_words[word + 1] << (WORD_BITS - shift);
+	}
+	return bits & lowMask(p_len);
+}
+
+/**
+ * \brief Overwrites up to 64 consecutive bits starting at any bit position of a word array
+ * \param[in,out] p_words the word array
+ * \param[in] p_pos the position of the first bit
+ * \param[in] p_len the number of bits to write (1..64)
+ * \param[in] p_bits the bits to write, in the low bits of the word
+ */
+inline void writeBits(uint64_t *p_words, std::size_t p_pos, unsigned p_len, uint64_t p_bits) {
+	std::size_t word = p_pos / WORD_BITS;
+	unsigned shift = p_pos % WORD_BITS;
+	uint64_t mask = lowMask(p_len);
+
+	p_bits &= mask;
+	p_words[word] = (p_words[word] & ~(mask << shift)) | (p_bits << shift);
+	if (shift != 0 && shift + p_len > WORD_BITS) {
+		unsigned written = WORD_BITS - shift;
+
+		p_words[word + 1] = (p_words[word + 1] & ~(mask >> written)) | (p_bits >> written);
+	}
+}
+
+/**
+ * \brief Copies a run of bits between two arbitrary bit positions, 64 bits at a time
+ * \param[in,out] p_dest the destination word array
+ * \param[in] p_destPos the position of the first destination bit
+ * \param[in] p_src the source word array
+ * \param[in] p_srcPos the position of the first source bit
+ * \param[in] p_len the number of bits to copy
+ */
+inline void copyBits(uint64_t *p_dest, std::size_t p_destPos, const uint64_t *p_src, std::size_t p_srcPos, std::size_t p_len) {
+	while (p_len > 0) {
+		unsigned chunk = (p_len < WORD_BITS) ? static_cast<unsigned>(p_len) : WORD_BITS;
+
+		writeBits(p_dest, p_destPos, chunk, readBits(p_src, p_srcPos, chunk));
+		p_destPos += chunk;
+		p_srcPos += chunk;
+		p_len -= chunk;
+	}
+}
+
+/**
+ * \brief Counts the bits set in a run of bits starting at any bit position
+ * \param[in] p_words the word array
+ * \param[in] p_pos the position of the first bit
+ * \param[in] p_len the number of bits to count
+ * \return the number of bits set to 1 in [p_pos, p_pos + p_len)
+ */
+inline std::size_t popCount(const uint64_t *p_words, std::size_t p_pos, std::size_t p_len) {
+	std::size_t count = 0;
+	unsigned head = p_pos % WORD_BITS;
+
+	if (p_len == 0) {
+		return 0;
+	}
+	if (head != 0) {
+		unsigned chunk = (p_len < WORD_BITS - head) ? static_cast<unsigned>(p_len) : WORD_BITS - head;
+
+		count += popCount(readBits(p_words, p_pos, chunk));
+		p_pos += chunk;
+		p_len -= chunk;
+	}
+	// p_pos is now word-aligned
+	count += popCount(p_words + p_pos / WORD_BITS, p_len / WORD_BITS);
+	if (p_len % WORD_BITS != 0) {
+		count += popCount(p_words[(p_pos + p_len) / WORD_BITS] & lowMask(p_len % WORD_BITS));
+	}
+	return count;
+}
+
+} // namespace SGL
+
+#endif /* BITOPERATIONS_H_ */
@@ -0,0 +1,196 @@
+//! \file CompressedGraph.h
+//! \brief Declaration of a read-only graph storing its adjacency lists as gap-encoded varints
+//! \version 0.1
+
+#ifndef COMPRESSEDGRAPH_H_
+#define COMPRESSEDGRAPH_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#endif
+
+#include "ReadOnlyGraph.h"
+#include "VertexIndex.h"
+#include "Fingerprint.h"
+#include "Range.h"
+#include "AdjacencyList.h"
+#include "AdjacencyMatrix.h"
+#include "CompressedSparseRow.h"
+#include "Parallel.h"
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \class Compressed_Graph
+ * \brief Read-only graph whose adjacency lists are compressed in a single byte stream, decoded on the fly.
+ * Each sorted adjacency list is written as:
+ * - its length,
+ * - its intervals: the runs of at least MIN_INTERVAL consecutive indexes, as (start, length) pairs, the first start
+ *   relative to the vertex itself and the next ones to the end of the previous run,
+ * - its residuals: the other neighbors, the first relative to the vertex itself, then as gaps to the previous one,
+ * all of them as LEB128 varints (7 bits per byte), the signed ones zigzag-encoded. With the locality of crawled or
+ * generated graphs most of the gaps fit in one byte, and the runs of consecutive neighbors cost two varints.
+ * A per-vertex offset gives the start of each list, so the degrees and the neighbors are found in O(1).
+ * neighbors() decodes the list lazily; neighborIndexes() decodes a whole list at once, 8 one-byte gaps at a time
+ * where it can (16 with AVX2). hasEdge is a linear scan of the list, stopped at the first greater index.
+ * It has the interface of a Compressed_Sparse_Row (same numbering of the vertices, same degrees), and is built from
+ * one of the graphs or directly by Graph_Builder::build (hence Graph_Loader), without an intermediate graph.
+ * All the mutators throw a logic_error.
+ */
+template<typename T>
+class Compressed_Graph : public Read_Only_Graph<T, Compressed_Graph<T> > {
+	class AdjacentCursor;
+
+public:
+	typedef Range<Range_Iterator<AdjacentCursor> > adjacent_range; /*!< lazy range of Vertex_Descriptor */
+
+	static const unsigned MIN_INTERVAL = 4; /*!< shortest run of consecutive neighbors stored as an interval */
+
+	////////////////////////////////////////////////////////////////
+	// Coplien Form
+	////////////////////////////////////////////////////////////////
+	Compressed_Graph(configuration p_f = 0);
+	explicit Compressed_Graph(const Compressed_Sparse_Row<T> &);
+	template<typename Direction, typename Weighting, typename Allocator>
+	explicit Compressed_Graph(const Adjacency_List<T, Direction, Weighting, Allocator> &);
+	template<typename Direction, typename Weighting>
+	explicit Compressed_Graph(const Adjacency_Matrix<T, Direction, Weighting> &);
+	Compressed_Graph(const Compressed_Graph &) = default;
+	Compressed_Graph(Compressed_Graph &&) noexcept;
+	~Compressed_Graph() {}
+	Compressed_Graph &operator=(const Compressed_Graph &) = default;
+	Compressed_Graph &operator=(Compressed_Graph &&) noexcept;
+
+	////////////////////////////////////////////////////////////////
+	// Getters (const)
+	////////////////////////////////////////////////////////////////
+	using Read_Only_Graph<T, Compressed_Graph>::hasConfiguration;
+	using Read_Only_Graph<T, Compressed_Graph>::hasEdge;
+
+	/**
+	 * \brief Size of the compressed adjacency lists, in bytes (the offsets, the vertices and their index aside)
+	 */
+	inline std::size_t encodedSize() const { return m_bytes.size(); }
+
+	std::vector<T> vertexNeighborhood(const T&, bool p_closed = false) const;
+	std::vector<T> vertices() const;
+	std::vector<std::pair<T, T> > edges() const;
+	uint64_t fingerprint() const;
+
+	////////////////////////////////////////////////////////////////
+	// Vertex descriptors: no vertex lookup
+	////////////////////////////////////////////////////////////////
+	/**
+	 * \brief Returns the data of a vertex from its descriptor
+	 * \pre p_vd is a valid descriptor of this graph
+	 */
+	inline const T &value(Vertex_Descriptor p_vd) const { return m_elems[p_vd.index()]; }
+
+	/**
+	 * \brief Upper bound of the indexes of the descriptors, to size per-vertex arrays
+	 */
+	inline unsigned indexBound() const { return m_elems.size(); }
+
+	bool hasEdge(Vertex_Descriptor, Vertex_Descriptor) const;
+	unsigned inDegree(Vertex_Descriptor) const;
+	unsigned outDegree(Vertex_Descriptor) const;
+	adjacent_range neighbors(Vertex_Descriptor) const;
+	void neighborIndexes(Vertex_Descriptor, std::vector<unsigned> &) const;
+
+	////////////////////////////////////////////////////////////////
+	// Setters (mutators): the graph is immutable, they all throw
+	////////////////////////////////////////////////////////////////
+	void addVertex(const T &);
+	void deleteVertex(const T &);
+	void addEdge(const T&, const T&);
+	void deleteEdge(const T&, const T&);
+
+	friend class Read_Only_Graph<T, Compressed_Graph>;
+	template<typename> friend class Graph_Builder;
+
+private:
+	static const unsigned CHUNK_SIZE = 1u << 12; /*!< vertices per task of the parallel encoding */
+
+	/**
+	 * \class AdjacentCursor
+	 * \brief Decodes an adjacency list one neighbor at a time, merging its intervals and its residuals.
+	 * Two cursors are equal when they have as many neighbors left: enough to find the end of their range.
+	 */
+	class AdjacentCursor {
+	public:
+		typedef Vertex_Descriptor value_type;
+		typedef Vertex_Descriptor reference;
+
+		AdjacentCursor() : m_left(0) {}
+		AdjacentCursor(const uint8_t *p_row, unsigned p_vertex);
+
+		reference get() const { return Vertex_Descriptor(m_current); }
+		void next();
+		bool operator==(const AdjacentCursor &p_rhs) const { return m_left == p_rhs.m_left; }
+
+	private:
+		void _take();
+
+		unsigned m_left; /*!< neighbors left, the current one included (0 at the end) */
+		unsigned m_current;
+		const uint8_t *m_intervals; /*!< next interval to decode */
+		unsigned m_intervalsLeft; /*!< intervals not decoded yet */
+		uint64_t m_runNext; /*!< next index of the current interval */
+		uint64_t m_runEnd; /*!< end of the current interval (m_runNext == m_runEnd: no more interval) */
+		const uint8_t *m_residuals; /*!< next residual to decode */
+		unsigned m_residualsLeft; /*!< residuals not decoded yet */
+		uint64_t m_residual; /*!< next residual (~0 if none left) */
+	};
+
+	std::vector<T> m_elems; /*!< the vertices, in index order */
+	std::vector<uint64_t> m_offsets; /*!< nbVertices + 1 offsets in m_bytes, none once moved from */
+	std::vector<uint8_t> m_bytes; /*!< all the encoded adjacency lists one after the other */
+	std::vector<unsigned> m_inDegrees; /*!< in-degree of each vertex (loops not doubled) */
+	unsigned m_nbEdges;
+	Vertex_Index<T> m_index; /*!< vertex data -> index */
+	mutable Graph_Fingerprint<T> m_fingerprint; /*!< computed on the first request */
+
+	void _swap(Compressed_Graph &) noexcept;
+	void _encode(const std::vector<unsigned> &p_offsets, const std::vector<unsigned> &p_neighbors, unsigned p_nbThreads);
+	static void _encodeRow(const unsigned *p_begin, const unsigned *p_end, unsigned p_vertex, std::vector<uint8_t> &);
+	void _indexVertices();
+	inline const uint8_t *_row(unsigned p_idx) const { return m_bytes.data() + m_offsets[p_idx]; }
+
+	static void _putVarint(std::vector<uint8_t> &p_bytes, uint64_t p_value) {
+		while (p_value >= 0x80) {
+			p_bytes.push_back(static_cast<uint8_t>(p_value | 0x80));
+			p_value >>= 7;
+		}
+		p_bytes.push_back(static_cast<uint8_t>(p_value));
+	}
+	static uint64_t _getVarint(const uint8_t *&p_pos) {
+		uint64_t value = *p_pos & 0x7F;
+		unsigned shift = 7;
+
+		while (*p_pos++ & 0x80) {
+			value |= static_cast<uint64_t>(*p_pos & 0x7F) << shift;
+			shift += 7;
+		}
+		return value;
+	}
+	static uint64_t _zigzag(int64_t p_value) { return (static_cast<uint64_t>(p_value) << 1) ^ static_cast<uint64_t>(p_value >> 63); }
+	static int64_t _unzigzag(uint64_t p_value) { return static_cast<int64_t>(p_value >> 1) ^ -static_cast<int64_t>(p_value & 1); }
+#if defined(__AVX2__)
+	static unsigned _addGaps(__m128i p_gaps, unsigned p_last, unsigned *p_out);
+#endif
+
+	using Read_Only_Graph<T, Compressed_Graph>::_index;
+
+	bool _isLoop(unsigned) const;
+};
+
+}
+
+#include "CompressedGraph.hpp"
+
+#endif /* COMPRESSEDGRAPH_H_ */
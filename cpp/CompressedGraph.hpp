@@ -0,0 +1,541 @@
+//! \file CompressedGraph.hpp
+//! \brief Implementation of the read-only graph with gap-encoded adjacency lists
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm> // std::min
+
+using namespace std;
+
+namespace SGL {
+
+template<typename T>
+const unsigned Compressed_Graph<T>::MIN_INTERVAL;
+
+template<typename T>
+const unsigned Compressed_Graph<T>::CHUNK_SIZE;
+
+/**
+ * \brief Constructor of an empty graph
+ * \param[in] p_f the configuration flags of the graph
+ */
+template<typename T>
+Compressed_Graph<T>::Compressed_Graph(configuration p_f) :
+		m_offsets(1, 0), m_nbEdges(0) {
+	this->m_config = p_f;
+	this->m_nbVertices = 0;
+}
+
+/**
+ * \brief Compresses a compressed sparse row graph, in O(V+E): same vertices, in the same order
+ * \param[in] p_src the graph to compress
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+Compressed_Graph<T>::Compressed_Graph(const Compressed_Sparse_Row<T> &p_src) :
+		m_elems(p_src.m_elems), m_inDegrees(p_src.m_inDegrees), m_nbEdges(0) {
+	this->m_config = p_src.getConfiguration();
+	_encode(p_src.m_offsets, p_src.m_neighbors, 1);
+	_indexVertices();
+}
+
+/**
+ * \brief Compresses a snapshot of an adjacency list (through a Compressed_Sparse_Row, which sorts the lists)
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+template<typename Direction, typename Weighting, typename Allocator>
+Compressed_Graph<T>::Compressed_Graph(const Adjacency_List<T, Direction, Weighting, Allocator> &p_src) :
+		Compressed_Graph(Compressed_Sparse_Row<T>(p_src)) {
+}
+
+/**
+ * \brief Compresses a snapshot of an adjacency matrix (through a Compressed_Sparse_Row)
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+template<typename Direction, typename Weighting>
+Compressed_Graph<T>::Compressed_Graph(const Adjacency_Matrix<T, Direction, Weighting> &p_src) :
+		Compressed_Graph(Compressed_Sparse_Row<T>(p_src)) {
+}
+
+/**
+ * \brief Move constructor: takes the arrays of the source without copying them, and allocates nothing
+ * \post The source is an empty graph with the same configuration
+ */
+template<typename T>
+Compressed_Graph<T>::Compressed_Graph(Compressed_Graph<T> &&p_src) noexcept :
+		m_nbEdges(0) {
+	this->m_config = p_src.m_config;
+	this->m_nbVertices = 0;
+	_swap(p_src);
+}
+
+/**
+ * \brief Move assignment: the previous arrays are freed, the source is left empty
+ */
+template<typename T>
+Compressed_Graph<T> &Compressed_Graph<T>::operator=(Compressed_Graph<T> &&p_src) noexcept {
+	Compressed_Graph<T> moved(std::move(p_src));
+
+	_swap(moved);
+	return (*this);
+}
+
+template<typename T>
+void Compressed_Graph<T>::_swap(Compressed_Graph<T> &p_other) noexcept {
+	std::swap(this->m_config, p_other.m_config);
+	std::swap(this->m_nbVertices, p_other.m_nbVertices);
+	m_elems.swap(p_other.m_elems);
+	m_offsets.swap(p_other.m_offsets);
+	m_bytes.swap(p_other.m_bytes);
+	m_inDegrees.swap(p_other.m_inDegrees);
+	std::swap(m_nbEdges, p_other.m_nbEdges);
+	std::swap(m_index, p_other.m_index);
+	std::swap(m_fingerprint, p_other.m_fingerprint);
+}
+
+template<typename T>
+std::vector<T> Compressed_Graph<T>::vertexNeighborhood(const T &p_v, bool p_closed) const {
+	unsigned v_idx = _index(p_v); // throws logic error if the elem's not in the graph
+	vector<unsigned> indexes;
+	vector<T> neighbors;
+
+	neighborIndexes(Vertex_Descriptor(v_idx), indexes);
+	neighbors.reserve(indexes.size() + 1);
+	for (unsigned pos = 0; pos < indexes.size(); pos++) {
+		neighbors.push_back(m_elems[indexes[pos]]);
+	}
+	if (p_closed && !std::binary_search(indexes.begin(), indexes.end(), v_idx)) {
+		neighbors.push_back(m_elems[v_idx]);
+	}
+	return neighbors;
+}
+
+template<typename T>
+std::vector<T> Compressed_Graph<T>::vertices() const {
+	return m_elems;
+}
+
+template<typename T>
+std::vector<std::pair<T, T> > Compressed_Graph<T>::edges() const {
+	vector<pair<T, T> > edges;
+
+	edges.reserve(m_nbEdges);
+	for (unsigned src = 0; src < m_elems.size(); src++) {
+		adjacent_range adjacents = neighbors(Vertex_Descriptor(src));
+
+		for (typename adjacent_range::iterator it = adjacents.begin(); it != adjacents.end(); ++it) {
+			// in an undirected graph, only list each edge once (from its greatest vertex index)
+			if (hasConfiguration(UNDIRECTED) && (*it).index() > src) {
+				break;
+			}
+			edges.push_back(make_pair(m_elems[src], m_elems[(*it).index()]));
+		}
+	}
+	return edges;
+}
+
+/**
+ * \brief Order-independent hash of the vertices and edges, the same as any equal graph of the other classes.
+ * Computed in O(V+E) on the first call, O(1) afterwards.
+ */
+template<typename T>
+uint64_t Compressed_Graph<T>::fingerprint() const {
+	if (!m_fingerprint.isValid()) {
+		const bool undirected = hasConfiguration(UNDIRECTED);
+
+		m_fingerprint.reset();
+		for (unsigned src = 0; src < m_elems.size(); src++) {
+			adjacent_range adjacents = neighbors(Vertex_Descriptor(src));
+
+			m_fingerprint.addVertex(m_elems[src]);
+			for (typename adjacent_range::iterator it = adjacents.begin(); it != adjacents.end(); ++it) {
+				// both directions of an undirected edge are stored: take it from its greatest vertex index
+				if (undirected && (*it).index() > src) {
+					break;
+				}
+				m_fingerprint.addEdge(m_elems[src], m_elems[(*it).index()], undirected);
+			}
+		}
+	}
+	return m_fingerprint.value();
+}
+
+/**
+ * \brief Decodes the adjacency list of p_src up to the first index not below p_dest, in O(out-degree)
+ * \pre the descriptors are valid descriptors of this graph (they aren't checked)
+ */
+template<typename T>
+bool Compressed_Graph<T>::hasEdge(Vertex_Descriptor p_src, Vertex_Descriptor p_dest) const {
+	adjacent_range adjacents = neighbors(p_src);
+
+	for (typename adjacent_range::iterator it = adjacents.begin(); it != adjacents.end(); ++it) {
+		if ((*it).index() >= p_dest.index()) {
+			return ((*it).index() == p_dest.index());
+		}
+	}
+	return false;
+}
+
+template<typename T>
+unsigned Compressed_Graph<T>::inDegree(Vertex_Descriptor p_vd) const {
+	unsigned v_idx = p_vd.index();
+	unsigned inDeg = m_inDegrees[v_idx];
+
+	// if the graph is undirected: a loop counts twice
+	if (hasConfiguration(UNDIRECTED) && _isLoop(v_idx)) {
+		inDeg++;
+	}
+	return inDeg;
+}
+
+template<typename T>
+unsigned Compressed_Graph<T>::outDegree(Vertex_Descriptor p_vd) const {
+	const uint8_t *row = _row(p_vd.index());
+	unsigned outDeg = _getVarint(row); // the length of the list comes first
+
+	// if the graph is undirected: a loop counts twice
+	if (hasConfiguration(UNDIRECTED) && _isLoop(p_vd.index())) {
+		outDeg++;
+	}
+	return outDeg;
+}
+
+/**
+ * \brief Lazy range over the descriptors of the neighbors of a vertex, in index order, decoded as it goes
+ */
+template<typename T>
+typename Compressed_Graph<T>::adjacent_range Compressed_Graph<T>::neighbors(Vertex_Descriptor p_vd) const {
+	return adjacent_range(Range_Iterator<AdjacentCursor>(AdjacentCursor(_row(p_vd.index()), p_vd.index())),
+			Range_Iterator<AdjacentCursor>(AdjacentCursor()));
+}
+
+/**
+ * \brief Decodes the whole adjacency list of a vertex at once: faster than neighbors() to read every neighbor.
+ * The residuals are decoded first: while 8 of them are left, the next 8 bytes are read as one word, and if none of
+ * them has its continuation bit, they are 8 one-byte gaps, added up without testing each byte.
+ * The intervals are merged in afterwards, from the end of the list.
+ * \param[in] p_vd a valid descriptor of this graph
+ * \param[out] p_indexes the indexes of the neighbors, in increasing order (its previous content is lost)
+ */
+template<typename T>
+void Compressed_Graph<T>::neighborIndexes(Vertex_Descriptor p_vd, std::vector<unsigned> &p_indexes) const {
+	const uint64_t CONTINUATION_BITS = 0x8080808080808080ull;
+	const unsigned v_idx = p_vd.index();
+	const uint8_t *pos = _row(v_idx);
+	const unsigned degree = _getVarint(pos);
+	vector<pair<unsigned, unsigned> > intervals;
+	unsigned nbResiduals = degree;
+
+	p_indexes.clear();
+	if (degree == 0) {
+		return;
+	}
+	intervals.resize(_getVarint(pos));
+	for (unsigned i = 0; i < intervals.size(); i++) {
+		if (i == 0) {
+			intervals[i].first = static_cast<unsigned>(_unzigzag(_getVarint(pos)) + v_idx);
+		} else {
+			intervals[i].first = static_cast<unsigned>(intervals[i - 1].second + 1 + _getVarint(pos));
+		}
+		intervals[i].second = intervals[i].first + MIN_INTERVAL + _getVarint(pos);
+		nbResiduals -= intervals[i].second - intervals[i].first;
+	}
+	p_indexes.reserve(degree);
+	if (nbResiduals > 0) {
+		uint64_t last = _unzigzag(_getVarint(pos)) + v_idx;
+		unsigned left = nbResiduals - 1;
+
+		p_indexes.push_back(static_cast<unsigned>(last));
+		while (left >= 8) {
+			uint64_t word;
+
+#if defined(__AVX2__)
+			if (left >= 16) {
+				// 16 varints left: at least 16 bytes of this list
+				__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+
+				if (_mm_movemask_epi8(bytes) == 0) {
+					std::size_t out = p_indexes.size();
+
+					p_indexes.resize(out + 16);
+					last = _addGaps(bytes, static_cast<unsigned>(last), &p_indexes[out]);
+					last = _addGaps(_mm_srli_si128(bytes, 8), static_cast<unsigned>(last), &p_indexes[out + 8]);
+					pos += 16;
+					left -= 16;
+					continue;
+				}
+			}
+#endif
+			std::memcpy(&word, pos, sizeof(word)); // 8 varints left: at least 8 bytes of this list
+			if ((word & CONTINUATION_BITS) == 0) {
+				for (unsigned b = 0; b < 8; b++) {
+					last += 1 + pos[b];
+					p_indexes.push_back(static_cast<unsigned>(last));
+				}
+				pos += 8;
+				left -= 8;
+			} else {
+				last += 1 + _getVarint(pos);
+				p_indexes.push_back(static_cast<unsigned>(last));
+				left--;
+			}
+		}
+		for (; left > 0; left--) {
+			last += 1 + _getVarint(pos);
+			p_indexes.push_back(static_cast<unsigned>(last));
+		}
+	}
+	if (!intervals.empty()) {
+		// merge the intervals in from the end, so each index moves once
+		unsigned residual = p_indexes.size();
+		unsigned out = degree;
+
+		p_indexes.resize(degree);
+		for (unsigned i = intervals.size(); i-- > 0;) {
+			while (residual > 0 && p_indexes[residual - 1] > intervals[i].first) {
+				p_indexes[--out] = p_indexes[--residual];
+			}
+			for (unsigned idx = intervals[i].second; idx-- > intervals[i].first;) {
+				p_indexes[--out] = idx;
+			}
+		}
+	}
+}
+
+template<typename T>
+void Compressed_Graph<T>::addVertex(const T &) {
+	throw logic_error("addVertex: the graph is immutable");
+}
+
+template<typename T>
+void Compressed_Graph<T>::deleteVertex(const T &) {
+	throw logic_error("deleteVertex: the graph is immutable");
+}
+
+template<typename T>
+void Compressed_Graph<T>::addEdge(const T &, const T &) {
+	throw logic_error("addEdge: the graph is immutable");
+}
+
+template<typename T>
+void Compressed_Graph<T>::deleteEdge(const T &, const T &) {
+	throw logic_error("deleteEdge: the graph is immutable");
+}
+
+/**
+ * \brief Starts on the first neighbor of a list
+ * \param[in] p_row the encoded list
+ * \param[in] p_vertex the index of the vertex owning the list (the first values are relative to it)
+ */
+template<typename T>
+Compressed_Graph<T>::AdjacentCursor::AdjacentCursor(const uint8_t *p_row, unsigned p_vertex) :
+		m_left(_getVarint(p_row)), m_current(0), m_intervals(p_row), m_intervalsLeft(0), m_runNext(0), m_runEnd(0),
+		m_residuals(p_row), m_residualsLeft(0), m_residual(~0ull) {
+	if (m_left == 0) {
+		return;
+	}
+	const unsigned nbIntervals = _getVarint(m_residuals);
+	unsigned inIntervals = 0;
+
+	// the residuals come after the intervals: skip them, adding up their lengths
+	m_intervals = m_residuals;
+	for (unsigned i = 0; i < nbIntervals; i++) {
+		_getVarint(m_residuals);
+		inIntervals += MIN_INTERVAL + _getVarint(m_residuals);
+	}
+	if (nbIntervals > 0) {
+		m_runNext = _unzigzag(_getVarint(m_intervals)) + p_vertex;
+		m_runEnd = m_runNext + MIN_INTERVAL + _getVarint(m_intervals);
+		m_intervalsLeft = nbIntervals - 1;
+	}
+	m_residualsLeft = m_left - inIntervals;
+	if (m_residualsLeft > 0) {
+		m_residual = _unzigzag(_getVarint(m_residuals)) + p_vertex;
+		m_residualsLeft--;
+	}
+	_take();
+}
+
+template<typename T>
+void Compressed_Graph<T>::AdjacentCursor::next() {
+	if (--m_left > 0) {
+		_take();
+	}
+}
+
+/**
+ * \brief Makes the smallest of the next interval index and the next residual the current neighbor, and decodes
+ * the next interval or residual if it was the last of its kind
+ */
+template<typename T>
+void Compressed_Graph<T>::AdjacentCursor::_take() {
+	if (m_runNext != m_runEnd && m_runNext < m_residual) {
+		m_current = static_cast<unsigned>(m_runNext++);
+		if (m_runNext == m_runEnd && m_intervalsLeft > 0) {
+			m_runNext = m_runEnd + 1 + _getVarint(m_intervals);
+			m_runEnd = m_runNext + MIN_INTERVAL + _getVarint(m_intervals);
+			m_intervalsLeft--;
+		}
+	} else {
+		m_current = static_cast<unsigned>(m_residual);
+		if (m_residualsLeft > 0) {
+			m_residual += 1 + _getVarint(m_residuals);
+			m_residualsLeft--;
+		} else {
+			m_residual = ~0ull;
+		}
+	}
+}
+
+/**
+ * \brief Encodes sorted, deduplicated adjacency arrays (CSR layout) into m_offsets and m_bytes, and counts the edges
+ * (m_elems must already be filled).
+ * Chunks of vertices are encoded in parallel into their own buffers, which are then copied one after the other.
+ * \param[in] p_nbThreads the number of threads, 0 for the number of cores
+ */
+template<typename T>
+void Compressed_Graph<T>::_encode(const vector<unsigned> &p_offsets, const vector<unsigned> &p_neighbors, unsigned p_nbThreads) {
+	const unsigned nbVertices = m_elems.size(); // p_offsets may be empty (moved-from source)
+	const unsigned nbChunks = (nbVertices + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	vector<vector<uint8_t> > pieces(nbChunks);
+	vector<unsigned> nbLoops(nbChunks, 0);
+	vector<uint64_t> starts(nbChunks + 1, 0);
+	unsigned nbArcs = p_neighbors.size();
+
+	m_offsets.assign(nbVertices + 1, 0);
+	runInParallel(defaultThreads(p_nbThreads), nbChunks, [&](unsigned p_chunk) {
+		unsigned last = std::min(nbVertices, (p_chunk + 1) * CHUNK_SIZE);
+
+		for (unsigned v = p_chunk * CHUNK_SIZE; v < last; v++) {
+			const unsigned *row = p_neighbors.data() + p_offsets[v];
+			const unsigned *rowEnd = p_neighbors.data() + p_offsets[v + 1];
+
+			m_offsets[v] = pieces[p_chunk].size(); // relative to the chunk for now
+			_encodeRow(row, rowEnd, v, pieces[p_chunk]);
+			nbLoops[p_chunk] += std::binary_search(row, rowEnd, v);
+		}
+	});
+	for (unsigned chunk = 0; chunk < nbChunks; chunk++) {
+		starts[chunk + 1] = starts[chunk] + pieces[chunk].size();
+	}
+	m_bytes.resize(starts.back());
+	runInParallel(defaultThreads(p_nbThreads), nbChunks, [&](unsigned p_chunk) {
+		unsigned last = std::min(nbVertices, (p_chunk + 1) * CHUNK_SIZE);
+
+		std::copy(pieces[p_chunk].begin(), pieces[p_chunk].end(), m_bytes.begin() + starts[p_chunk]);
+		vector<uint8_t>().swap(pieces[p_chunk]);
+		for (unsigned v = p_chunk * CHUNK_SIZE; v < last; v++) {
+			m_offsets[v] += starts[p_chunk];
+		}
+	});
+	m_offsets[nbVertices] = m_bytes.size();
+	if (hasConfiguration(UNDIRECTED)) {
+		for (unsigned chunk = 0; chunk < nbChunks; chunk++) {
+			nbArcs += nbLoops[chunk];
+		}
+		m_nbEdges = nbArcs / 2;
+	} else {
+		m_nbEdges = nbArcs;
+	}
+}
+
+/**
+ * \brief Appends the encoding of a sorted adjacency list (see the class description) to a buffer
+ * \param[in] p_begin, p_end the indexes of the neighbors, sorted and without duplicates
+ * \param[in] p_vertex the index of the vertex owning the list
+ * \param[out] p_bytes the buffer
+ */
+template<typename T>
+void Compressed_Graph<T>::_encodeRow(const unsigned *p_begin, const unsigned *p_end, unsigned p_vertex, vector<uint8_t> &p_bytes) {
+	vector<const unsigned *> runs; // start and end of each run of at least MIN_INTERVAL consecutive indexes
+	const unsigned *pos = p_begin;
+	const unsigned *residual;
+	int64_t last = -1;
+
+	_putVarint(p_bytes, p_end - p_begin);
+	if (p_begin == p_end) {
+		return;
+	}
+	while (pos != p_end) {
+		const unsigned *runEnd = pos + 1;
+
+		while (runEnd != p_end && *runEnd == *(runEnd - 1) + 1) {
+			runEnd++;
+		}
+		if (runEnd - pos >= MIN_INTERVAL) {
+			runs.push_back(pos);
+			runs.push_back(runEnd);
+		}
+		pos = runEnd;
+	}
+	_putVarint(p_bytes, runs.size() / 2);
+	for (unsigned i = 0; i < runs.size(); i += 2) {
+		if (i == 0) {
+			_putVarint(p_bytes, _zigzag(static_cast<int64_t>(*runs[i]) - p_vertex));
+		} else {
+			_putVarint(p_bytes, *runs[i] - *(runs[i - 1] - 1) - 2); // a run is at least 2 past the end of the last one
+		}
+		_putVarint(p_bytes, runs[i + 1] - runs[i] - MIN_INTERVAL);
+	}
+	runs.push_back(p_end);
+	residual = p_begin;
+	for (unsigned i = 0; i < runs.size(); i += 2) {
+		// the residuals between the end of the last run (or the beginning) and the next run
+		for (; residual != runs[i]; residual++) {
+			if (last < 0) {
+				_putVarint(p_bytes, _zigzag(static_cast<int64_t>(*residual) - p_vertex));
+			} else {
+				_putVarint(p_bytes, *residual - last - 1);
+			}
+			last = *residual;
+		}
+		if (i + 1 < runs.size()) {
+			residual = runs[i + 1];
+		}
+	}
+}
+
+/**
+ * \brief Last step of the construction, once the lists are encoded: indexes the vertices
+ */
+template<typename T>
+void Compressed_Graph<T>::_indexVertices() {
+	m_index.reserve(m_elems.size());
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		m_index.insert(m_elems[v], v);
+	}
+	this->m_nbVertices = m_elems.size();
+	m_fingerprint.invalidate();
+}
+
+#if defined(__AVX2__)
+/**
+ * \brief Decodes the 8 one-byte gaps in the low half of p_gaps: a prefix sum in each 128-bit lane, then the sum of
+ * the low lane carried into the high one
+ * \param[in] p_last the index before the first gap
+ * \param[out] p_out the 8 indexes
+ * \return the last of them
+ */
+template<typename T>
+unsigned Compressed_Graph<T>::_addGaps(__m128i p_gaps, unsigned p_last, unsigned *p_out) {
+	__m256i sums = _mm256_add_epi32(_mm256_cvtepu8_epi32(p_gaps), _mm256_set1_epi32(1));
+	__m256i lowTotal;
+
+	sums = _mm256_add_epi32(sums, _mm256_slli_si256(sums, 4));
+	sums = _mm256_add_epi32(sums, _mm256_slli_si256(sums, 8));
+	lowTotal = _mm256_shuffle_epi32(sums, 0xFF);
+	sums = _mm256_add_epi32(sums, _mm256_permute2x128_si256(lowTotal, lowTotal, 0x08));
+	sums = _mm256_add_epi32(sums, _mm256_set1_epi32(static_cast<int>(p_last)));
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(p_out), sums);
+	return static_cast<unsigned>(_mm256_extract_epi32(sums, 7));
+}
+#endif
+
+template<typename T>
+bool Compressed_Graph<T>::_isLoop(unsigned p_idx) const {
+	return hasEdge(Vertex_Descriptor(p_idx), Vertex_Descriptor(p_idx));
+}
+
+} // namespace SGL
@@ -0,0 +1,141 @@
+//! \file CompressedSparseRow.h
+//! \brief Declaration of an immutable, read-optimized graph in compressed sparse row form
+//! \version 0.1
+
+#ifndef COMPRESSEDSPARSEROW_H_
+#define COMPRESSEDSPARSEROW_H_
+
+#include <vector>
+#include <string>
+
+#include "ReadOnlyGraph.h"
+#include "VertexIndex.h"
+#include "Fingerprint.h"
+#include "Range.h"
+#include "AdjacencyList.h"
+#include "AdjacencyMatrix.h"
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \class Compressed_Sparse_Row
+ *
+ * \brief Read-only graph storing all the adjacencies in two contiguous arrays.
+ * The neighbors of the vertex i are m_neighbors[m_offsets[i]] to m_neighbors[m_offsets[i + 1] - 1], sorted by index,
+ * so traversals are sequential in memory and hasEdge is a binary search.
+ * It is built in O(V+E) from a snapshot of an Adjacency_List or an Adjacency_Matrix, and can't be modified afterwards:
+ * all the mutators throw a logic_error.
+ * In an undirected graph, each edge is counted once by nbEdges and listed once by edges(), as in Adjacency_Matrix.
+ */
+template<typename T>
+class Compressed_Sparse_Row : public Read_Only_Graph<T, Compressed_Sparse_Row<T> > {
+	class AdjacentCursor;
+
+public:
+	typedef Range<Range_Iterator<AdjacentCursor> > adjacent_range; /*!< lazy range of Vertex_Descriptor */
+
+	////////////////////////////////////////////////////////////////
+	// Coplien Form
+	////////////////////////////////////////////////////////////////
+	Compressed_Sparse_Row(configuration p_f = 0);
+	template<typename Direction, typename Weighting, typename Allocator>
+	explicit Compressed_Sparse_Row(const Adjacency_List<T, Direction, Weighting, Allocator> &);
+	template<typename Direction, typename Weighting>
+	explicit Compressed_Sparse_Row(const Adjacency_Matrix<T, Direction, Weighting> &);
+	Compressed_Sparse_Row(const Compressed_Sparse_Row &) = default;
+	Compressed_Sparse_Row(Compressed_Sparse_Row &&) noexcept;
+	~Compressed_Sparse_Row() {}
+	Compressed_Sparse_Row &operator=(const Compressed_Sparse_Row &) = default;
+	Compressed_Sparse_Row &operator=(Compressed_Sparse_Row &&) noexcept;
+
+	////////////////////////////////////////////////////////////////
+	// Getters (const)
+	////////////////////////////////////////////////////////////////
+	using Read_Only_Graph<T, Compressed_Sparse_Row>::hasConfiguration;
+	using Read_Only_Graph<T, Compressed_Sparse_Row>::hasEdge;
+
+	std::vector<T> vertexNeighborhood(const T&, bool p_closed = false) const;
+	std::vector<T> vertices() const;
+	std::vector<std::pair<T, T> > edges() const;
+	uint64_t fingerprint() const;
+
+	////////////////////////////////////////////////////////////////
+	// Vertex descriptors: no vertex lookup
+	////////////////////////////////////////////////////////////////
+	/**
+	 * \brief Returns the data of a vertex from its descriptor
+	 * \pre p_vd is a valid descriptor of this graph
+	 */
+	inline const T &value(Vertex_Descriptor p_vd) const { return m_elems[p_vd.index()]; }
+
+	/**
+	 * \brief Upper bound of the indexes of the descriptors, to size per-vertex arrays
+	 */
+	inline unsigned indexBound() const { return m_elems.size(); }
+
+	bool hasEdge(Vertex_Descriptor, Vertex_Descriptor) const;
+	unsigned inDegree(Vertex_Descriptor) const;
+	unsigned outDegree(Vertex_Descriptor) const;
+	adjacent_range neighbors(Vertex_Descriptor) const;
+
+	////////////////////////////////////////////////////////////////
+	// Setters (mutators): the graph is immutable, they all throw
+	////////////////////////////////////////////////////////////////
+	void addVertex(const T &);
+	void deleteVertex(const T &);
+	void addEdge(const T&, const T&);
+	void deleteEdge(const T&, const T&);
+
+	friend class Read_Only_Graph<T, Compressed_Sparse_Row>;
+	template<typename> friend class Graph_Builder;
+	template<typename, typename, typename, typename> friend class Adjacency_List;
+	template<typename, typename, typename> friend class Adjacency_Matrix;
+	template<typename> friend class Compressed_Graph;
+
+private:
+	/**
+	 * \class AdjacentCursor
+	 * \brief Walks a slice of m_neighbors
+	 */
+	class AdjacentCursor {
+	public:
+		typedef Vertex_Descriptor value_type;
+		typedef Vertex_Descriptor reference;
+
+		AdjacentCursor() : m_pos(NULL) {}
+		explicit AdjacentCursor(const unsigned *p_pos) : m_pos(p_pos) {}
+
+		reference get() const { return Vertex_Descriptor(*m_pos); }
+		void next() { m_pos++; }
+		bool operator==(const AdjacentCursor &p_rhs) const { return m_pos == p_rhs.m_pos; }
+
+	private:
+		const unsigned *m_pos;
+	};
+
+	std::vector<T> m_elems; /*!< the vertices, in index order */
+	std::vector<unsigned> m_offsets; /*!< nbVertices + 1 offsets in m_neighbors, none once moved from */
+	std::vector<unsigned> m_neighbors; /*!< all the adjacency lists one after the other */
+	std::vector<unsigned> m_inDegrees; /*!< in-degree of each vertex (loops not doubled) */
+	unsigned m_nbEdges;
+	Vertex_Index<T> m_index; /*!< vertex data -> index */
+	mutable Graph_Fingerprint<T> m_fingerprint; /*!< computed on the first request */
+
+	void _swap(Compressed_Sparse_Row &) noexcept;
+
+	void _build(std::vector<unsigned> &p_offsets, std::vector<unsigned> &p_neighbors);
+
+	void _indexVertices();
+	static void _transpose(const std::vector<unsigned> &p_offsets, const std::vector<unsigned> &p_neighbors,
+			std::vector<unsigned> &p_tOffsets, std::vector<unsigned> &p_tNeighbors);
+	using Read_Only_Graph<T, Compressed_Sparse_Row>::_index;
+
+	bool _isLoop(unsigned) const;
+};
+
+}
+
+#include "CompressedSparseRow.hpp"
+
+#endif /* COMPRESSEDSPARSEROW_H_ */
@@ -0,0 +1,356 @@
+//! \file CompressedSparseRow.hpp
+//! \brief Implementation of the immutable compressed sparse row graph
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm> // std::binary_search
+
+using namespace std;
+
+namespace SGL {
+
+/**
+ * \brief Constructor of an empty graph
+ * \param[in] p_f the configuration flags of the graph
+ */
+template<typename T>
+Compressed_Sparse_Row<T>::Compressed_Sparse_Row(configuration p_f) :
+		m_offsets(1, 0), m_nbEdges(0) {
+	this->m_config = p_f;
+	this->m_nbVertices = 0;
+}
+
+/**
+ * \brief Move constructor: takes the arrays of the source without copying them, and allocates nothing
+ * \post The source is an empty graph with the same configuration
+ */
+template<typename T>
+Compressed_Sparse_Row<T>::Compressed_Sparse_Row(Compressed_Sparse_Row<T> &&p_src) noexcept :
+		m_nbEdges(0) {
+	this->m_config = p_src.m_config;
+	this->m_nbVertices = 0;
+	_swap(p_src);
+}
+
+/**
+ * \brief Move assignment: the previous arrays are freed, the source is left empty
+ */
+template<typename T>
+Compressed_Sparse_Row<T> &Compressed_Sparse_Row<T>::operator=(Compressed_Sparse_Row<T> &&p_src) noexcept {
+	Compressed_Sparse_Row<T> moved(std::move(p_src));
+
+	_swap(moved);
+	return (*this);
+}
+
+template<typename T>
+void Compressed_Sparse_Row<T>::_swap(Compressed_Sparse_Row<T> &p_other) noexcept {
+	std::swap(this->m_config, p_other.m_config);
+	std::swap(this->m_nbVertices, p_other.m_nbVertices);
+	m_elems.swap(p_other.m_elems);
+	m_offsets.swap(p_other.m_offsets);
+	m_neighbors.swap(p_other.m_neighbors);
+	m_inDegrees.swap(p_other.m_inDegrees);
+	std::swap(m_nbEdges, p_other.m_nbEdges);
+	std::swap(m_index, p_other.m_index);
+	std::swap(m_fingerprint, p_other.m_fingerprint);
+}
+
+/**
+ * \brief Builds the graph from a snapshot of an adjacency list, in O(V+E)
+ * \param[in] p_src the adjacency list to copy
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+template<typename Direction, typename Weighting, typename Allocator>
+Compressed_Sparse_Row<T>::Compressed_Sparse_Row(const Adjacency_List<T, Direction, Weighting, Allocator> &p_src) :
+		m_nbEdges(0) {
+	const unsigned deleted = ~0u;
+	vector<unsigned> newIndexes(p_src.m_nodes.size());
+	vector<unsigned> offsets;
+	vector<unsigned> neighbors;
+	unsigned nbArcs = 0;
+
+	this->m_config = p_src.getConfiguration();
+	// the tombstones of the list (see DEFERRED_DELETION) are left out of the numbering
+	for (unsigned v = 0; v < p_src.m_nodes.size(); v++) {
+		newIndexes[v] = p_src.m_nodes[v].m_deleted ? deleted : m_elems.size();
+		if (!p_src.m_nodes[v].m_deleted) {
+			m_elems.push_back(p_src.m_nodes[v].m_data);
+			nbArcs += p_src.m_nodes[v].m_edges.size();
+		}
+	}
+	offsets.reserve(m_elems.size() + 1);
+	neighbors.reserve(nbArcs);
+	offsets.push_back(0);
+	// an undirected adjacency list already stores both directions of each edge
+	for (unsigned v = 0; v < p_src.m_nodes.size(); v++) {
+		if (newIndexes[v] == deleted) {
+			continue;
+		}
+		for (unsigned edge_idx = 0; edge_idx < p_src.m_nodes[v].m_edges.size(); edge_idx++) {
+			unsigned dest_idx = newIndexes[p_src.m_nodes[v].m_edges[edge_idx].m_dest];
+
+			if (dest_idx != deleted) {
+				neighbors.push_back(dest_idx);
+			}
+		}
+		offsets.push_back(neighbors.size());
+	}
+	_build(offsets, neighbors);
+}
+
+/**
+ * \brief Builds the graph from a snapshot of an adjacency matrix, in O(V^2/64 + E)
+ * \param[in] p_src the adjacency matrix to copy
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+template<typename Direction, typename Weighting>
+Compressed_Sparse_Row<T>::Compressed_Sparse_Row(const Adjacency_Matrix<T, Direction, Weighting> &p_src) :
+		m_elems(p_src.m_elems), m_nbEdges(0) {
+	const typename Adjacency_Matrix<T, Direction, Weighting>::Storage &matrix = *p_src.m_matrix;
+	const unsigned nbVertices = m_elems.size();
+	vector<unsigned> offsets(nbVertices + 1, 0);
+	vector<unsigned> neighbors;
+
+	this->m_config = p_src.getConfiguration();
+	// the rows are read from the bit matrix word by word (nextEdge), straight into their slices
+	if (hasConfiguration(UNDIRECTED)) {
+		// the matrix only stores the lower triangle: count and place both directions of each edge
+		for (unsigned src = 0; src < nbVertices; src++) {
+			for (unsigned dest = matrix.nextEdge(src, 0); dest < nbVertices; dest = matrix.nextEdge(src, dest + 1)) {
+				offsets[src + 1]++;
+				offsets[dest + 1] += (dest != src);
+			}
+		}
+		for (unsigned v = 0; v < nbVertices; v++) {
+			offsets[v + 1] += offsets[v];
+		}
+		vector<unsigned> fill(offsets.begin(), offsets.end() - 1);
+
+		neighbors.resize(offsets.back());
+		for (unsigned src = 0; src < nbVertices; src++) {
+			for (unsigned dest = matrix.nextEdge(src, 0); dest < nbVertices; dest = matrix.nextEdge(src, dest + 1)) {
+				neighbors[fill[src]++] = dest;
+				if (dest != src) {
+					neighbors[fill[dest]++] = src;
+				}
+			}
+		}
+	} else {
+		for (unsigned v = 0; v < nbVertices; v++) {
+			offsets[v + 1] = offsets[v] + matrix.outDegree(v); // popcount of the row
+		}
+		neighbors.resize(offsets.back());
+		for (unsigned src = 0; src < nbVertices; src++) {
+			unsigned pos = offsets[src];
+
+			for (unsigned dest = matrix.nextEdge(src, 0); dest < nbVertices; dest = matrix.nextEdge(src, dest + 1)) {
+				neighbors[pos++] = dest;
+			}
+		}
+	}
+	_build(offsets, neighbors);
+}
+
+template<typename T>
+std::vector<T> Compressed_Sparse_Row<T>::vertexNeighborhood(const T &p_v, bool p_closed) const {
+	unsigned v_idx = _index(p_v); // throws logic error if the elem's not in the graph
+	vector<T> neighbors;
+
+	neighbors.reserve(m_offsets[v_idx + 1] - m_offsets[v_idx] + 1);
+	for (unsigned pos = m_offsets[v_idx]; pos < m_offsets[v_idx + 1]; pos++) {
+		neighbors.push_back(m_elems[m_neighbors[pos]]);
+	}
+	if (p_closed && !_isLoop(v_idx)) {
+		neighbors.push_back(m_elems[v_idx]);
+	}
+	return neighbors;
+}
+
+template<typename T>
+std::vector<T> Compressed_Sparse_Row<T>::vertices() const {
+	return m_elems;
+}
+
+template<typename T>
+std::vector<std::pair<T, T> > Compressed_Sparse_Row<T>::edges() const {
+	vector<pair<T, T> > edges;
+
+	edges.reserve(m_nbEdges);
+	for (unsigned src = 0; src < m_elems.size(); src++) {
+		for (unsigned pos = m_offsets[src]; pos < m_offsets[src + 1]; pos++) {
+			// in an undirected graph, only list each edge once (from its greatest vertex index)
+			if (hasConfiguration(UNDIRECTED) && m_neighbors[pos] > src) {
+				break;
+			}
+			edges.push_back(make_pair(m_elems[src], m_elems[m_neighbors[pos]]));
+		}
+	}
+	return edges;
+}
+
+/**
+ * \brief Order-independent hash of the vertices and edges, the same as any equal Adjacency_List or Adjacency_Matrix.
+ * Computed in O(V+E) on the first call, O(1) afterwards.
+ */
+template<typename T>
+uint64_t Compressed_Sparse_Row<T>::fingerprint() const {
+	if (!m_fingerprint.isValid()) {
+		const bool undirected = hasConfiguration(UNDIRECTED);
+
+		m_fingerprint.reset();
+		for (unsigned src = 0; src < m_elems.size(); src++) {
+			m_fingerprint.addVertex(m_elems[src]);
+			for (unsigned pos = m_offsets[src]; pos < m_offsets[src + 1]; pos++) {
+				// both directions of an undirected edge are stored: take it from its greatest vertex index
+				if (undirected && m_neighbors[pos] > src) {
+					break;
+				}
+				m_fingerprint.addEdge(m_elems[src], m_elems[m_neighbors[pos]], undirected);
+			}
+		}
+	}
+	return m_fingerprint.value();
+}
+
+/**
+ * \pre the descriptors are valid descriptors of this graph (they aren't checked)
+ */
+template<typename T>
+bool Compressed_Sparse_Row<T>::hasEdge(Vertex_Descriptor p_src, Vertex_Descriptor p_dest) const {
+	unsigned src_idx = p_src.index();
+
+	return std::binary_search(m_neighbors.begin() + m_offsets[src_idx], m_neighbors.begin() + m_offsets[src_idx + 1], p_dest.index());
+}
+
+template<typename T>
+unsigned Compressed_Sparse_Row<T>::inDegree(Vertex_Descriptor p_vd) const {
+	unsigned v_idx = p_vd.index();
+	unsigned inDeg = m_inDegrees[v_idx];
+
+	// if the graph is undirected: a loop counts twice
+	if (hasConfiguration(UNDIRECTED) && _isLoop(v_idx)) {
+		inDeg++;
+	}
+	return inDeg;
+}
+
+template<typename T>
+unsigned Compressed_Sparse_Row<T>::outDegree(Vertex_Descriptor p_vd) const {
+	unsigned v_idx = p_vd.index();
+	unsigned outDeg = m_offsets[v_idx + 1] - m_offsets[v_idx];
+
+	// if the graph is undirected: a loop counts twice
+	if (hasConfiguration(UNDIRECTED) && _isLoop(v_idx)) {
+		outDeg++;
+	}
+	return outDeg;
+}
+
+/**
+ * \brief Lazy range over the descriptors of the neighbors of a vertex, in index order
+ */
+template<typename T>
+typename Compressed_Sparse_Row<T>::adjacent_range Compressed_Sparse_Row<T>::neighbors(Vertex_Descriptor p_vd) const {
+	const unsigned *neighbors = m_neighbors.data();
+
+	return adjacent_range(Range_Iterator<AdjacentCursor>(AdjacentCursor(neighbors + m_offsets[p_vd.index()])),
+			Range_Iterator<AdjacentCursor>(AdjacentCursor(neighbors + m_offsets[p_vd.index() + 1])));
+}
+
+template<typename T>
+void Compressed_Sparse_Row<T>::addVertex(const T &) {
+	throw logic_error("addVertex: the graph is immutable");
+}
+
+template<typename T>
+void Compressed_Sparse_Row<T>::deleteVertex(const T &) {
+	throw logic_error("deleteVertex: the graph is immutable");
+}
+
+template<typename T>
+void Compressed_Sparse_Row<T>::addEdge(const T &, const T &) {
+	throw logic_error("addEdge: the graph is immutable");
+}
+
+template<typename T>
+void Compressed_Sparse_Row<T>::deleteEdge(const T &, const T &) {
+	throw logic_error("deleteEdge: the graph is immutable");
+}
+
+/**
+ * \brief Finishes the construction from unsorted adjacency arrays (m_elems must already be filled).
+ * Transposing twice sorts every adjacency list in O(V+E), and the first transposition gives the in-degrees.
+ */
+template<typename T>
+void Compressed_Sparse_Row<T>::_build(vector<unsigned> &p_offsets, vector<unsigned> &p_neighbors) {
+	vector<unsigned> tOffsets;
+	vector<unsigned> tNeighbors;
+
+	_transpose(p_offsets, p_neighbors, tOffsets, tNeighbors);
+	p_offsets.clear();
+	p_neighbors.clear();
+	m_inDegrees.resize(m_elems.size());
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		m_inDegrees[v] = tOffsets[v + 1] - tOffsets[v];
+	}
+	_transpose(tOffsets, tNeighbors, m_offsets, m_neighbors);
+	_indexVertices();
+}
+
+/**
+ * \brief Last step of the construction, once m_elems, m_offsets, m_neighbors and m_inDegrees are filled:
+ * indexes the vertices and counts the edges.
+ */
+template<typename T>
+void Compressed_Sparse_Row<T>::_indexVertices() {
+	unsigned nbLoops = 0;
+
+	m_index.reserve(m_elems.size());
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		m_index.insert(m_elems[v], v);
+		nbLoops += _isLoop(v);
+	}
+	this->m_nbVertices = m_elems.size();
+	m_fingerprint.invalidate();
+	if (hasConfiguration(UNDIRECTED)) {
+		m_nbEdges = (m_neighbors.size() + nbLoops) / 2;
+	} else {
+		m_nbEdges = m_neighbors.size();
+	}
+}
+
+/**
+ * \brief Computes the transposed graph of a CSR graph (counting sort on the destinations).
+ * The adjacency lists of the result are sorted by index.
+ */
+template<typename T>
+void Compressed_Sparse_Row<T>::_transpose(const vector<unsigned> &p_offsets, const vector<unsigned> &p_neighbors,
+		vector<unsigned> &p_tOffsets, vector<unsigned> &p_tNeighbors) {
+	unsigned nbVertices = p_offsets.size() - 1;
+
+	p_tOffsets.assign(nbVertices + 1, 0);
+	for (unsigned pos = 0; pos < p_neighbors.size(); pos++) {
+		p_tOffsets[p_neighbors[pos] + 1]++;
+	}
+	for (unsigned v = 0; v < nbVertices; v++) {
+		p_tOffsets[v + 1] += p_tOffsets[v];
+	}
+	vector<unsigned> fill(p_tOffsets.begin(), p_tOffsets.end() - 1);
+
+	p_tNeighbors.resize(p_neighbors.size());
+	for (unsigned src = 0; src < nbVertices; src++) {
+		for (unsigned pos = p_offsets[src]; pos < p_offsets[src + 1]; pos++) {
+			p_tNeighbors[fill[p_neighbors[pos]]++] = src;
+		}
+	}
+}
+
+template<typename T>
+bool Compressed_Sparse_Row<T>::_isLoop(unsigned p_idx) const {
+	return std::binary_search(m_neighbors.begin() + m_offsets[p_idx], m_neighbors.begin() + m_offsets[p_idx + 1], p_idx);
+}
+
+} // namespace SGL
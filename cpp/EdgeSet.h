@@ -0,0 +1,246 @@
+//! \file EdgeSet.h
+//! \brief Per-vertex set of outgoing edges of the adjacency list, with constant-time lookup on high degrees
+//! \version 0.1
+
+#ifndef EDGESET_H_
+#define EDGESET_H_
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace SGL {
+
+/**
+ * \class Edge_Set
+ * \brief The edges a vertex is the source of, keyed by their destination index (E must have an unsigned m_dest member).
+ * The edges are kept in a plain vector, so iterating on them stays a sequential scan.
+ * Below HASH_THRESHOLD edges a lookup is a linear scan of that vector; above it, an open-addressing hash table
+ * (linear probing, no tombstones) maps each destination to its position in the vector.
+ * The table only stores positions: the key of a bucket is read back from the edge it points to.
+ * Erasing moves the last edge into the hole, so the order of the edges isn't preserved by erase.
+ * Both vectors take their memory from an instance of the allocator A (rebound to their element type).
+ */
+template<typename E, typename A = std::allocator<E> >
+class Edge_Set {
+	typedef std::vector<E, typename std::allocator_traits<A>::template rebind_alloc<E> > Edges;
+	typedef std::vector<unsigned, typename std::allocator_traits<A>::template rebind_alloc<unsigned> > Table;
+
+public:
+	static const unsigned HASH_THRESHOLD = 32; /*!< number of edges above which the hash table is built */
+	static const unsigned REMOVED = ~0u; /*!< marks the destinations to drop in remap() */
+
+	explicit Edge_Set(const A &p_alloc = A()) : m_edges(p_alloc), m_table(p_alloc), m_shift(0) {}
+
+	/**
+	 * \brief Copies a set into memory from another allocator
+	 */
+	Edge_Set(const Edge_Set &p_src, const A &p_alloc) :
+			m_edges(p_src.m_edges.begin(), p_src.m_edges.end(), p_alloc),
+			m_table(p_src.m_table.begin(), p_src.m_table.end(), p_alloc), m_shift(p_src.m_shift) {}
+
+	inline unsigned size() const { return m_edges.size(); }
+	inline bool empty() const { return m_edges.empty(); }
+	inline const E &operator[](unsigned p_pos) const { return m_edges[p_pos]; }
+	inline E &operator[](unsigned p_pos) { return m_edges[p_pos]; } /*!< to update an edge in place: not its m_dest */
+
+	/**
+	 * \brief Looks up the edge going to a vertex: O(1) on average above HASH_THRESHOLD edges, O(degree) below
+	 * \param[in] p_dest the index of the destination vertex
+	 * \param[out] p_pos the position of the edge, if found
+	 * \return true if there is an edge to p_dest
+	 */
+	bool find(unsigned p_dest, unsigned &p_pos) const {
+		if (m_table.empty()) {
+			for (unsigned pos = 0; pos < m_edges.size(); pos++) {
+				if (m_edges[pos].m_dest == p_dest) {
+					p_pos = pos;
+					return true;
+				}
+			}
+			return false;
+		}
+		for (unsigned bucket = _bucket(p_dest); m_table[bucket] != EMPTY; bucket = _next(bucket)) {
+			if (m_edges[m_table[bucket]].m_dest == p_dest) {
+				p_pos = m_table[bucket];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * \brief Appends an edge
+	 * \pre there is no edge to the same destination yet
+	 */
+	void insert(const E &p_edge) {
+		m_edges.push_back(p_edge);
+		if (!m_table.empty()) {
+			if (m_edges.size() * 2 > m_table.size()) {
+				_rehash(m_edges.size());
+			} else {
+				_place(m_edges.size() - 1);
+			}
+		} else if (m_edges.size() > HASH_THRESHOLD) {
+			_rehash(m_edges.size());
+		}
+	}
+
+	/**
+	 * \brief Removes the edge at a given position, in O(1): the last edge takes its place
+	 */
+	void eraseAt(unsigned p_pos) {
+		unsigned last = m_edges.size() - 1;
+
+		if (!m_table.empty()) {
+			_unplace(p_pos);
+			if (p_pos != last) {
+				m_table[_slotOf(last)] = p_pos;
+			}
+		}
+		m_edges[p_pos] = m_edges[last];
+		m_edges.pop_back();
+		// hysteresis, so that a vertex whose degree oscillates around the threshold doesn't rebuild every time
+		if (!m_table.empty() && m_edges.size() < HASH_THRESHOLD / 2) {
+			Table(m_table.get_allocator()).swap(m_table);
+		}
+	}
+
+	/**
+	 * \brief Removes the edge going to a vertex
+	 * \return false if there was no such edge
+	 */
+	bool erase(unsigned p_dest) {
+		unsigned pos;
+
+		if (!find(p_dest, pos)) {
+			return false;
+		}
+		eraseAt(pos);
+		return true;
+	}
+
+	/**
+	 * \brief Makes room for a total number of edges, so that the inserts up to it neither reallocate nor rehash
+	 * \param[in] p_nb the number of edges the set will hold
+	 */
+	void reserve(unsigned p_nb) {
+		m_edges.reserve(p_nb);
+		if (p_nb > HASH_THRESHOLD && p_nb * 2 > m_table.size()) {
+			_rehash(p_nb);
+		}
+	}
+
+	void clear() {
+		m_edges.clear();
+		Table(m_table.get_allocator()).swap(m_table);
+	}
+
+	/**
+	 * \brief Renumbers the destinations after the vertices have been renumbered, in O(degree).
+	 * The edges whose destination becomes REMOVED are dropped; the others keep their relative order.
+	 * \param[in] p_newIndexes the new index of each old vertex index, or REMOVED
+	 * \return the number of edges dropped
+	 */
+	unsigned remap(const std::vector<unsigned> &p_newIndexes) {
+		unsigned kept = 0;
+		unsigned dropped;
+
+		for (unsigned pos = 0; pos < m_edges.size(); pos++) {
+			unsigned dest = p_newIndexes[m_edges[pos].m_dest];
+
+			if (dest != REMOVED) {
+				m_edges[kept] = m_edges[pos];
+				m_edges[kept++].m_dest = dest;
+			}
+		}
+		dropped = m_edges.size() - kept;
+		m_edges.erase(m_edges.begin() + kept, m_edges.end());
+		if (m_edges.size() > HASH_THRESHOLD) {
+			_rehash(m_edges.size());
+		} else {
+			Table(m_table.get_allocator()).swap(m_table);
+		}
+		return dropped;
+	}
+
+private:
+	static const unsigned EMPTY = ~0u;
+
+	Edges m_edges; /*!< the edges, in no particular order */
+	Table m_table; /*!< power-of-two hash table of positions in m_edges (EMPTY if free), or empty below the threshold */
+	unsigned m_shift; /*!< 32 - log2(table size), for the multiplicative hash */
+
+	inline unsigned _bucket(unsigned p_dest) const {
+		return static_cast<uint32_t>(p_dest * 2654435769u) >> m_shift; // Fibonacci hashing
+	}
+
+	inline unsigned _next(unsigned p_bucket) const {
+		return (p_bucket + 1) & (m_table.size() - 1);
+	}
+
+	void _place(unsigned p_pos) {
+		unsigned bucket = _bucket(m_edges[p_pos].m_dest);
+
+		while (m_table[bucket] != EMPTY) {
+			bucket = _next(bucket);
+		}
+		m_table[bucket] = p_pos;
+	}
+
+	unsigned _slotOf(unsigned p_pos) const {
+		unsigned bucket = _bucket(m_edges[p_pos].m_dest);
+
+		while (m_table[bucket] != p_pos) {
+			bucket = _next(bucket);
+		}
+		return bucket;
+	}
+
+	/**
+	 * \brief Frees the bucket of an edge, shifting back the following entries of its cluster (no tombstones needed)
+	 */
+	void _unplace(unsigned p_pos) {
+		unsigned hole = _slotOf(p_pos);
+
+		for (unsigned bucket = _next(hole); m_table[bucket] != EMPTY; bucket = _next(bucket)) {
+			unsigned home = _bucket(m_edges[m_table[bucket]].m_dest);
+
+			// the entry can move to the hole if its home isn't cyclically in (hole, bucket]
+			if (((bucket - home) & (m_table.size() - 1)) >= ((bucket - hole) & (m_table.size() - 1))) {
+				m_table[hole] = m_table[bucket];
+				hole = bucket;
+			}
+		}
+		m_table[hole] = EMPTY;
+	}
+
+	/**
+	 * \brief Rebuilds the table with a load factor between 1/4 and 1/2 once it holds p_capacity edges
+	 */
+	void _rehash(unsigned p_capacity) {
+		unsigned log2 = 1;
+
+		while ((1u << log2) < p_capacity * 4) {
+			log2++;
+		}
+		m_shift = 32 - log2;
+		m_table.assign(1u << log2, EMPTY);
+		for (unsigned pos = 0; pos < m_edges.size(); pos++) {
+			_place(pos);
+		}
+	}
+};
+
+template<typename E, typename A>
+const unsigned Edge_Set<E, A>::HASH_THRESHOLD;
+
+template<typename E, typename A>
+const unsigned Edge_Set<E, A>::REMOVED;
+
+template<typename E, typename A>
+const unsigned Edge_Set<E, A>::EMPTY;
+
+} // namespace SGL
+
+#endif /* EDGESET_H_ */
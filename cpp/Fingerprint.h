@@ -0,0 +1,114 @@
+//! \file Fingerprint.h
+//! \brief Order-independent hash of the vertices and edges of a graph, kept up to date by the graph classes
+//! \version 0.1
+
+#ifndef FINGERPRINT_H_
+#define FINGERPRINT_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "VertexIndex.h"
+
+namespace SGL {
+
+/**
+ * \brief Hasher of the pairs of vertices, to put edges in hash containers (T must have a Vertex_Hash)
+ */
+template<typename T>
+struct Vertex_Pair_Hash {
+	std::size_t operator()(const std::pair<T, T> &p_edge) const {
+		std::size_t seed = Vertex_Hash<T>()(p_edge.first);
+
+		return seed ^ (Vertex_Hash<T>()(p_edge.second) + 0x9E3779B9 + (seed << 6) + (seed >> 2));
+	}
+};
+
+/**
+ * \class Graph_Fingerprint
+ * \brief Sum of a hash of each vertex and of each edge of a graph, updated by the mutators in O(1).
+ * The sum doesn't depend on the insertion order nor on the representation: an undirected edge is counted once, with a
+ * hash symmetric in its two ends. Equal graphs always have the same fingerprint, so different fingerprints prove
+ * that two graphs differ. The weights aren't part of it.
+ * When a change can't be followed cheaply, the graph invalidates the fingerprint and computes it again on the next
+ * request.
+ */
+template<typename T, bool Hashed = Vertex_Hash<T>::enabled>
+class Graph_Fingerprint {
+public:
+	Graph_Fingerprint() : m_value(0), m_valid(true) {}
+
+	inline bool isValid() const { return m_valid; }
+	inline uint64_t value() const { return m_value; }
+
+	/**
+	 * \brief Starts again from an empty graph
+	 */
+	void reset() {
+		m_value = 0;
+		m_valid = true;
+	}
+	void invalidate() { m_valid = false; }
+
+	void addVertex(const T &p_v) { m_value += _vertexTerm(p_v); }
+	void eraseVertex(const T &p_v) { m_value -= _vertexTerm(p_v); }
+	void addEdge(const T &p_src, const T &p_dest, bool p_undirected) { m_value += _edgeTerm(p_src, p_dest, p_undirected); }
+	void eraseEdge(const T &p_src, const T &p_dest, bool p_undirected) { m_value -= _edgeTerm(p_src, p_dest, p_undirected); }
+
+private:
+	/**
+	 * \brief Finalizer of splitmix64: spreads the bits of the std::size_t hashes over the whole word
+	 */
+	static uint64_t _mix(uint64_t p_x) {
+		p_x = (p_x ^ (p_x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		p_x = (p_x ^ (p_x >> 27)) * 0x94D049BB133111EBULL;
+		return p_x ^ (p_x >> 31);
+	}
+	static uint64_t _hash(const T &p_v) { return _mix(Vertex_Hash<T>()(p_v)); }
+	static uint64_t _vertexTerm(const T &p_v) { return _mix(_hash(p_v) ^ 0x9E3779B97F4A7C15ULL); }
+	static uint64_t _edgeTerm(const T &p_src, const T &p_dest, bool p_undirected) {
+		uint64_t src = _hash(p_src);
+		uint64_t dest = _hash(p_dest);
+
+		if (p_undirected) {
+			return _mix((src + dest) ^ (src * dest));
+		}
+		return _mix(src + 3 * dest);
+	}
+
+	uint64_t m_value;
+	bool m_valid;
+};
+
+/**
+ * \brief Fingerprint of the vertex types with no Vertex_Hash: it only counts the vertices and the edges.
+ */
+template<typename T>
+class Graph_Fingerprint<T, false> {
+public:
+	Graph_Fingerprint() : m_value(0), m_valid(true) {}
+
+	inline bool isValid() const { return m_valid; }
+	inline uint64_t value() const { return m_value; }
+
+	void reset() {
+		m_value = 0;
+		m_valid = true;
+	}
+	void invalidate() { m_valid = false; }
+
+	void addVertex(const T &) { m_value++; }
+	void eraseVertex(const T &) { m_value--; }
+	void addEdge(const T &, const T &, bool) { m_value += EDGE; }
+	void eraseEdge(const T &, const T &, bool) { m_value -= EDGE; }
+
+private:
+	static const uint64_t EDGE = 1ULL << 32;
+
+	uint64_t m_value;
+	bool m_valid;
+};
+
+} // namespace SGL
+
+#endif /* FINGERPRINT_H_ */
@@ -0,0 +1,155 @@
+//! \file GraphBuilder.h
+//! \brief Parallel construction of a graph from an unordered list of edges
+//! \version 0.1
+
+#ifndef GRAPHBUILDER_H_
+#define GRAPHBUILDER_H_
+
+#include <vector>
+#include <utility>
+#include <mutex>
+#include <atomic>
+
+#include "VertexIndex.h"
+#include "AdjacencyList.h"
+#include "AdjacencyMatrix.h"
+#include "Parallel.h"
+#include "CompressedSparseRow.h"
+#include "CompressedGraph.h"
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \class Graph_Builder
+ * \brief Collects raw (source, destination) pairs, in any order and possibly with duplicates, from one or several
+ * threads, then builds an Adjacency_List, an Adjacency_Matrix, a Compressed_Sparse_Row or a Compressed_Graph from them in one go.
+ * The edges are never checked one by one against the graph: build() groups them by source with a parallel
+ * counting sort, sorts and deduplicates each adjacency list, and mirrors the edges if the target graph is undirected.
+ * Each array of the target is allocated once, with its final size.
+ *
+ * The edges may carry a weight, kept by build() when the target is a weighted list or matrix (converted to its
+ * weight type) and dropped otherwise. An edge added without a weight weighs DEFAULT_WEIGHT, as in an unweighted
+ * graph; of the duplicates of an edge, the one with the smallest weight is kept.
+ *
+ * Each producer thread fills its own Producer, which numbers the vertices it sees locally (so the hashing is spread
+ * over the producers) and hands its edges over to the builder when flushed or destroyed. Only an explicit flush()
+ * reports a failure of the handover; the destructor can't, and drops the edges it couldn't hand over.
+ * The vertices get their final indexes in the order the producers were flushed, so that order is the vertex order
+ * of the built graph.
+ * The vertex type needs a Vertex_Hash.
+ */
+template<typename T>
+class Graph_Builder {
+	struct Batch;
+
+public:
+	/**
+	 * \class Producer
+	 * \brief Edge buffer of one thread. A Producer isn't thread-safe itself: create one per thread.
+	 */
+	class Producer {
+	public:
+		explicit Producer(Graph_Builder &p_builder) : m_builder(&p_builder) {}
+		~Producer();
+
+		void addVertex(const T &);
+		void addEdge(const T &, const T &);
+		void addEdge(const T &, const T &, double p_weight);
+		void flush();
+
+	private:
+		Producer(const Producer &);
+		Producer &operator=(const Producer &);
+
+		unsigned _intern(const T &);
+
+		Graph_Builder *m_builder;
+		Vertex_Index<T> m_index; /*!< vertex data -> local index */
+		std::vector<T> m_vertices; /*!< local index -> vertex data */
+		std::vector<std::pair<unsigned, unsigned> > m_edges; /*!< the edges, as pairs of local indexes */
+		std::vector<double> m_weights; /*!< the weights of m_edges, empty until the first weighted edge */
+	};
+
+	static constexpr double DEFAULT_WEIGHT = 1; /*!< weight of the edges added without one */
+
+	explicit Graph_Builder(unsigned p_nbThreads = 0);
+
+	/**
+	 * \brief Number of threads used by build()
+	 */
+	inline unsigned nbThreads() const { return m_nbThreads; }
+
+	void addVertex(const T &);
+	void addEdge(const T &, const T &);
+	void addEdge(const T &, const T &, double p_weight);
+
+	template<typename Direction, typename Weighting, typename Allocator>
+	void build(Adjacency_List<T, Direction, Weighting, Allocator> &);
+	template<typename Direction, typename Weighting>
+	void build(Adjacency_Matrix<T, Direction, Weighting> &);
+	void build(Compressed_Sparse_Row<T> &);
+	void build(Compressed_Graph<T> &);
+
+private:
+	/**
+	 * \brief What a Producer hands over: its vertices and its edges, in local indexes
+	 */
+	struct Batch {
+		std::vector<T> m_vertices;
+		std::vector<std::pair<unsigned, unsigned> > m_edges;
+		std::vector<double> m_weights; /*!< empty if all the edges weigh DEFAULT_WEIGHT */
+	};
+
+	/**
+	 * \brief A slice of the edges of a batch: the unit of work of the passes over the edges
+	 */
+	struct Chunk {
+		unsigned m_batch;
+		unsigned m_begin;
+		unsigned m_end;
+	};
+
+	static const unsigned CHUNK_SIZE = 1u << 16; /*!< edges or vertices per task of the parallel passes */
+
+	Graph_Builder(const Graph_Builder &);
+	Graph_Builder &operator=(const Graph_Builder &);
+
+	void _receive(Batch &);
+	void _sortEdges(bool p_undirected);
+	template<typename Entry>
+	void _packRows(const std::vector<Chunk> &, bool p_undirected, std::vector<std::atomic<unsigned> > &p_counters,
+			const std::vector<unsigned> &p_starts);
+	inline double _weight(unsigned p_pos) const { return m_weights.empty() ? DEFAULT_WEIGHT : m_weights[p_pos]; }
+
+	/**
+	 * \brief An edge in a row of the counting sort: its destination, with its weight if any edge has one
+	 */
+	static unsigned _entry(unsigned p_dest, const Batch &, unsigned, unsigned *) { return p_dest; }
+	static std::pair<unsigned, double> _entry(unsigned p_dest, const Batch &p_batch, unsigned p_pos, std::pair<unsigned, double> *) {
+		return std::make_pair(p_dest, p_batch.m_weights.empty() ? DEFAULT_WEIGHT : p_batch.m_weights[p_pos]);
+	}
+	static unsigned _dest(unsigned p_entry) { return p_entry; }
+	static unsigned _dest(const std::pair<unsigned, double> &p_entry) { return p_entry.first; }
+	void _storeWeight(unsigned, unsigned) {}
+	void _storeWeight(unsigned p_pos, const std::pair<unsigned, double> &p_entry) { m_weights[p_pos] = p_entry.second; }
+	template<typename Task>
+	void _parallel(unsigned p_nbTasks, Task p_task) const;
+
+	unsigned m_nbThreads;
+	std::mutex m_mutex; /*!< protects m_batches against concurrent flushes */
+	std::vector<Batch> m_batches; /*!< the flushed batches, in flush order */
+	Producer m_own; /*!< the producer behind addVertex and addEdge */
+
+	// filled by _sortEdges
+	std::vector<T> m_elems; /*!< the vertices, in their final order */
+	std::vector<unsigned> m_offsets; /*!< nbVertices + 1 offsets in m_neighbors */
+	std::vector<unsigned> m_neighbors; /*!< the sorted, deduplicated adjacency lists one after the other */
+	std::vector<double> m_weights; /*!< the weights of m_neighbors, empty if no edge was given one */
+};
+
+}
+
+#include "GraphBuilder.hpp"
+
+#endif /* GRAPHBUILDER_H_ */
@@ -0,0 +1,500 @@
+//! \file GraphBuilder.hpp
+//! \brief Implementation of the parallel graph builder
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm> // std::sort, std::unique, std::copy, std::min
+#include <atomic>
+
+using namespace std;
+
+namespace SGL {
+
+template<typename T>
+const unsigned Graph_Builder<T>::CHUNK_SIZE;
+template<typename T>
+constexpr double Graph_Builder<T>::DEFAULT_WEIGHT;
+
+/**
+ * \brief Constructor
+ * \param[in] p_nbThreads the number of threads build() runs on, 0 for the number of cores
+ */
+template<typename T>
+Graph_Builder<T>::Graph_Builder(unsigned p_nbThreads) :
+		m_nbThreads(defaultThreads(p_nbThreads)), m_own(*this) {
+	static_assert(Vertex_Hash<T>::enabled, "Graph_Builder: the vertex type needs a Vertex_Hash");
+}
+
+/**
+ * \brief Adds an isolated vertex (it may also be the end of some edges)
+ */
+template<typename T>
+void Graph_Builder<T>::Producer::addVertex(const T &p_v) {
+	_intern(p_v);
+}
+
+/**
+ * \brief Adds an edge. Duplicates are allowed: they are merged by build()
+ */
+template<typename T>
+void Graph_Builder<T>::Producer::addEdge(const T &p_src, const T &p_dest) {
+	unsigned src_idx = _intern(p_src);
+
+	m_edges.push_back(make_pair(src_idx, _intern(p_dest)));
+	if (!m_weights.empty()) {
+		m_weights.push_back(DEFAULT_WEIGHT);
+	}
+}
+
+/**
+ * \brief Adds a weighted edge. Duplicates are allowed: build() keeps the smallest of their weights
+ */
+template<typename T>
+void Graph_Builder<T>::Producer::addEdge(const T &p_src, const T &p_dest, double p_weight) {
+	unsigned src_idx = _intern(p_src);
+
+	m_weights.resize(m_edges.size(), DEFAULT_WEIGHT); // the unweighted edges added before
+	m_edges.push_back(make_pair(src_idx, _intern(p_dest)));
+	m_weights.push_back(p_weight);
+}
+
+/**
+ * \brief Flushes the edges left, without throwing: call flush() before to know whether the handover failed
+ */
+template<typename T>
+Graph_Builder<T>::Producer::~Producer() {
+	try {
+		flush();
+	} catch (...) {
+		// a destructor can't report it: the edges which weren't handed over are lost
+	}
+}
+
+/**
+ * \brief Hands the vertices and edges added so far over to the builder (thread-safe)
+ * \exception bad_alloc in case of insufficient memory, the producer keeping its edges
+ */
+template<typename T>
+void Graph_Builder<T>::Producer::flush() {
+	Batch batch;
+
+	if (m_vertices.empty()) {
+		return;
+	}
+	batch.m_vertices.swap(m_vertices);
+	batch.m_edges.swap(m_edges);
+	batch.m_weights.swap(m_weights);
+	try {
+		m_builder->_receive(batch);
+	} catch (...) {
+		m_vertices.swap(batch.m_vertices);
+		m_edges.swap(batch.m_edges);
+		m_weights.swap(batch.m_weights);
+		throw;
+	}
+	m_index.clear();
+}
+
+template<typename T>
+unsigned Graph_Builder<T>::Producer::_intern(const T &p_v) {
+	unsigned idx;
+
+	if (!m_index.find(p_v, idx)) {
+		idx = m_vertices.size();
+		m_vertices.push_back(p_v);
+		m_index.insert(p_v, idx);
+	}
+	return idx;
+}
+
+/**
+ * \brief Same as Producer::addVertex, from the thread that owns the builder
+ */
+template<typename T>
+void Graph_Builder<T>::addVertex(const T &p_v) {
+	m_own.addVertex(p_v);
+}
+
+/**
+ * \brief Same as Producer::addEdge, from the thread that owns the builder
+ */
+template<typename T>
+void Graph_Builder<T>::addEdge(const T &p_src, const T &p_dest) {
+	m_own.addEdge(p_src, p_dest);
+}
+
+/**
+ * \brief Same as Producer::addEdge with a weight, from the thread that owns the builder
+ */
+template<typename T>
+void Graph_Builder<T>::addEdge(const T &p_src, const T &p_dest, double p_weight) {
+	m_own.addEdge(p_src, p_dest, p_weight);
+}
+
+/**
+ * \brief Builds an adjacency list from the edges flushed so far, and empties the builder.
+ * The producers still filling must be flushed before.
+ * The edges of each vertex end up sorted by destination index; in an undirected list, each edge is stored both ways.
+ * A weighted list gets the weights of the edges.
+ * \param[out] p_list the graph to fill, whose configuration gives the direction
+ * \exception logic_error if p_list isn't empty
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+template<typename Direction, typename Weighting, typename Allocator>
+void Graph_Builder<T>::build(Adjacency_List<T, Direction, Weighting, Allocator> &p_list) {
+	typedef typename Adjacency_List<T, Direction, Weighting, Allocator>::Node Node;
+	typedef typename Adjacency_List<T, Direction, Weighting, Allocator>::Edge Edge;
+	typedef typename Weighting::weight_type weight_type;
+	typedef std::integral_constant<bool, Weighting::isWeighted> Keep_Weights;
+	const bool undirected = p_list._isUndirected();
+
+	if (!p_list.m_nodes.empty()) {
+		throw logic_error("build: the graph isn't empty");
+	}
+	_sortEdges(undirected);
+	vector<Node> &nodes = p_list.m_nodes;
+
+	nodes.reserve(m_elems.size());
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		nodes.emplace_back(std::move(m_elems[v]), p_list.m_allocator.get()); // the builder drops its copy anyway
+	}
+	if (!undirected) {
+		for (unsigned pos = 0; pos < m_neighbors.size(); pos++) {
+			nodes[m_neighbors[pos]].m_inDegree++;
+		}
+	}
+	const unsigned nbFillTasks = (m_elems.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	auto fill = [&](unsigned p_task) {
+		unsigned last = std::min<unsigned>(m_elems.size(), (p_task + 1) * CHUNK_SIZE);
+
+		for (unsigned v = p_task * CHUNK_SIZE; v < last; v++) {
+			Node &node = nodes[v];
+			unsigned loop = 0;
+
+			node.m_edges.reserve(m_offsets[v + 1] - m_offsets[v]);
+			for (unsigned pos = m_offsets[v]; pos < m_offsets[v + 1]; pos++) {
+				node.m_edges.insert(Edge(m_neighbors[pos], p_list._slot(static_cast<weight_type>(_weight(pos)), Keep_Weights())));
+				loop |= (m_neighbors[pos] == v);
+			}
+			node.m_outDegree = node.m_edges.size();
+			// in an undirected list, a loop counts twice in the degrees
+			if (undirected) {
+				node.m_outDegree += loop;
+				node.m_inDegree = node.m_outDegree;
+			}
+		}
+	};
+	if (Allocator_Source<Allocator>::isConcurrent) {
+		_parallel(nbFillTasks, fill);
+	} else { // an arena can't serve several threads
+		for (unsigned task = 0; task < nbFillTasks; task++) {
+			fill(task);
+		}
+	}
+	if (p_list._hasReverseIndex()) {
+		for (unsigned v = 0; v < nodes.size(); v++) {
+			nodes[v].m_inEdges.reserve(nodes[v].m_inDegree);
+		}
+		for (unsigned src = 0; src < nodes.size(); src++) {
+			for (unsigned pos = m_offsets[src]; pos < m_offsets[src + 1]; pos++) {
+				nodes[m_neighbors[pos]].m_inEdges.push_back(src);
+			}
+		}
+	}
+	p_list.m_index.reserve(m_elems.size());
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		p_list.m_index.insert(nodes[v].m_data, v);
+	}
+	p_list.m_nbEdges = m_neighbors.size();
+	p_list.m_nbVertices = m_elems.size();
+	p_list.m_fingerprint.invalidate();
+
+	p_list.m_observers.verticesReset(m_elems.size());
+	vector<T>().swap(m_elems);
+	vector<unsigned>().swap(m_offsets);
+	vector<unsigned>().swap(m_neighbors);
+	vector<double>().swap(m_weights);
+}
+
+/**
+ * \brief Builds an adjacency matrix from the edges flushed so far, and empties the builder.
+ * The producers still filling must be flushed before.
+ * The vertices are inserted in their final order, then each edge sets its bit by index, without any vertex lookup.
+ * A weighted matrix gets the weights of the edges.
+ * \param[out] p_matrix the graph to fill, whose configuration gives the direction
+ * \exception logic_error if p_matrix isn't empty
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+template<typename Direction, typename Weighting>
+void Graph_Builder<T>::build(Adjacency_Matrix<T, Direction, Weighting> &p_matrix) {
+	typedef typename Weighting::weight_type weight_type;
+	typedef std::integral_constant<bool, Weighting::isWeighted> Keep_Weights;
+	const bool undirected = p_matrix._isUndirected();
+
+	if (p_matrix.nbVertices() > 0) {
+		throw logic_error("build: the graph isn't empty");
+	}
+	_sortEdges(undirected);
+	p_matrix.reserveVertices(m_elems.size());
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		p_matrix._insertVertex(std::move(m_elems[v]));
+	}
+	for (unsigned v = 0; v < m_elems.size(); v++) {
+		for (unsigned pos = m_offsets[v]; pos < m_offsets[v + 1]; pos++) {
+			// an undirected edge is in the rows of both its ends: set its bit once
+			if (!undirected || m_neighbors[pos] <= v) {
+				p_matrix.m_matrix->addEdge(v, m_neighbors[pos]);
+				p_matrix._copyWeight(v, m_neighbors[pos], static_cast<weight_type>(_weight(pos)), Keep_Weights());
+			}
+		}
+	}
+	p_matrix.m_fingerprint.invalidate();
+	vector<T>().swap(m_elems);
+	vector<unsigned>().swap(m_offsets);
+	vector<unsigned>().swap(m_neighbors);
+	vector<double>().swap(m_weights);
+}
+
+/**
+ * \brief Builds a compressed sparse row graph from the edges flushed so far, and empties the builder.
+ * The producers still filling must be flushed before.
+ * \param[out] p_graph the graph to fill, whose configuration gives the direction
+ * \exception logic_error if p_graph isn't empty
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+void Graph_Builder<T>::build(Compressed_Sparse_Row<T> &p_graph) {
+	const bool undirected = p_graph.hasConfiguration(UNDIRECTED);
+
+	if (p_graph.nbVertices() > 0) {
+		throw logic_error("build: the graph isn't empty");
+	}
+	_sortEdges(undirected);
+	p_graph.m_elems.swap(m_elems);
+	p_graph.m_offsets.swap(m_offsets);
+	p_graph.m_neighbors.swap(m_neighbors);
+	vector<T>().swap(m_elems);
+	vector<unsigned>().swap(m_offsets);
+	vector<unsigned>().swap(m_neighbors);
+	vector<double>().swap(m_weights); // no weights in a compressed sparse row graph
+
+	vector<unsigned> &inDegrees = p_graph.m_inDegrees;
+	const vector<unsigned> &offsets = p_graph.m_offsets;
+	const vector<unsigned> &neighbors = p_graph.m_neighbors;
+
+	inDegrees.assign(p_graph.m_elems.size(), 0);
+	if (undirected) {
+		// the adjacency is symmetric: the in-degrees are the lengths of the rows
+		for (unsigned v = 0; v < inDegrees.size(); v++) {
+			inDegrees[v] = offsets[v + 1] - offsets[v];
+		}
+	} else {
+		for (unsigned pos = 0; pos < neighbors.size(); pos++) {
+			inDegrees[neighbors[pos]]++;
+		}
+	}
+	p_graph._indexVertices();
+}
+
+/**
+ * \brief Builds a compressed graph from the edges flushed so far, and empties the builder.
+ * The adjacency lists are encoded in parallel straight from the sorted arrays, without a Compressed_Sparse_Row.
+ * The producers still filling must be flushed before.
+ * \param[out] p_graph the graph to fill, whose configuration gives the direction
+ * \exception logic_error if p_graph isn't empty
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+void Graph_Builder<T>::build(Compressed_Graph<T> &p_graph) {
+	const bool undirected = p_graph.hasConfiguration(UNDIRECTED);
+
+	if (p_graph.nbVertices() > 0) {
+		throw logic_error("build: the graph isn't empty");
+	}
+	_sortEdges(undirected);
+	p_graph.m_elems.swap(m_elems);
+	vector<T>().swap(m_elems);
+
+	vector<unsigned> &inDegrees = p_graph.m_inDegrees;
+
+	inDegrees.assign(p_graph.m_elems.size(), 0);
+	if (undirected) {
+		// the adjacency is symmetric: the in-degrees are the lengths of the rows
+		for (unsigned v = 0; v < inDegrees.size(); v++) {
+			inDegrees[v] = m_offsets[v + 1] - m_offsets[v];
+		}
+	} else {
+		for (unsigned pos = 0; pos < m_neighbors.size(); pos++) {
+			inDegrees[m_neighbors[pos]]++;
+		}
+	}
+	p_graph._encode(m_offsets, m_neighbors, m_nbThreads);
+	vector<unsigned>().swap(m_offsets);
+	vector<unsigned>().swap(m_neighbors);
+	vector<double>().swap(m_weights); // no weights in a compressed graph
+	p_graph._indexVertices();
+}
+
+/**
+ * \brief Takes the content of a batch, once its slot is allocated: p_batch is left untouched if it throws
+ */
+template<typename T>
+void Graph_Builder<T>::_receive(Batch &p_batch) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_batches.push_back(Batch());
+	m_batches.back().m_vertices.swap(p_batch.m_vertices);
+	m_batches.back().m_edges.swap(p_batch.m_edges);
+	m_batches.back().m_weights.swap(p_batch.m_weights);
+}
+
+/**
+ * \brief Turns the batches into sorted, deduplicated adjacency arrays (m_elems, m_offsets, m_neighbors, and m_weights
+ * if some edges have a weight):
+ * - the local indexes of the batches are mapped to the final ones (sequential, one lookup per vertex and batch),
+ * - the out-degrees are counted and the edges scattered by source, a counting sort run in parallel over
+ * slices of the batches with atomic counters (both directions of each edge if p_undirected),
+ * - each adjacency list is sorted and deduplicated, then packed into m_neighbors, in parallel over the vertices.
+ */
+template<typename T>
+void Graph_Builder<T>::_sortEdges(bool p_undirected) {
+	Vertex_Index<T> index;
+	vector<vector<unsigned> > finalIndexes;
+	vector<Chunk> chunks;
+
+	m_own.flush();
+	finalIndexes.resize(m_batches.size());
+	m_elems.clear();
+	m_weights.clear();
+	for (unsigned b = 0; b < m_batches.size(); b++) {
+		const vector<T> &vertices = m_batches[b].m_vertices;
+
+		finalIndexes[b].resize(vertices.size());
+		for (unsigned i = 0; i < vertices.size(); i++) {
+			if (!index.find(vertices[i], finalIndexes[b][i])) {
+				finalIndexes[b][i] = m_elems.size();
+				index.insert(vertices[i], m_elems.size());
+				m_elems.push_back(vertices[i]);
+			}
+		}
+		for (unsigned begin = 0; begin < m_batches[b].m_edges.size(); begin += CHUNK_SIZE) {
+			Chunk chunk = { b, begin, std::min<unsigned>(m_batches[b].m_edges.size(), begin + CHUNK_SIZE) };
+
+			chunks.push_back(chunk);
+		}
+	}
+	index.clear();
+
+	const unsigned nbVertices = m_elems.size();
+	vector<atomic<unsigned> > counters(nbVertices); // out-degrees, then the next free position of each row
+	vector<unsigned> starts(nbVertices + 1, 0);
+
+	_parallel(chunks.size(), [&](unsigned p_task) {
+		const Chunk &chunk = chunks[p_task];
+		const vector<unsigned> &finalIndex = finalIndexes[chunk.m_batch];
+		vector<pair<unsigned, unsigned> > &edges = m_batches[chunk.m_batch].m_edges;
+
+		for (unsigned pos = chunk.m_begin; pos < chunk.m_end; pos++) {
+			edges[pos].first = finalIndex[edges[pos].first];
+			edges[pos].second = finalIndex[edges[pos].second];
+			counters[edges[pos].first].fetch_add(1, memory_order_relaxed);
+			if (p_undirected && edges[pos].first != edges[pos].second) {
+				counters[edges[pos].second].fetch_add(1, memory_order_relaxed);
+			}
+		}
+	});
+	vector<vector<unsigned> >().swap(finalIndexes);
+	for (unsigned v = 0; v < nbVertices; v++) {
+		starts[v + 1] = starts[v] + counters[v].load(memory_order_relaxed);
+		counters[v].store(starts[v], memory_order_relaxed);
+	}
+	bool weighted = false;
+
+	for (unsigned b = 0; b < m_batches.size(); b++) {
+		weighted |= !m_batches[b].m_weights.empty();
+	}
+	if (weighted) {
+		_packRows<pair<unsigned, double> >(chunks, p_undirected, counters, starts);
+	} else {
+		_packRows<unsigned>(chunks, p_undirected, counters, starts);
+	}
+}
+
+/**
+ * \brief End of _sortEdges: scatters the edges by source, then sorts, deduplicates and packs each row.
+ * An Entry is a destination index, or a (destination, weight) pair if some edges have a weight (see _entry).
+ * \param[in] p_counters the start of each row, moved along by the scatter
+ */
+template<typename T>
+template<typename Entry>
+void Graph_Builder<T>::_packRows(const std::vector<Chunk> &p_chunks, bool p_undirected, std::vector<std::atomic<unsigned> > &p_counters,
+		const std::vector<unsigned> &p_starts) {
+	const unsigned nbVertices = m_elems.size();
+	vector<Entry> scattered(p_starts.back());
+
+	_parallel(p_chunks.size(), [&](unsigned p_task) {
+		const Chunk &chunk = p_chunks[p_task];
+		const Batch &batch = m_batches[chunk.m_batch];
+		const vector<pair<unsigned, unsigned> > &edges = batch.m_edges;
+
+		for (unsigned pos = chunk.m_begin; pos < chunk.m_end; pos++) {
+			scattered[p_counters[edges[pos].first].fetch_add(1, memory_order_relaxed)] =
+					_entry(edges[pos].second, batch, pos, static_cast<Entry *>(NULL));
+			if (p_undirected && edges[pos].first != edges[pos].second) {
+				scattered[p_counters[edges[pos].second].fetch_add(1, memory_order_relaxed)] =
+						_entry(edges[pos].first, batch, pos, static_cast<Entry *>(NULL));
+			}
+		}
+	});
+	vector<Batch>().swap(m_batches);
+	vector<atomic<unsigned> >().swap(p_counters);
+
+	const unsigned nbTasks = (nbVertices + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	vector<unsigned> lengths(nbVertices);
+
+	_parallel(nbTasks, [&](unsigned p_task) {
+		unsigned last = std::min(nbVertices, (p_task + 1) * CHUNK_SIZE);
+
+		for (unsigned v = p_task * CHUNK_SIZE; v < last; v++) {
+			typename vector<Entry>::iterator row = scattered.begin() + p_starts[v];
+			typename vector<Entry>::iterator rowEnd = scattered.begin() + p_starts[v + 1];
+
+			// sorted by destination, then by weight: the first of the duplicates has the smallest weight
+			std::sort(row, rowEnd);
+			lengths[v] = std::unique(row, rowEnd, [](const Entry &p_a, const Entry &p_b) { return _dest(p_a) == _dest(p_b); }) - row;
+		}
+	});
+	m_offsets.assign(nbVertices + 1, 0);
+	for (unsigned v = 0; v < nbVertices; v++) {
+		m_offsets[v + 1] = m_offsets[v] + lengths[v];
+	}
+	m_neighbors.resize(m_offsets.back());
+	if (!std::is_same<Entry, unsigned>::value) {
+		m_weights.resize(m_offsets.back());
+	}
+	_parallel(nbTasks, [&](unsigned p_task) {
+		unsigned last = std::min(nbVertices, (p_task + 1) * CHUNK_SIZE);
+
+		for (unsigned v = p_task * CHUNK_SIZE; v < last; v++) {
+			for (unsigned i = 0; i < lengths[v]; i++) {
+				const Entry &entry = scattered[p_starts[v] + i];
+
+				m_neighbors[m_offsets[v] + i] = _dest(entry);
+				_storeWeight(m_offsets[v] + i, entry);
+			}
+		}
+	});
+}
+
+/**
+ * \brief Runs the tasks on the threads of the builder (see runInParallel)
+ */
+template<typename T>
+template<typename Task>
+void Graph_Builder<T>::_parallel(unsigned p_nbTasks, Task p_task) const {
+	runInParallel(m_nbThreads, p_nbTasks, p_task);
+}
+
+} // namespace SGL
@@ -0,0 +1,214 @@
+//! \file GraphFile.h
+//! \brief Binary graph file format, written by the save() methods and memory-mapped by Mapped_Graph
+//! \version 0.1
+
+#ifndef GRAPHFILE_H_
+#define GRAPHFILE_H_
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <atomic>
+#include <string>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+namespace SGL {
+
+/**
+ * \class Graph_File_Header
+ * \brief First bytes of a graph file, followed by its sections. Every section starts on a SECTION_ALIGNMENT
+ * boundary, so once the file is mapped each of them can be read in place as an array:
+ * - VERTICES: the vertex payloads, nbVertices T (T trivially copyable), in index order,
+ * - OFFSETS: nbVertices + 1 unsigned, the neighbors of the vertex i being NEIGHBORS[OFFSETS[i]] to
+ *   NEIGHBORS[OFFSETS[i + 1] - 1],
+ * - NEIGHBORS: nbArcs unsigned, each slice sorted by index (both directions of an undirected edge are stored),
+ * - IN_DEGREES: nbVertices unsigned (loops not doubled),
+ * - BITS: (saved from an Adjacency_Matrix only, 0 otherwise) the square bit matrix, rows of rowWords 64-bit words.
+ * The numbers are stored in the byte order of the machine that saved the file: byteOrder tells whether it's ours.
+ */
+struct Graph_File_Header {
+	enum Section { VERTICES, OFFSETS, NEIGHBORS, IN_DEGREES, BITS, NB_SECTIONS };
+
+	static const uint32_t VERSION = 1;
+	static const uint32_t ORDER_MARK = 0x01020304;
+	static const uint64_t SECTION_ALIGNMENT = 64;
+
+	char magic[4]; /*!< "SGLG" */
+	uint32_t version;
+	uint32_t byteOrder; /*!< ORDER_MARK, as written by the saving machine */
+	uint32_t config; /*!< configuration flags of the saved graph */
+	uint32_t vertexSize; /*!< sizeof(T) */
+	uint32_t nbVertices;
+	uint32_t nbEdges; /*!< each undirected edge counted once */
+	uint32_t rowWords; /*!< 64-bit words per row of the BITS section */
+	uint64_t nbArcs; /*!< entries of the NEIGHBORS section */
+	uint64_t fingerprint; /*!< Graph_Fingerprint of the saved graph */
+	uint64_t sections[NB_SECTIONS]; /*!< byte offset of each section in the file, 0 if absent */
+	uint64_t fileSize;
+};
+
+/**
+ * \class Graph_File_Writer
+ * \brief Writes a graph file section after section, in one sequential pass; the header is written last.
+ * The caller begins each section, then writes its values in order.
+ * Everything goes to a temporary file next to the target, synced then renamed over it by finish(): a previous file
+ * at the same path is replaced at once, and stays whole (and valid for whoever maps it) if the writing fails.
+ * Without POSIX, the file isn't synced, and the previous file is removed just before the rename (which doesn't
+ * replace an existing file everywhere).
+ * \exception runtime_error if the file can't be written
+ */
+class Graph_File_Writer {
+public:
+	Graph_File_Writer(const std::string &p_path, uint32_t p_config, uint32_t p_vertexSize, uint32_t p_nbVertices) :
+			m_file(NULL), m_pos(0), m_path(p_path) {
+		std::memset(&m_header, 0, sizeof(m_header));
+		std::memcpy(m_header.magic, "SGLG", sizeof(m_header.magic));
+		m_header.version = Graph_File_Header::VERSION;
+		m_header.byteOrder = Graph_File_Header::ORDER_MARK;
+		m_header.config = p_config;
+		m_header.vertexSize = p_vertexSize;
+		m_header.nbVertices = p_nbVertices;
+		_openTemporary();
+		try {
+			_write(&m_header, sizeof(m_header)); // placeholder
+		} catch (...) { // no destructor call for a throwing constructor
+			std::fclose(m_file);
+			std::remove(m_tmpPath.c_str());
+			throw;
+		}
+	}
+	Graph_File_Writer(const Graph_File_Writer &) = delete;
+	~Graph_File_Writer() {
+		if (m_file != NULL) { // not finished: the target is left as it was
+			std::fclose(m_file);
+			std::remove(m_tmpPath.c_str());
+		}
+	}
+	Graph_File_Writer &operator=(const Graph_File_Writer &) = delete;
+
+	/**
+	 * \brief Pads the file up to the next SECTION_ALIGNMENT boundary and starts a section there
+	 */
+	void beginSection(Graph_File_Header::Section p_section) {
+		static const char padding[Graph_File_Header::SECTION_ALIGNMENT] = {};
+
+		_write(padding, (Graph_File_Header::SECTION_ALIGNMENT - m_pos % Graph_File_Header::SECTION_ALIGNMENT) % Graph_File_Header::SECTION_ALIGNMENT);
+		m_header.sections[p_section] = m_pos;
+	}
+
+	template<typename U> void write(const U &p_value) { _write(&p_value, sizeof(U)); }
+	template<typename U> void write(const U *p_values, std::size_t p_nb) { _write(p_values, sizeof(U) * p_nb); }
+
+	/**
+	 * \brief Writes the header, syncs the temporary file to the disk and renames it over the target
+	 */
+	void finish(uint32_t p_nbEdges, uint64_t p_nbArcs, uint32_t p_rowWords, uint64_t p_fingerprint) {
+		m_header.nbEdges = p_nbEdges;
+		m_header.nbArcs = p_nbArcs;
+		m_header.rowWords = p_rowWords;
+		m_header.fingerprint = p_fingerprint;
+		m_header.fileSize = m_pos;
+		if (std::fseek(m_file, 0, SEEK_SET) != 0) {
+			throw std::runtime_error("save: can't write the file");
+		}
+		_write(&m_header, sizeof(m_header));
+		if (std::fflush(m_file) != 0) {
+			throw std::runtime_error("save: can't write the file");
+		}
+#if defined(__unix__) || defined(__APPLE__)
+		if (::fsync(fileno(m_file)) != 0) {
+			throw std::runtime_error("save: can't write the file");
+		}
+#endif
+		std::FILE *file = m_file;
+		const bool closed = std::fclose(file) == 0;
+
+		m_file = NULL;
+#if !defined(__unix__) && !defined(__APPLE__)
+		if (closed) {
+			std::remove(m_path.c_str());
+		}
+#endif
+		if (!closed || std::rename(m_tmpPath.c_str(), m_path.c_str()) != 0) {
+			std::remove(m_tmpPath.c_str());
+			throw std::runtime_error("save: can't write " + m_path);
+		}
+		_syncDirectory();
+	}
+
+private:
+	void _write(const void *p_data, std::size_t p_bytes) {
+		if (p_bytes > 0 && std::fwrite(p_data, 1, p_bytes, m_file) != p_bytes) {
+			throw std::runtime_error("save: can't write the file");
+		}
+		m_pos += p_bytes;
+	}
+
+	/**
+	 * \brief Creates a new temporary file in the directory of the target, named after it, the process and a counter
+	 */
+	void _openTemporary() {
+		static std::atomic<unsigned> counter(0);
+#if defined(__unix__) || defined(__APPLE__)
+		int fd = -1;
+
+		do {
+			m_tmpPath = m_path + ".tmp" + std::to_string(::getpid()) + "_" + std::to_string(counter++);
+			fd = ::open(m_tmpPath.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+		} while (fd < 0 && errno == EEXIST);
+		if (fd < 0 || (m_file = ::fdopen(fd, "wb")) == NULL) {
+			if (fd >= 0) {
+				::close(fd);
+				std::remove(m_tmpPath.c_str());
+			}
+			throw std::runtime_error("save: can't open " + m_path);
+		}
+#else
+		std::FILE *existing;
+
+		do { // a name nobody uses (not atomic: two processes could still pick the same one)
+			m_tmpPath = m_path + ".tmp" + std::to_string(counter++);
+			existing = std::fopen(m_tmpPath.c_str(), "rb");
+			if (existing != NULL) {
+				std::fclose(existing);
+			}
+		} while (existing != NULL);
+		m_file = std::fopen(m_tmpPath.c_str(), "wb");
+		if (m_file == NULL) {
+			throw std::runtime_error("save: can't open " + m_path);
+		}
+#endif
+	}
+
+	/**
+	 * \brief Makes the rename durable. The file is already complete under its name: a failure here isn't reported.
+	 */
+	void _syncDirectory() const {
+#if defined(__unix__) || defined(__APPLE__)
+		const std::size_t slash = m_path.rfind('/');
+		const std::string directory = slash == std::string::npos ? "." : m_path.substr(0, slash + 1);
+		int fd = ::open(directory.c_str(), O_RDONLY);
+
+		if (fd >= 0) {
+			::fsync(fd);
+			::close(fd);
+		}
+#endif
+	}
+
+	std::FILE *m_file; /*!< the temporary file, NULL once finished */
+	uint64_t m_pos; /*!< bytes written so far (not counting the final rewrite of the header) */
+	Graph_File_Header m_header;
+	std::string m_path; /*!< the target */
+	std::string m_tmpPath; /*!< the file actually written, renamed to m_path at the end */
+};
+
+} // namespace SGL
+
+#endif /* GRAPHFILE_H_ */
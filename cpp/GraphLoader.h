@@ -0,0 +1,119 @@
+//! \file GraphLoader.h
+//! \brief Parallel loading of a graph from a text file (SNAP-style edge list or Matrix Market)
+//! \version 0.1
+
+#ifndef GRAPHLOADER_H_
+#define GRAPHLOADER_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include "GraphBuilder.h"
+#include "Parallel.h"
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \class Graph_Loader
+ * \brief Reads a graph from a text file and builds it through a Graph_Builder, without any per-edge lookup.
+ * Two formats are understood:
+ * - EDGE_LIST, the SNAP style: one "source destination [weight]" line per edge, separated by blanks or a comma; the
+ *   lines starting with '#' or '%' are comments,
+ * - MATRIX_MARKET, the coordinate format of the .mtx files: the vertices are the row and column numbers (from 1 to
+ *   the greatest dimension, all of them added even if isolated, in this order), each entry is an edge, and the
+ *   entries of a symmetric matrix are edges both ways. The value of an entry is its weight (none in a pattern matrix).
+ *
+ * The file is read in chunks of whole lines, handed out to the threads one at a time: each thread parses its chunk
+ * with hand-written integer and decimal parsers into its own Graph_Builder::Producer while the next chunk is being read.
+ * The memory used for the text is bounded by the number of threads times the chunk size (plus the longest line),
+ * whatever the size of the file.
+ * In an edge list, the vertices are numbered in the order the threads meet them.
+ * The vertex type must be an integer type.
+ * The weights are only read into a weighted Adjacency_List or Adjacency_Matrix, anything else after the two vertices
+ * is skipped; an edge without a weight weighs Graph_Builder::DEFAULT_WEIGHT.
+ */
+template<typename T>
+class Graph_Loader {
+public:
+	enum Format {
+		EDGE_LIST, /*!< SNAP-style "source destination" lines */
+		MATRIX_MARKET /*!< Matrix Market coordinate format */
+	};
+
+	static const std::size_t DEFAULT_CHUNK_SIZE = 1u << 22; /*!< bytes of text per chunk */
+
+	explicit Graph_Loader(unsigned p_nbThreads = 0, std::size_t p_chunkSize = DEFAULT_CHUNK_SIZE);
+
+	template<typename Direction, typename Weighting, typename Allocator>
+	void load(const std::string &p_path, Adjacency_List<T, Direction, Weighting, Allocator> &, Format p_format = EDGE_LIST);
+	template<typename Direction, typename Weighting>
+	void load(const std::string &p_path, Adjacency_Matrix<T, Direction, Weighting> &, Format p_format = EDGE_LIST);
+	void load(const std::string &p_path, Compressed_Sparse_Row<T> &, Format p_format = EDGE_LIST);
+	void load(const std::string &p_path, Compressed_Graph<T> &, Format p_format = EDGE_LIST);
+
+private:
+	/**
+	 * \class Chunk_Reader
+	 * \brief Hands out the rest of a file in chunks of whole lines, to several threads (thread-safe)
+	 */
+	class Chunk_Reader {
+	public:
+		Chunk_Reader(std::FILE *p_file, const std::string &p_path, std::size_t p_chunkSize) :
+				m_file(p_file), m_path(p_path), m_chunkSize(p_chunkSize), m_eof(false) {}
+
+		bool next(std::vector<char> &);
+		void stop();
+
+	private:
+		std::FILE *m_file;
+		const std::string &m_path;
+		std::size_t m_chunkSize;
+		bool m_eof;
+		std::vector<char> m_carry; /*!< the unfinished line at the end of the last chunk */
+		std::mutex m_mutex;
+	};
+
+	/**
+	 * \brief What the parsing threads need to know about the file
+	 */
+	struct Layout {
+		Format m_format;
+		bool m_mirror; /*!< add each entry both ways (symmetric matrix loaded in a directed graph) */
+		bool m_skew; /*!< the mirrored entries have the opposite weight (skew-symmetric matrix) */
+		bool m_weighted; /*!< read the number after the two vertices as the weight of the edge */
+		uint64_t m_nbRows; /*!< Matrix Market only: bounds of the indexes */
+		uint64_t m_nbColumns;
+		uint64_t m_nbEntries; /*!< Matrix Market only: number of entries announced by the size line */
+	};
+
+	Graph_Loader(const Graph_Loader &);
+	Graph_Loader &operator=(const Graph_Loader &);
+
+	void _read(const std::string &p_path, Format, bool p_undirected, bool p_weighted, Graph_Builder<T> &) const;
+	static void _readHeader(std::FILE *, const std::string &p_path, Layout &, bool p_undirected);
+	static uint64_t _parseChunk(const char *p_begin, const char *p_end, const Layout &,
+			typename Graph_Builder<T>::Producer &, const std::string &p_path);
+	static const char *_parseVertex(const char *p_pos, const char *p_end, T &);
+	static const char *_parseWeight(const char *p_pos, const char *p_end, double &);
+	static bool _isBlank(char p_c) { return p_c == ' ' || p_c == '\t' || p_c == ',' || p_c == '\r'; }
+	static const char *_skipBlanks(const char *p_pos, const char *p_end) {
+		while (p_pos < p_end && _isBlank(*p_pos)) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+	unsigned m_nbThreads;
+
+	std::size_t m_chunkSize;
+};
+
+}
+
+#include "GraphLoader.hpp"
+
+#endif /* GRAPHLOADER_H_ */
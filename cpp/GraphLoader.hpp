@@ -0,0 +1,400 @@
+//! \file GraphLoader.hpp
+//! \brief Implementation of the text file loader
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm> // std::max
+
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+
+using namespace std;
+
+namespace SGL {
+
+template<typename T>
+const std::size_t Graph_Loader<T>::DEFAULT_CHUNK_SIZE;
+
+/**
+ * \brief Constructor
+ * \param[in] p_nbThreads the number of threads parsing the file and building the graph, 0 for the number of cores
+ * \param[in] p_chunkSize the number of bytes read at once by a thread
+ */
+template<typename T>
+Graph_Loader<T>::Graph_Loader(unsigned p_nbThreads, std::size_t p_chunkSize) :
+		m_nbThreads(p_nbThreads), m_chunkSize(std::max<std::size_t>(1, p_chunkSize)) {
+	static_assert(std::is_integral<T>::value, "Graph_Loader: the vertices of a text file are integers");
+}
+
+/**
+ * \brief Fills an empty adjacency list with the graph of a file
+ * \param[in] p_path the file to read
+ * \param[out] p_list the graph to fill, whose configuration gives the direction, and which gets the weights of the
+ * file if it's weighted
+ * \param[in] p_format the format of the file
+ * \exception runtime_error if the file can't be read or isn't in the given format
+ * \exception logic_error if p_list isn't empty
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename T>
+template<typename Direction, typename Weighting, typename Allocator>
+void Graph_Loader<T>::load(const std::string &p_path, Adjacency_List<T, Direction, Weighting, Allocator> &p_list, Format p_format) {
+	Graph_Builder<T> builder(m_nbThreads);
+
+	if (p_list.nbVertices() > 0) {
+		throw logic_error("load: the graph isn't empty");
+	}
+	_read(p_path, p_format, p_list.hasConfiguration(UNDIRECTED), Weighting::isWeighted, builder);
+	builder.build(p_list);
+}
+
+/**
+ * \brief Fills an empty adjacency matrix with the graph of a file
+ * \see load(const std::string &, Adjacency_List &, Format)
+ */
+template<typename T>
+template<typename Direction, typename Weighting>
+void Graph_Loader<T>::load(const std::string &p_path, Adjacency_Matrix<T, Direction, Weighting> &p_matrix, Format p_format) {
+	Graph_Builder<T> builder(m_nbThreads);
+
+	if (p_matrix.nbVertices() > 0) {
+		throw logic_error("load: the graph isn't empty");
+	}
+	_read(p_path, p_format, p_matrix.hasConfiguration(UNDIRECTED), Weighting::isWeighted, builder);
+	builder.build(p_matrix);
+}
+
+/**
+ * \brief Fills an empty compressed sparse row graph with the graph of a file
+ * \see load(const std::string &, Adjacency_List &, Format)
+ */
+template<typename T>
+void Graph_Loader<T>::load(const std::string &p_path, Compressed_Sparse_Row<T> &p_graph, Format p_format) {
+	Graph_Builder<T> builder(m_nbThreads);
+
+	if (p_graph.nbVertices() > 0) {
+		throw logic_error("load: the graph isn't empty");
+	}
+	_read(p_path, p_format, p_graph.hasConfiguration(UNDIRECTED), false, builder);
+	builder.build(p_graph);
+}
+
+/**
+ * \brief Fills an empty compressed graph with the graph of a file
+ * \see load(const std::string &, Adjacency_List &, Format)
+ */
+template<typename T>
+void Graph_Loader<T>::load(const std::string &p_path, Compressed_Graph<T> &p_graph, Format p_format) {
+	Graph_Builder<T> builder(m_nbThreads);
+
+	if (p_graph.nbVertices() > 0) {
+		throw logic_error("load: the graph isn't empty");
+	}
+	_read(p_path, p_format, p_graph.hasConfiguration(UNDIRECTED), false, builder);
+	builder.build(p_graph);
+}
+
+/**
+ * \brief Reads the whole file into the builder: the header first (Matrix Market), then the chunks in parallel,
+ * each thread feeding its own producer
+ */
+template<typename T>
+void Graph_Loader<T>::_read(const std::string &p_path, Format p_format, bool p_undirected, bool p_weighted, Graph_Builder<T> &p_builder) const {
+	std::unique_ptr<std::FILE, int (*)(std::FILE *)> file(std::fopen(p_path.c_str(), "rb"), &std::fclose);
+	Layout layout = { p_format, false, false, p_weighted, 0, 0, 0 };
+
+	if (!file) {
+		throw runtime_error("load: can't open " + p_path);
+	}
+	if (p_format == MATRIX_MARKET) {
+		typename Graph_Builder<T>::Producer producer(p_builder); // flushed first: its vertices come first
+
+		_readHeader(file.get(), p_path, layout, p_undirected);
+		for (uint64_t v = 1; v <= std::max(layout.m_nbRows, layout.m_nbColumns); v++) {
+			producer.addVertex(static_cast<T>(v));
+		}
+	}
+
+	Chunk_Reader reader(file.get(), p_path, m_chunkSize);
+	atomic<uint64_t> nbEntries(0);
+
+	runInParallel(p_builder.nbThreads(), p_builder.nbThreads(), [&](unsigned) {
+		typename Graph_Builder<T>::Producer producer(p_builder);
+		vector<char> chunk;
+
+		try {
+			while (reader.next(chunk)) {
+				nbEntries += _parseChunk(chunk.data(), chunk.data() + chunk.size(), layout, producer, p_path);
+			}
+		} catch (...) {
+			reader.stop(); // the other threads have nothing more to do
+			throw;
+		}
+	});
+	if (p_format == MATRIX_MARKET && nbEntries != layout.m_nbEntries) {
+		throw runtime_error("load: " + p_path + " doesn't have the number of entries of its size line");
+	}
+}
+
+/**
+ * \brief Reads the banner, the comments and the size line of a Matrix Market file, and leaves the file at the
+ * first entry
+ */
+template<typename T>
+void Graph_Loader<T>::_readHeader(std::FILE *p_file, const std::string &p_path, Layout &p_layout, bool p_undirected) {
+	string line;
+	auto readLine = [&]() {
+		int c;
+
+		line.clear();
+		while ((c = std::getc(p_file)) != EOF && c != '\n') {
+			line += static_cast<char>(std::tolower(c));
+		}
+		return c != EOF || !line.empty();
+	};
+	string tag, object, format, field, symmetry;
+
+	if (readLine()) {
+		istringstream(line) >> tag >> object >> format >> field >> symmetry;
+	}
+	if (tag != "%%matrixmarket" || object != "matrix") {
+		throw runtime_error("load: " + p_path + " isn't a Matrix Market file");
+	}
+	if (format != "coordinate") {
+		throw runtime_error("load: " + p_path + " isn't in the Matrix Market coordinate format");
+	}
+	if (symmetry != "general" && symmetry != "symmetric" && symmetry != "skew-symmetric" && symmetry != "hermitian") {
+		throw runtime_error("load: unknown Matrix Market symmetry in " + p_path);
+	}
+	p_layout.m_mirror = (symmetry != "general" && !p_undirected);
+	p_layout.m_skew = (symmetry == "skew-symmetric");
+	p_layout.m_weighted &= (field != "pattern");
+	do {
+		if (!readLine()) {
+			throw runtime_error("load: " + p_path + " has no size line");
+		}
+	} while (line.find_first_not_of(" \t\r") == string::npos || line[0] == '%');
+	if (!(istringstream(line) >> p_layout.m_nbRows >> p_layout.m_nbColumns >> p_layout.m_nbEntries)) {
+		throw runtime_error("load: bad size line in " + p_path);
+	}
+	if (std::max(p_layout.m_nbRows, p_layout.m_nbColumns) > static_cast<uint64_t>(numeric_limits<T>::max())) {
+		throw runtime_error("load: the vertex type is too small for the matrix of " + p_path);
+	}
+}
+
+/**
+ * \brief Replaces the content of p_chunk with the next whole lines of the file (the last line may have no end of line)
+ * \return false once the file is over
+ * \exception runtime_error if the file can't be read
+ */
+template<typename T>
+bool Graph_Loader<T>::Chunk_Reader::next(std::vector<char> &p_chunk) {
+	lock_guard<mutex> lock(m_mutex);
+	std::size_t end = 0;
+
+	p_chunk.swap(m_carry); // the chunk starts with the unfinished line of the previous one
+	m_carry.clear();
+	while (end == 0) { // until a whole line is read: a line may be longer than a chunk
+		if (m_eof) {
+			return !p_chunk.empty();
+		}
+		std::size_t size = p_chunk.size();
+
+		p_chunk.resize(size + m_chunkSize);
+		std::size_t read = std::fread(p_chunk.data() + size, 1, m_chunkSize, m_file);
+
+		p_chunk.resize(size + read);
+		if (read < m_chunkSize) {
+			if (std::ferror(m_file)) {
+				throw runtime_error("load: can't read " + m_path);
+			}
+			m_eof = true; // the last line may have no end of line
+			return !p_chunk.empty();
+		}
+		for (end = p_chunk.size(); end > size && p_chunk[end - 1] != '\n'; end--) {
+		}
+		if (end == size) { // no end of line in what was just read
+			end = 0;
+		}
+	}
+	m_carry.assign(p_chunk.begin() + end, p_chunk.end());
+	p_chunk.resize(end);
+	return true;
+}
+
+/**
+ * \brief Makes next() return false from now on
+ */
+template<typename T>
+void Graph_Loader<T>::Chunk_Reader::stop() {
+	lock_guard<mutex> lock(m_mutex);
+
+	m_eof = true;
+	m_carry.clear();
+}
+
+/**
+ * \brief Parses whole lines into the producer
+ * \return the number of edges read (entries of a Matrix Market file)
+ * \exception runtime_error on a line that isn't a pair of vertices or a comment
+ */
+template<typename T>
+uint64_t Graph_Loader<T>::_parseChunk(const char *p_begin, const char *p_end, const Layout &p_layout,
+		typename Graph_Builder<T>::Producer &p_producer, const std::string &p_path) {
+	uint64_t nbEntries = 0;
+
+	for (const char *line = p_begin; line < p_end; ) {
+		const char *eol = static_cast<const char *>(std::memchr(line, '\n', p_end - line));
+		const char *pos;
+		T src, dest;
+
+		if (eol == NULL) {
+			eol = p_end;
+		}
+		pos = _skipBlanks(line, eol);
+		if (pos != eol && *pos != '#' && *pos != '%') {
+			bool weighted = false;
+			double weight = 0;
+
+			pos = _parseVertex(pos, eol, src);
+			if (pos != NULL) {
+				pos = _parseVertex(_skipBlanks(pos, eol), eol, dest);
+			}
+			// the weight, if the graph has some and the line too; whatever follows is skipped
+			if (pos != NULL && p_layout.m_weighted) {
+				pos = _skipBlanks(pos, eol);
+				weighted = (pos != eol);
+				if (weighted) {
+					pos = _parseWeight(pos, eol, weight);
+				}
+			}
+			if (pos == NULL) {
+				throw runtime_error("load: can't parse the line \"" + string(line, eol) + "\" of " + p_path);
+			}
+			if (p_layout.m_format == MATRIX_MARKET && (src < 1 || dest < 1 || static_cast<uint64_t>(src) > p_layout.m_nbRows
+					|| static_cast<uint64_t>(dest) > p_layout.m_nbColumns)) {
+				throw runtime_error("load: the entry \"" + string(line, eol) + "\" of " + p_path + " is out of the matrix");
+			}
+			if (!weighted) {
+				p_producer.addEdge(src, dest);
+				if (p_layout.m_mirror && src != dest) {
+					p_producer.addEdge(dest, src);
+				}
+			} else {
+				p_producer.addEdge(src, dest, weight);
+				if (p_layout.m_mirror && src != dest) {
+					p_producer.addEdge(dest, src, p_layout.m_skew ? -weight : weight);
+				}
+			}
+			nbEntries++;
+		}
+		line = eol + 1;
+	}
+	return nbEntries;
+}
+
+/**
+ * \brief Parses a decimal integer followed by a blank or the end of the line
+ * \return the position after the integer, NULL if there is no integer there or if it doesn't fit in T
+ */
+template<typename T>
+const char *Graph_Loader<T>::_parseVertex(const char *p_pos, const char *p_end, T &p_v) {
+	const bool negative = std::is_signed<T>::value && p_pos < p_end && *p_pos == '-';
+	const uint64_t max = static_cast<uint64_t>(numeric_limits<T>::max()) + negative;
+	const char *digits = p_pos + negative;
+	uint64_t value = 0;
+
+	for (p_pos = digits; p_pos < p_end && *p_pos >= '0' && *p_pos <= '9'; p_pos++) {
+		unsigned digit = *p_pos - '0';
+
+		if (value > (max - digit) / 10) {
+			return NULL;
+		}
+		value = value * 10 + digit;
+	}
+	if (p_pos == digits || (p_pos < p_end && !_isBlank(*p_pos))) {
+		return NULL;
+	}
+	if (negative && value > 0) {
+		p_v = static_cast<T>(-static_cast<T>(value - 1) - 1); // -(max + 1) fits in T, max + 1 doesn't
+	} else {
+		p_v = static_cast<T>(value);
+	}
+	return p_pos;
+}
+
+/**
+ * \brief Parses a decimal number ("-12", "0.25", "1.5e-3"...) followed by a blank or the end of the line.
+ * Up to 19 significant digits with a decimal exponent up to 22 are converted exactly with one multiplication or
+ * division; the other numbers, rare in graph files, go through strtod.
+ * \return the position after the number, NULL if there is no number there
+ */
+template<typename T>
+const char *Graph_Loader<T>::_parseWeight(const char *p_pos, const char *p_end, double &p_weight) {
+	static const double POWERS[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+			1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	const bool negative = p_pos < p_end && *p_pos == '-';
+	const char *start = p_pos + (p_pos < p_end && (*p_pos == '-' || *p_pos == '+')); // the number without its sign
+	uint64_t mantissa = 0;
+	unsigned nbDigits = 0; // significant digits in the mantissa
+	int exponent = 0;
+	bool exact = true;
+	bool digits = false;
+
+	p_pos = start;
+	for (bool fraction = false; p_pos < p_end; p_pos++) {
+		if (*p_pos == '.' && !fraction) {
+			fraction = true;
+			continue;
+		}
+		if (*p_pos < '0' || *p_pos > '9') {
+			break;
+		}
+		digits = true;
+		if (nbDigits < 19) {
+			mantissa = mantissa * 10 + (*p_pos - '0');
+			nbDigits += (mantissa > 0);
+			exponent -= fraction;
+		} else {
+			exact &= (*p_pos == '0');
+			exponent += !fraction;
+		}
+	}
+	if (!digits) {
+		return NULL;
+	}
+	if (p_pos < p_end && (*p_pos == 'e' || *p_pos == 'E')) {
+		const bool negativeExponent = p_pos + 1 < p_end && p_pos[1] == '-';
+		const char *exponentDigits = p_pos + 1 + (p_pos + 1 < p_end && (p_pos[1] == '-' || p_pos[1] == '+'));
+		int value = 0;
+
+		for (p_pos = exponentDigits; p_pos < p_end && *p_pos >= '0' && *p_pos <= '9'; p_pos++) {
+			value = std::min(value * 10 + (*p_pos - '0'), 100000);
+		}
+		if (p_pos == exponentDigits) {
+			return NULL;
+		}
+		exponent += negativeExponent ? -value : value;
+	}
+	if (p_pos < p_end && !_isBlank(*p_pos)) {
+		return NULL;
+	}
+	if (exact && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+		// both operands are exact doubles: the result is correctly rounded
+		p_weight = (exponent < 0) ? mantissa / POWERS[-exponent] : mantissa * POWERS[exponent];
+	} else {
+		p_weight = std::strtod(string(start, p_pos).c_str(), NULL);
+	}
+	if (negative) {
+		p_weight = -p_weight;
+	}
+	return p_pos;
+}
+
+} // namespace SGL
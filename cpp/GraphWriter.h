@@ -0,0 +1,172 @@
+//! \file GraphWriter.h
+//! \brief Streaming export of a graph as GraphViz DOT, edge list or adjacency text
+//! \version 0.1
+
+#ifndef GRAPHWRITER_H_
+#define GRAPHWRITER_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Algorithms.h"
+#include "AdjacencyList.h"
+#include "Parallel.h"
+#include "VertexIndex.h"
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \class Output_Buffer
+ * \brief Character buffer in front of an output stream: the text is appended in memory and handed to the stream
+ * in blocks of (at least) the capacity, so the stream is called once per block instead of once per value.
+ * Without a stream, the buffer only grows: the parallel writers format their chunks in such buffers.
+ * Nothing is written by the destructor: call flush() at the end.
+ */
+class Output_Buffer {
+public:
+	static const std::size_t DEFAULT_CAPACITY = 1u << 20;
+
+	explicit Output_Buffer(std::ostream *p_stream = NULL, std::size_t p_capacity = DEFAULT_CAPACITY) :
+			m_stream(p_stream), m_capacity(p_capacity) {
+		if (m_stream != NULL) {
+			m_data.reserve(m_capacity);
+		}
+	}
+
+	inline const char *data() const { return m_data.data(); }
+	inline std::size_t size() const { return m_data.size(); }
+	inline void clear() { m_data.clear(); }
+
+	void put(char p_c) {
+		m_data.push_back(p_c);
+		_check();
+	}
+	void put(const char *p_text, std::size_t p_size) {
+		m_data.insert(m_data.end(), p_text, p_text + p_size);
+		_check();
+	}
+	void put(const std::string &p_text) { put(p_text.data(), p_text.size()); }
+
+	/**
+	 * \brief Appends an integer in decimal, without going through a locale or a stream
+	 */
+	template<typename U>
+	void putInteger(U p_value) {
+		typedef typename std::make_unsigned<U>::type Unsigned;
+		char digits[3 * sizeof(U) + 1];
+		char *pos = digits + sizeof(digits);
+		const bool negative = _isNegative(p_value, std::is_signed<U>());
+		Unsigned magnitude = negative ? Unsigned(0) - static_cast<Unsigned>(p_value) : static_cast<Unsigned>(p_value);
+
+		do {
+			*--pos = static_cast<char>('0' + magnitude % 10);
+			magnitude /= 10;
+		} while (magnitude != 0);
+		if (negative) {
+			*--pos = '-';
+		}
+		put(pos, digits + sizeof(digits) - pos);
+	}
+
+	/**
+	 * \brief Hands the buffered text over to the stream (if any)
+	 * \exception runtime_error if the stream fails
+	 */
+	void flush() {
+		if (m_stream != NULL && !m_data.empty()) {
+			m_stream->write(m_data.data(), m_data.size());
+			m_data.clear();
+			if (!*m_stream) {
+				throw std::runtime_error("write: can't write the output");
+			}
+		}
+	}
+
+private:
+	template<typename U> static bool _isNegative(U p_value, std::true_type) { return p_value < 0; }
+	template<typename U> static bool _isNegative(U, std::false_type) { return false; }
+
+	void _check() {
+		if (m_stream != NULL && m_data.size() >= m_capacity) {
+			flush();
+		}
+	}
+
+	std::ostream *m_stream;
+	std::size_t m_capacity;
+	std::vector<char> m_data;
+};
+
+/**
+ * \class Graph_Writer
+ * \brief Writes a graph as text, walking its adjacency through the descriptor interface (see Is_Static_Graph):
+ * nothing like edges() is built, and the text goes out through an Output_Buffer.
+ * Three formats are available:
+ * - DOT, for GraphViz: a "digraph" or a "graph", every vertex declared (so the isolated ones show), then its edges,
+ * - EDGE_LIST, SNAP style ("source destination" lines after a '#' comment), readable by Graph_Loader,
+ * - ADJACENCY, one "vertex: neighbor neighbor..." line per vertex.
+ * In DOT and EDGE_LIST, an undirected edge is written once.
+ * The integer vertices are formatted by hand; the others go through their operator<< once each, before the edges
+ * (and are quoted in DOT).
+ * With several threads, the vertices are cut into chunks formatted in parallel, a few at a time, and written in order:
+ * the memory used is a few chunks of text, whatever the size of the graph. The output is the same in any case.
+ */
+template<typename Graph>
+class Graph_Writer {
+public:
+	typedef typename Graph::vertex_type vertex_type;
+
+	enum Format {
+		DOT, /*!< GraphViz */
+		EDGE_LIST, /*!< "source destination" lines */
+		ADJACENCY /*!< "vertex: neighbors" lines */
+	};
+
+	explicit Graph_Writer(const Graph &p_graph, unsigned p_nbThreads = 1,
+			std::size_t p_bufferSize = Output_Buffer::DEFAULT_CAPACITY);
+
+	void write(std::ostream &, Format) const;
+	void write(const std::string &p_path, Format) const;
+
+private:
+	typedef typename std::is_integral<vertex_type>::type Integral_Vertices;
+
+	static const unsigned CHUNK_SIZE = 1u << 12; /*!< vertices per task of the parallel formatting */
+
+	Graph_Writer(const Graph_Writer &);
+	Graph_Writer &operator=(const Graph_Writer &);
+
+	void _makeLabels(std::vector<std::string> &, Format, std::true_type) const {}
+	void _makeLabels(std::vector<std::string> &, Format, std::false_type) const;
+	void _putVertex(Output_Buffer &p_out, const std::vector<std::string> &, unsigned p_idx, std::true_type) const {
+		p_out.putInteger(m_graph.value(Vertex_Descriptor(p_idx)));
+	}
+	void _putVertex(Output_Buffer &p_out, const std::vector<std::string> &p_labels, unsigned p_idx, std::false_type) const {
+		p_out.put(p_labels[p_idx]);
+	}
+	void _format(Output_Buffer &, Format, const std::vector<std::string> &p_labels, unsigned p_begin, unsigned p_end) const;
+
+	/**
+	 * \brief Whether an index is a vertex of the graph: always, but for the tombstones of an Adjacency_List
+	 */
+	template<typename G> static bool _isVertex(const G &, unsigned) { return true; }
+	template<typename U, typename Direction, typename Weighting, typename Allocator>
+	static bool _isVertex(const Adjacency_List<U, Direction, Weighting, Allocator> &p_list, unsigned p_idx) {
+		return !p_list.m_nodes[p_idx].m_deleted;
+	}
+
+	const Graph &m_graph;
+	unsigned m_nbThreads;
+	std::size_t m_bufferSize;
+};
+
+}
+
+#include "GraphWriter.hpp"
+
+#endif /* GRAPHWRITER_H_ */
@@ -0,0 +1,185 @@
+//! \file GraphWriter.hpp
+//! \brief Implementation of the graph writer
+//! \version 0.1
+
+#include <algorithm> // std::min
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace SGL {
+
+template<typename Graph>
+const unsigned Graph_Writer<Graph>::CHUNK_SIZE;
+
+/**
+ * \brief Constructor
+ * \param[in] p_graph the graph to write, which mustn't change while it's being written
+ * \param[in] p_nbThreads the number of threads formatting the text, 0 for the number of cores
+ * \param[in] p_bufferSize the number of bytes handed to the output stream at once
+ */
+template<typename Graph>
+Graph_Writer<Graph>::Graph_Writer(const Graph &p_graph, unsigned p_nbThreads, std::size_t p_bufferSize) :
+		m_graph(p_graph), m_nbThreads(defaultThreads(p_nbThreads)), m_bufferSize(p_bufferSize) {
+	static_assert(Is_Static_Graph<Graph>::value, "Graph_Writer: the graph doesn't provide the descriptor interface");
+}
+
+/**
+ * \brief Writes the graph to a stream
+ * \param[out] p_stream the output stream
+ * \param[in] p_format the text format
+ * \exception runtime_error if the stream fails
+ * \exception bad_alloc in case of insufficient memory
+ */
+template<typename Graph>
+void Graph_Writer<Graph>::write(std::ostream &p_stream, Format p_format) const {
+	const bool undirected = m_graph.hasConfiguration(UNDIRECTED);
+	const unsigned bound = m_graph.indexBound();
+	Output_Buffer out(&p_stream, m_bufferSize);
+	vector<string> labels;
+
+	_makeLabels(labels, p_format, Integral_Vertices());
+	if (p_format == DOT) {
+		out.put(undirected ? "graph {\n" : "digraph {\n");
+	} else if (p_format == EDGE_LIST) {
+		out.put(undirected ? "# Undirected graph, each edge once: " : "# Directed graph: ");
+		out.putInteger(m_graph.nbVertices());
+		out.put(" vertices\n");
+	}
+	if (m_nbThreads <= 1 || bound <= CHUNK_SIZE) {
+		_format(out, p_format, labels, 0, bound);
+	} else {
+		// a round formats a few chunks per thread in parallel, then writes them in order
+		const unsigned nbChunks = (bound + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		vector<Output_Buffer> pieces(2 * m_nbThreads);
+
+		for (unsigned first = 0; first < nbChunks; first += pieces.size()) {
+			unsigned nbPieces = std::min<unsigned>(pieces.size(), nbChunks - first);
+
+			runInParallel(m_nbThreads, nbPieces, [&](unsigned p_piece) {
+				unsigned begin = (first + p_piece) * CHUNK_SIZE;
+
+				pieces[p_piece].clear();
+				_format(pieces[p_piece], p_format, labels, begin, std::min(bound, begin + CHUNK_SIZE));
+			});
+			for (unsigned piece = 0; piece < nbPieces; piece++) {
+				out.put(pieces[piece].data(), pieces[piece].size());
+			}
+		}
+	}
+	if (p_format == DOT) {
+		out.put("}\n");
+	}
+	out.flush();
+	p_stream.flush();
+	if (!p_stream) {
+		throw runtime_error("write: can't write the output");
+	}
+}
+
+/**
+ * \brief Writes the graph to a file, replaced if it exists
+ * \see write(std::ostream &, Format)
+ * \exception runtime_error if the file can't be written
+ */
+template<typename Graph>
+void Graph_Writer<Graph>::write(const std::string &p_path, Format p_format) const {
+	ofstream file(p_path.c_str(), ios::binary | ios::trunc);
+
+	if (!file) {
+		throw runtime_error("write: can't open " + p_path);
+	}
+	write(file, p_format);
+	file.close();
+	if (!file) {
+		throw runtime_error("write: can't write " + p_path);
+	}
+}
+
+/**
+ * \brief Formats each vertex once with its operator<<, quoted and escaped for DOT
+ */
+template<typename Graph>
+void Graph_Writer<Graph>::_makeLabels(std::vector<std::string> &p_labels, Format p_format, std::false_type) const {
+	p_labels.resize(m_graph.indexBound());
+	for (unsigned v = 0; v < p_labels.size(); v++) {
+		if (!_isVertex(m_graph, v)) {
+			continue;
+		}
+		ostringstream stream;
+
+		stream << m_graph.value(Vertex_Descriptor(v));
+		if (p_format != DOT) {
+			p_labels[v] = stream.str();
+			continue;
+		}
+		const string text = stream.str();
+
+		p_labels[v].reserve(text.size() + 2);
+		p_labels[v] += '"';
+		for (unsigned pos = 0; pos < text.size(); pos++) {
+			if (text[pos] == '"' || text[pos] == '\\') {
+				p_labels[v] += '\\';
+			}
+			p_labels[v] += text[pos];
+		}
+		p_labels[v] += '"';
+	}
+}
+
+/**
+ * \brief Formats the vertices of indexes p_begin to p_end - 1 (and their edges)
+ */
+template<typename Graph>
+void Graph_Writer<Graph>::_format(Output_Buffer &p_out, Format p_format, const std::vector<std::string> &p_labels,
+		unsigned p_begin, unsigned p_end) const {
+	typedef typename Graph::adjacent_range Adjacents;
+	const bool undirected = m_graph.hasConfiguration(UNDIRECTED);
+	const char *arrow = undirected ? " -- " : " -> ";
+
+	for (unsigned v = p_begin; v < p_end; v++) {
+		if (!_isVertex(m_graph, v)) {
+			continue;
+		}
+		Adjacents adjacents = m_graph.neighbors(Vertex_Descriptor(v));
+
+		if (p_format == DOT) {
+			p_out.put('\t');
+			_putVertex(p_out, p_labels, v, Integral_Vertices());
+			p_out.put(";\n", 2);
+		} else if (p_format == ADJACENCY) {
+			_putVertex(p_out, p_labels, v, Integral_Vertices());
+			p_out.put(':');
+		}
+		for (typename Adjacents::iterator it = adjacents.begin(); it != adjacents.end(); ++it) {
+			unsigned dest = (*it).index();
+
+			if (p_format == ADJACENCY) {
+				p_out.put(' ');
+				_putVertex(p_out, p_labels, dest, Integral_Vertices());
+				continue;
+			}
+			if (undirected && dest < v) { // written from the other end
+				continue;
+			}
+			if (p_format == DOT) {
+				p_out.put('\t');
+				_putVertex(p_out, p_labels, v, Integral_Vertices());
+				p_out.put(arrow, 4);
+				_putVertex(p_out, p_labels, dest, Integral_Vertices());
+				p_out.put(";\n", 2);
+			} else {
+				_putVertex(p_out, p_labels, v, Integral_Vertices());
+				p_out.put('\t');
+				_putVertex(p_out, p_labels, dest, Integral_Vertices());
+				p_out.put('\n');
+			}
+		}
+		if (p_format == ADJACENCY) {
+			p_out.put('\n');
+		}
+	}
+}
+
+} // namespace SGL
@@ -0,0 +1,226 @@
+//! \file MappedGraph.h
+//! \brief Declaration of a read-only graph served straight from a memory-mapped graph file
+//! \version 0.1
+
+#ifndef MAPPEDGRAPH_H_
+#define MAPPEDGRAPH_H_
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ReadOnlyGraph.h"
+#include "VertexIndex.h"
+#include "GraphFile.h"
+#include "Range.h"
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \class File_Mapping
+ * \brief Read-only memory mapping of a whole file (POSIX mmap), unmapped by the destructor. Movable, not copyable.
+ * The pages are loaded by the system when they are first touched, and shared with the other processes mapping the
+ * same file.
+ */
+class File_Mapping {
+public:
+	File_Mapping() : m_data(NULL), m_size(0) {}
+
+	/**
+	 * \exception runtime_error if the file can't be opened or mapped
+	 */
+	explicit File_Mapping(const std::string &p_path) : m_data(NULL), m_size(0) {
+		int fd = ::open(p_path.c_str(), O_RDONLY);
+		struct stat info;
+
+		if (fd < 0) {
+			throw std::runtime_error("mapFile: can't open " + p_path);
+		}
+		if (::fstat(fd, &info) != 0) {
+			::close(fd);
+			throw std::runtime_error("mapFile: can't read " + p_path);
+		}
+		m_size = info.st_size;
+		if (m_size > 0) {
+			void *data = ::mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0);
+
+			if (data == MAP_FAILED) {
+				::close(fd);
+				throw std::runtime_error("mapFile: can't map " + p_path);
+			}
+			m_data = static_cast<const char *>(data);
+		}
+		::close(fd); // the mapping keeps the file open
+	}
+	File_Mapping(const File_Mapping &) = delete;
+	File_Mapping(File_Mapping &&p_src) : m_data(p_src.m_data), m_size(p_src.m_size) {
+		p_src.m_data = NULL;
+		p_src.m_size = 0;
+	}
+	~File_Mapping() { _unmap(); }
+	File_Mapping &operator=(const File_Mapping &) = delete;
+	File_Mapping &operator=(File_Mapping &&p_src) {
+		File_Mapping moved(std::move(p_src));
+
+		swap(moved);
+		return (*this);
+	}
+
+	inline const char *data() const { return m_data; }
+	inline std::size_t size() const { return m_size; }
+
+	void swap(File_Mapping &p_other) {
+		std::swap(m_data, p_other.m_data);
+		std::swap(m_size, p_other.m_size);
+	}
+
+private:
+	void _unmap() {
+		if (m_data != NULL) {
+			::munmap(const_cast<char *>(m_data), m_size);
+		}
+	}
+
+	const char *m_data;
+	std::size_t m_size;
+};
+
+/**
+ * \class Mapped_Graph
+ * \brief Read-only graph whose arrays are the sections of a graph file (see GraphFile.h) mapped in memory.
+ * The file is written by the save() method of an Adjacency_List or an Adjacency_Matrix. mapFile() checks its header
+ * and points into the mapping: nothing is parsed nor copied, and the pages are only read from the disk when the
+ * queries first touch them. The only O(V) step is the hash index of the vertices, which the descriptor-based
+ * methods don't use.
+ * It has the interface of a Compressed_Sparse_Row (same numbering of the edges, same degrees). hasEdge is O(1) when
+ * the file was saved from a matrix (its bit matrix is in the file), a binary search otherwise.
+ * The vertex type must be trivially copyable, and the file must come from a machine with the same byte order.
+ * The file isn't checked beyond its header and the sizes of its sections: only map the files you saved.
+ * All the mutators throw a logic_error.
+ */
+template<typename T>
+class Mapped_Graph : public Read_Only_Graph<T, Mapped_Graph<T> > {
+	static_assert(std::is_trivially_copyable<T>::value, "Mapped_Graph: the vertex type must be trivially copyable");
+	static_assert(Graph_File_Header::SECTION_ALIGNMENT % alignof(T) == 0, "Mapped_Graph: the vertex type is over-aligned");
+
+	class AdjacentCursor;
+
+public:
+	typedef Range<Range_Iterator<AdjacentCursor> > adjacent_range; /*!< lazy range of Vertex_Descriptor */
+
+	////////////////////////////////////////////////////////////////
+	// Coplien Form
+	////////////////////////////////////////////////////////////////
+	Mapped_Graph();
+	explicit Mapped_Graph(const std::string &p_path);
+	Mapped_Graph(const Mapped_Graph &) = delete;
+	Mapped_Graph(Mapped_Graph &&);
+	~Mapped_Graph() {}
+	Mapped_Graph &operator=(const Mapped_Graph &) = delete;
+	Mapped_Graph &operator=(Mapped_Graph &&);
+
+	void mapFile(const std::string &p_path);
+
+	////////////////////////////////////////////////////////////////
+	// Getters (const)
+	////////////////////////////////////////////////////////////////
+	using Read_Only_Graph<T, Mapped_Graph>::hasConfiguration;
+	using Read_Only_Graph<T, Mapped_Graph>::hasEdge;
+
+	/**
+	 * \brief Fingerprint of the saved graph, stored in the file: O(1)
+	 */
+	inline uint64_t fingerprint() const { return m_fingerprint; }
+
+	std::vector<T> vertexNeighborhood(const T&, bool p_closed = false) const;
+	std::vector<T> vertices() const;
+	std::vector<std::pair<T, T> > edges() const;
+
+	////////////////////////////////////////////////////////////////
+	// Vertex descriptors: no vertex lookup
+	////////////////////////////////////////////////////////////////
+	/**
+	 * \brief Returns the data of a vertex from its descriptor
+	 * \pre p_vd is a valid descriptor of this graph
+	 */
+	inline const T &value(Vertex_Descriptor p_vd) const { return m_elems[p_vd.index()]; }
+
+	/**
+	 * \brief Upper bound of the indexes of the descriptors, to size per-vertex arrays
+	 */
+	inline unsigned indexBound() const { return this->m_nbVertices; }
+
+	bool hasEdge(Vertex_Descriptor, Vertex_Descriptor) const;
+	unsigned inDegree(Vertex_Descriptor) const;
+	unsigned outDegree(Vertex_Descriptor) const;
+	adjacent_range neighbors(Vertex_Descriptor) const;
+
+	////////////////////////////////////////////////////////////////
+	// Setters (mutators): the graph is read-only, they all throw
+	////////////////////////////////////////////////////////////////
+	void addVertex(const T &);
+	void deleteVertex(const T &);
+	void addEdge(const T&, const T&);
+	void deleteEdge(const T&, const T&);
+
+	friend class Read_Only_Graph<T, Mapped_Graph>;
+
+private:
+	/**
+	 * \class AdjacentCursor
+	 * \brief Walks a slice of the neighbors
+	 */
+	class AdjacentCursor {
+	public:
+		typedef Vertex_Descriptor value_type;
+		typedef Vertex_Descriptor reference;
+
+		AdjacentCursor() : m_pos(NULL) {}
+		explicit AdjacentCursor(const unsigned *p_pos) : m_pos(p_pos) {}
+
+		reference get() const { return Vertex_Descriptor(*m_pos); }
+		void next() { m_pos++; }
+		bool operator==(const AdjacentCursor &p_rhs) const { return m_pos == p_rhs.m_pos; }
+
+	private:
+		const unsigned *m_pos;
+	};
+
+	File_Mapping m_mapping; /*!< the whole file: all the pointers below point into it */
+	const T *m_elems; /*!< the vertices, in index order */
+	const unsigned *m_offsets; /*!< nbVertices + 1 offsets in m_neighbors */
+	const unsigned *m_neighbors; /*!< all the adjacency lists one after the other */
+	const unsigned *m_inDegrees; /*!< in-degree of each vertex (loops not doubled) */
+	const uint64_t *m_bits; /*!< the bit matrix, if saved from an Adjacency_Matrix (NULL otherwise) */
+	unsigned m_rowWords; /*!< 64-bit words per row of m_bits */
+	unsigned m_nbEdges;
+	uint64_t m_fingerprint;
+	Vertex_Index<T> m_index; /*!< vertex data -> index */
+
+	void _swap(Mapped_Graph &);
+	template<typename U> static const U *_section(const File_Mapping &, Graph_File_Header::Section, uint64_t p_nb);
+	static const unsigned *_noOffsets() {
+		static const unsigned zero = 0;
+
+		return &zero;
+	}
+
+	using Read_Only_Graph<T, Mapped_Graph>::_index;
+
+	bool _isLoop(unsigned) const;
+};
+
+}
+
+#include "MappedGraph.hpp"
+
+#endif /* MAPPEDGRAPH_H_ */
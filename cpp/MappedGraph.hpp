@@ -0,0 +1,241 @@
+//! \file MappedGraph.hpp
+//! \brief Implementation of the read-only graph served from a memory-mapped graph file
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm> // std::binary_search
+
+using namespace std;
+
+namespace SGL {
+
+/**
+ * \brief Constructor of an empty graph, until mapFile is called
+ */
+template<typename T>
+Mapped_Graph<T>::Mapped_Graph() :
+		m_elems(NULL), m_offsets(_noOffsets()), m_neighbors(NULL), m_inDegrees(NULL), m_bits(NULL), m_rowWords(0),
+		m_nbEdges(0), m_fingerprint(Graph_Fingerprint<T>().value()) {
+	this->m_config = 0;
+	this->m_nbVertices = 0;
+}
+
+/**
+ * \brief Maps a graph file, see mapFile
+ */
+template<typename T>
+Mapped_Graph<T>::Mapped_Graph(const std::string &p_path) : Mapped_Graph() {
+	mapFile(p_path);
+}
+
+/**
+ * \brief Move constructor: takes the mapping of the source
+ * \post The source is an empty graph
+ */
+template<typename T>
+Mapped_Graph<T>::Mapped_Graph(Mapped_Graph<T> &&p_src) : Mapped_Graph() {
+	_swap(p_src);
+}
+
+/**
+ * \brief Move assignment: the previous mapping is released, the source is left empty
+ */
+template<typename T>
+Mapped_Graph<T> &Mapped_Graph<T>::operator=(Mapped_Graph<T> &&p_src) {
+	Mapped_Graph<T> moved(std::move(p_src));
+
+	_swap(moved);
+	return (*this);
+}
+
+template<typename T>
+void Mapped_Graph<T>::_swap(Mapped_Graph<T> &p_other) {
+	std::swap(this->m_config, p_other.m_config);
+	std::swap(this->m_nbVertices, p_other.m_nbVertices);
+	m_mapping.swap(p_other.m_mapping);
+	std::swap(m_elems, p_other.m_elems);
+	std::swap(m_offsets, p_other.m_offsets);
+	std::swap(m_neighbors, p_other.m_neighbors);
+	std::swap(m_inDegrees, p_other.m_inDegrees);
+	std::swap(m_bits, p_other.m_bits);
+	std::swap(m_rowWords, p_other.m_rowWords);
+	std::swap(m_nbEdges, p_other.m_nbEdges);
+	std::swap(m_fingerprint, p_other.m_fingerprint);
+	std::swap(m_index, p_other.m_index);
+}
+
+/**
+ * \brief Maps a file written by Adjacency_List::save or Adjacency_Matrix::save, in place of the current graph.
+ * Only the header is read: the queries read the sections straight from the mapping.
+ * \param[in] p_path the path of the file
+ * \exception runtime_error if the file can't be opened or mapped
+ * \exception logic_error if it isn't a graph file of this version and byte order, if it was saved with another vertex
+ * type (of another size), or if it is truncated
+ * \exception bad_alloc in case of insufficient memory (for the vertex index)
+ */
+template<typename T>
+void Mapped_Graph<T>::mapFile(const std::string &p_path) {
+	File_Mapping mapping(p_path); // throws runtime_error if the file can't be mapped
+	const Graph_File_Header *header = reinterpret_cast<const Graph_File_Header *>(mapping.data());
+	Mapped_Graph<T> graph;
+
+	if (mapping.size() < sizeof(Graph_File_Header) || std::memcmp(header->magic, "SGLG", sizeof(header->magic)) != 0
+			|| header->version != Graph_File_Header::VERSION || header->byteOrder != Graph_File_Header::ORDER_MARK
+			|| header->fileSize != mapping.size()) {
+		throw logic_error("mapFile: not a graph file of this version");
+	}
+	if (header->vertexSize != sizeof(T)) {
+		throw logic_error("mapFile: the file was saved with another vertex type");
+	}
+	graph.m_elems = _section<T>(mapping, Graph_File_Header::VERTICES, header->nbVertices);
+	graph.m_offsets = _section<unsigned>(mapping, Graph_File_Header::OFFSETS, header->nbVertices + 1ULL);
+	graph.m_neighbors = _section<unsigned>(mapping, Graph_File_Header::NEIGHBORS, header->nbArcs);
+	graph.m_inDegrees = _section<unsigned>(mapping, Graph_File_Header::IN_DEGREES, header->nbVertices);
+	if (graph.m_offsets[0] != 0 || graph.m_offsets[header->nbVertices] != header->nbArcs) {
+		throw logic_error("mapFile: corrupted graph file");
+	}
+	if (header->sections[Graph_File_Header::BITS] != 0) {
+		graph.m_rowWords = header->rowWords;
+		graph.m_bits = _section<uint64_t>(mapping, Graph_File_Header::BITS,
+				static_cast<uint64_t>(header->nbVertices) * header->rowWords);
+	}
+	graph.m_config = header->config;
+	graph.m_nbVertices = header->nbVertices;
+	graph.m_nbEdges = header->nbEdges;
+	graph.m_fingerprint = header->fingerprint;
+	graph.m_index.reserve(graph.m_nbVertices);
+	for (unsigned v = 0; v < graph.m_nbVertices; v++) {
+		graph.m_index.insert(graph.m_elems[v], v);
+	}
+	graph.m_mapping.swap(mapping); // the mapped addresses don't change
+	_swap(graph);
+}
+
+/**
+ * \brief Locates a section in the mapped file
+ * \exception logic_error if the section is missing, misaligned or goes past the end of the file
+ */
+template<typename T>
+template<typename U>
+const U *Mapped_Graph<T>::_section(const File_Mapping &p_mapping, Graph_File_Header::Section p_section, uint64_t p_nb) {
+	const Graph_File_Header *header = reinterpret_cast<const Graph_File_Header *>(p_mapping.data());
+	uint64_t offset = header->sections[p_section];
+
+	if (offset == 0 || offset % Graph_File_Header::SECTION_ALIGNMENT != 0 || offset > p_mapping.size()
+			|| (p_mapping.size() - offset) / sizeof(U) < p_nb) {
+		throw logic_error("mapFile: truncated graph file");
+	}
+	return reinterpret_cast<const U *>(p_mapping.data() + offset);
+}
+
+template<typename T>
+std::vector<T> Mapped_Graph<T>::vertexNeighborhood(const T &p_v, bool p_closed) const {
+	unsigned v_idx = _index(p_v); // throws logic error if the elem's not in the graph
+	vector<T> neighbors;
+
+	neighbors.reserve(m_offsets[v_idx + 1] - m_offsets[v_idx] + 1);
+	for (unsigned pos = m_offsets[v_idx]; pos < m_offsets[v_idx + 1]; pos++) {
+		neighbors.push_back(m_elems[m_neighbors[pos]]);
+	}
+	if (p_closed && !_isLoop(v_idx)) {
+		neighbors.push_back(m_elems[v_idx]);
+	}
+	return neighbors;
+}
+
+template<typename T>
+std::vector<T> Mapped_Graph<T>::vertices() const {
+	return vector<T>(m_elems, m_elems + this->m_nbVertices);
+}
+
+template<typename T>
+std::vector<std::pair<T, T> > Mapped_Graph<T>::edges() const {
+	vector<pair<T, T> > edges;
+
+	edges.reserve(m_nbEdges);
+	for (unsigned src = 0; src < this->m_nbVertices; src++) {
+		for (unsigned pos = m_offsets[src]; pos < m_offsets[src + 1]; pos++) {
+			// in an undirected graph, only list each edge once (from its greatest vertex index)
+			if (hasConfiguration(UNDIRECTED) && m_neighbors[pos] > src) {
+				break;
+			}
+			edges.push_back(make_pair(m_elems[src], m_elems[m_neighbors[pos]]));
+		}
+	}
+	return edges;
+}
+
+/**
+ * \brief O(1) with the bit matrix of a saved Adjacency_Matrix, binary search in the neighbors otherwise
+ * \pre the descriptors are valid descriptors of this graph (they aren't checked)
+ */
+template<typename T>
+bool Mapped_Graph<T>::hasEdge(Vertex_Descriptor p_src, Vertex_Descriptor p_dest) const {
+	unsigned src_idx = p_src.index();
+	unsigned dest_idx = p_dest.index();
+
+	if (m_bits != NULL) {
+		return (m_bits[static_cast<std::size_t>(src_idx) * m_rowWords + dest_idx / 64] >> (dest_idx % 64)) & 1;
+	}
+	return std::binary_search(m_neighbors + m_offsets[src_idx], m_neighbors + m_offsets[src_idx + 1], dest_idx);
+}
+
+template<typename T>
+unsigned Mapped_Graph<T>::inDegree(Vertex_Descriptor p_vd) const {
+	unsigned v_idx = p_vd.index();
+	unsigned inDeg = m_inDegrees[v_idx];
+
+	// if the graph is undirected: a loop counts twice
+	if (hasConfiguration(UNDIRECTED) && _isLoop(v_idx)) {
+		inDeg++;
+	}
+	return inDeg;
+}
+
+template<typename T>
+unsigned Mapped_Graph<T>::outDegree(Vertex_Descriptor p_vd) const {
+	unsigned v_idx = p_vd.index();
+	unsigned outDeg = m_offsets[v_idx + 1] - m_offsets[v_idx];
+
+	// if the graph is undirected: a loop counts twice
+	if (hasConfiguration(UNDIRECTED) && _isLoop(v_idx)) {
+		outDeg++;
+	}
+	return outDeg;
+}
+
+/**
+ * \brief Lazy range over the descriptors of the neighbors of a vertex, in index order
+ */
+template<typename T>
+typename Mapped_Graph<T>::adjacent_range Mapped_Graph<T>::neighbors(Vertex_Descriptor p_vd) const {
+	return adjacent_range(Range_Iterator<AdjacentCursor>(AdjacentCursor(m_neighbors + m_offsets[p_vd.index()])),
+			Range_Iterator<AdjacentCursor>(AdjacentCursor(m_neighbors + m_offsets[p_vd.index() + 1])));
+}
+
+template<typename T>
+void Mapped_Graph<T>::addVertex(const T &) {
+	throw logic_error("addVertex: the graph is read-only");
+}
+
+template<typename T>
+void Mapped_Graph<T>::deleteVertex(const T &) {
+	throw logic_error("deleteVertex: the graph is read-only");
+}
+
+template<typename T>
+void Mapped_Graph<T>::addEdge(const T &, const T &) {
+	throw logic_error("addEdge: the graph is read-only");
+}
+
+template<typename T>
+void Mapped_Graph<T>::deleteEdge(const T &, const T &) {
+	throw logic_error("deleteEdge: the graph is read-only");
+}
+
+template<typename T>
+bool Mapped_Graph<T>::_isLoop(unsigned p_idx) const {
+	return hasEdge(Vertex_Descriptor(p_idx), Vertex_Descriptor(p_idx));
+}
+
+} // namespace SGL
@@ -0,0 +1,70 @@
+//! \file Parallel.h
+//! \brief Minimal task runner shared by the parallel builders, loaders and writers
+//! \version 0.1
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace SGL {
+
+/**
+ * \brief Number of threads to use when 0 is asked: the number of cores (at least 1)
+ */
+inline unsigned defaultThreads(unsigned p_nbThreads) {
+	return (p_nbThreads != 0) ? p_nbThreads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * \brief Runs p_task(0) to p_task(p_nbTasks - 1) on up to p_nbThreads threads (the calling one included),
+ * each thread taking the next task as soon as it's done with one.
+ * The first exception thrown by a task stops the distribution and is rethrown once all the threads are joined.
+ */
+template<typename Task>
+void runInParallel(unsigned p_nbThreads, unsigned p_nbTasks, Task p_task) {
+	std::atomic<unsigned> next(0);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+	std::vector<std::thread> workers;
+	auto work = [&]() {
+		try {
+			for (unsigned task = next++; task < p_nbTasks; task = next++) {
+				p_task(task);
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+
+			if (!error) {
+				error = std::current_exception();
+			}
+			next = p_nbTasks;
+		}
+	};
+
+	workers.reserve(p_nbThreads);
+	for (unsigned i = 1; i < std::min(p_nbThreads, p_nbTasks); i++) {
+		try {
+			workers.push_back(std::thread(work));
+		} catch (const std::system_error &) {
+			break; // no more threads available: go on with the ones already running
+		}
+	}
+	work();
+	for (unsigned i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+} // namespace SGL
+
+#endif /* PARALLEL_H_ */
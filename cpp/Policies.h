@@ -0,0 +1,92 @@
+//! \file Policies.h
+//! \brief Compile-time configuration policies of the graph classes
+//! \version 0.1
+
+#ifndef POLICIES_H_
+#define POLICIES_H_
+
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \brief Direction policies: the second template parameter of Adjacency_List and Adjacency_Matrix.
+ * Directed and Undirected fix the direction of the graph at compile time: the UNDIRECTED flag given to the
+ * constructor is then overridden, the direction tests fold into constants and the matrix storage is chosen
+ * statically (no virtual calls).
+ * Runtime_Direction, the default, reads the UNDIRECTED flag of the configuration as before.
+ * A policy provides:
+ * - isFixed, true if the direction is known at compile time, and undirected, the direction when it's fixed,
+ * - isUndirected(configuration), the direction of a graph with the given configuration,
+ * - configure(configuration), the configuration actually stored by the graph.
+ */
+struct Directed {
+	static const bool isFixed = true;
+	static const bool undirected = false;
+
+	static inline bool isUndirected(configuration) { return false; }
+	static inline configuration configure(configuration p_f) { return p_f & ~UNDIRECTED; }
+};
+
+struct Undirected {
+	static const bool isFixed = true;
+	static const bool undirected = true;
+
+	static inline bool isUndirected(configuration) { return true; }
+	static inline configuration configure(configuration p_f) { return p_f | UNDIRECTED; }
+};
+
+struct Runtime_Direction {
+	static const bool isFixed = false;
+	static const bool undirected = false;
+
+	static inline bool isUndirected(configuration p_f) { return (p_f & UNDIRECTED) != 0; }
+	static inline configuration configure(configuration p_f) { return p_f; }
+};
+
+/**
+ * \brief Weighting policies: the third template parameter of Adjacency_List and Adjacency_Matrix.
+ * Unweighted, the default, stores nothing: every edge weighs 1 and the weighted mutators don't compile.
+ * Weighted<W> stores a W per edge (value-initialized when the edge is added without a weight), and sets the
+ * WEIGHTED configuration flag.
+ * A policy provides:
+ * - isWeighted and weight_type, the type of the weights,
+ * - configure(configuration), the configuration actually stored by the graph,
+ * - Slot, the base class of the edges of an Adjacency_List holding the weight (empty for Unweighted, so that the
+ * edges of an unweighted list are only their destination).
+ */
+struct Unweighted {
+	static const bool isWeighted = false;
+	typedef unsigned weight_type;
+
+	static inline configuration configure(configuration p_f) { return p_f; }
+
+	class Slot {
+	public:
+		Slot() {}
+		inline weight_type weight() const { return 1; }
+	};
+};
+
+template<typename W>
+struct Weighted {
+	static const bool isWeighted = true;
+	typedef W weight_type;
+
+	static inline configuration configure(configuration p_f) { return p_f | WEIGHTED; }
+
+	class Slot {
+	public:
+		Slot() : m_weight() {}
+		explicit Slot(const W &p_weight) : m_weight(p_weight) {}
+		inline const W &weight() const { return m_weight; }
+		inline void setWeight(const W &p_weight) { m_weight = p_weight; }
+
+	private:
+		W m_weight;
+	};
+};
+
+} // namespace SGL
+
+#endif /* POLICIES_H_ */
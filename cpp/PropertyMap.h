@@ -0,0 +1,213 @@
+//! \file PropertyMap.h
+//! \brief Per-vertex attributes stored as dense arrays aligned on the vertex indexes of a graph
+//! \version 0.1
+
+#ifndef PROPERTYMAP_H_
+#define PROPERTYMAP_H_
+
+#include <vector>
+#include <algorithm>
+
+#include "VertexIndex.h"
+
+namespace SGL {
+
+/**
+ * \class Vertex_Observer
+ * \brief Interface of the objects which follow the vertex indexes of a graph (see Vertex_Property).
+ * The graph calls the hooks right after each change of its numbering.
+ */
+class Vertex_Observer {
+public:
+	static const unsigned REMOVED = ~0u; /*!< new index of the removed vertices in verticesRenumbered */
+
+	virtual ~Vertex_Observer() {}
+
+	/**
+	 * \brief A vertex has been stored at p_idx: either appended (p_idx is the previous index bound) or in a reused slot
+	 */
+	virtual void vertexAdded(unsigned p_idx) = 0;
+
+	/**
+	 * \brief The vertex at p_idx has been removed, and the vertices above it shifted down by one
+	 */
+	virtual void vertexErased(unsigned p_idx) = 0;
+
+	/**
+	 * \brief The vertices have been renumbered in order (e.g. by compact())
+	 * \param[in] p_newIndexes the new index of each old index, or REMOVED
+	 * \param[in] p_bound the new index bound
+	 */
+	virtual void verticesRenumbered(const std::vector<unsigned> &p_newIndexes, unsigned p_bound) = 0;
+
+	/**
+	 * \brief All the vertices have been replaced (e.g. by an assignment): p_bound is the new index bound
+	 */
+	virtual void verticesReset(unsigned p_bound) = 0;
+
+	/**
+	 * \brief The graph is being destroyed: no more hooks will be called
+	 */
+	virtual void graphDestroyed() = 0;
+};
+
+/**
+ * \class Observer_List
+ * \brief The observers attached to a graph.
+ * It isn't copied with its graph: a copy starts with no observer, and an assigned graph keeps its own.
+ */
+class Observer_List {
+public:
+	Observer_List() {}
+	Observer_List(const Observer_List &) {}
+	~Observer_List() {
+		for (unsigned i = 0; i < m_observers.size(); i++) {
+			m_observers[i]->graphDestroyed();
+		}
+	}
+	Observer_List &operator=(const Observer_List &) { return *this; }
+
+	void attach(Vertex_Observer *p_observer) { m_observers.push_back(p_observer); }
+	void detach(Vertex_Observer *p_observer) {
+		m_observers.erase(std::find(m_observers.begin(), m_observers.end(), p_observer));
+	}
+
+	void vertexAdded(unsigned p_idx) const {
+		for (unsigned i = 0; i < m_observers.size(); i++) {
+			m_observers[i]->vertexAdded(p_idx);
+		}
+	}
+	void vertexErased(unsigned p_idx) const {
+		for (unsigned i = 0; i < m_observers.size(); i++) {
+			m_observers[i]->vertexErased(p_idx);
+		}
+	}
+	void verticesRenumbered(const std::vector<unsigned> &p_newIndexes, unsigned p_bound) const {
+		for (unsigned i = 0; i < m_observers.size(); i++) {
+			m_observers[i]->verticesRenumbered(p_newIndexes, p_bound);
+		}
+	}
+	void verticesReset(unsigned p_bound) const {
+		for (unsigned i = 0; i < m_observers.size(); i++) {
+			m_observers[i]->verticesReset(p_bound);
+		}
+	}
+
+private:
+	std::vector<Vertex_Observer *> m_observers;
+};
+
+/**
+ * \class Vertex_Property
+ * \brief One value of type V per vertex of a graph, in a plain vector indexed by Vertex_Descriptor::index():
+ * an access is an array access, and the values of all the vertices are contiguous.
+ * Several properties make a structure of arrays, one array per attribute.
+ * The property stays aligned on the graph through the Vertex_Observer hooks: a new vertex gets the default value,
+ * the value of a deleted vertex goes away with it. The graph must provide indexBound() and observers()
+ * (Adjacency_List and Adjacency_Matrix do).
+ * The slots of the tombstones of an Adjacency_List with DEFERRED_DELETION keep their value until they are reused.
+ * The property detaches itself when it's destroyed; if the graph is destroyed first, the property keeps its values
+ * but doesn't follow anything anymore.
+ */
+template<typename V>
+class Vertex_Property : public Vertex_Observer {
+public:
+	typedef typename std::vector<V>::reference reference;
+	typedef typename std::vector<V>::const_reference const_reference;
+	typedef typename std::vector<V>::iterator iterator;
+	typedef typename std::vector<V>::const_iterator const_iterator;
+
+	/**
+	 * \brief Attaches a new property to a graph, with the default value for all its vertices
+	 * \param[in] p_graph the graph
+	 * \param[in] p_default the value of the vertices that haven't been given one
+	 * \exception bad_alloc in case of insufficient memory
+	 */
+	template<typename Graph>
+	explicit Vertex_Property(const Graph &p_graph, const V &p_default = V()) :
+			m_values(p_graph.indexBound(), p_default), m_default(p_default), m_observers(&p_graph.observers()) {
+		m_observers->attach(this);
+	}
+
+	Vertex_Property(const Vertex_Property &p_src) :
+			Vertex_Observer(), m_values(p_src.m_values), m_default(p_src.m_default), m_observers(p_src.m_observers) {
+		if (m_observers != NULL) {
+			m_observers->attach(this);
+		}
+	}
+
+	~Vertex_Property() {
+		if (m_observers != NULL) {
+			m_observers->detach(this);
+		}
+	}
+
+	/**
+	 * \brief Copies the values only: each property stays attached to its own graph
+	 * \pre both properties follow the same graph, or graphs with the same numbering
+	 */
+	Vertex_Property &operator=(const Vertex_Property &p_src) {
+		m_values = p_src.m_values;
+		m_default = p_src.m_default;
+		return *this;
+	}
+
+	inline reference operator[](Vertex_Descriptor p_vd) { return m_values[p_vd.index()]; }
+	inline const_reference operator[](Vertex_Descriptor p_vd) const { return m_values[p_vd.index()]; }
+
+	/**
+	 * \brief Number of values: the indexBound() of the graph
+	 */
+	inline unsigned size() const { return m_values.size(); }
+	inline iterator begin() { return m_values.begin(); }
+	inline iterator end() { return m_values.end(); }
+	inline const_iterator begin() const { return m_values.begin(); }
+	inline const_iterator end() const { return m_values.end(); }
+
+	/**
+	 * \brief Sets all the values back to the default one
+	 */
+	void reset() { m_values.assign(m_values.size(), m_default); }
+
+	////////////////////////////////////////////////////////////////
+	// Vertex_Observer hooks
+	////////////////////////////////////////////////////////////////
+	void vertexAdded(unsigned p_idx) {
+		if (p_idx < m_values.size()) {
+			m_values[p_idx] = m_default;
+		} else {
+			m_values.resize(p_idx + 1, m_default);
+		}
+	}
+
+	void vertexErased(unsigned p_idx) {
+		m_values.erase(m_values.begin() + p_idx);
+	}
+
+	void verticesRenumbered(const std::vector<unsigned> &p_newIndexes, unsigned p_bound) {
+		// the numbering keeps the order, so the values only move down
+		for (unsigned i = 0; i < p_newIndexes.size(); i++) {
+			if (p_newIndexes[i] != REMOVED && p_newIndexes[i] != i) {
+				m_values[p_newIndexes[i]] = m_values[i];
+			}
+		}
+		m_values.resize(p_bound, m_default);
+	}
+
+	void verticesReset(unsigned p_bound) {
+		m_values.assign(p_bound, m_default);
+	}
+
+	void graphDestroyed() {
+		m_observers = NULL;
+	}
+
+private:
+	std::vector<V> m_values; /*!< the value of each vertex index */
+	V m_default; /*!< the value of the new vertices */
+	Observer_List *m_observers; /*!< the observers of the graph, NULL once it's destroyed */
+};
+
+} // namespace SGL
+
+#endif /* PROPERTYMAP_H_ */
@@ -0,0 +1,126 @@
+//! \file Range.h
+//! \brief Lazy forward ranges over the internal storage of the graphs
+//! \version 0.1
+
+#ifndef RANGE_H_
+#define RANGE_H_
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+
+namespace SGL {
+
+/**
+ * \class Range_Iterator
+ * \brief Forward iterator built on a cursor over the storage of a graph.
+ * A cursor is a small copyable class providing:
+ * - the value_type and reference typedefs (reference may be a proxy, e.g. a pair of references),
+ * - reference get() const, the current element,
+ * - void next(), which moves to the next element,
+ * - operator==, true when both cursors are on the same element.
+ * The iterators are invalidated by any modification of the graph.
+ */
+template<typename Cursor>
+class Range_Iterator {
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef typename Cursor::value_type value_type;
+	typedef typename Cursor::reference reference;
+	typedef const typename std::remove_reference<reference>::type *pointer;
+	typedef std::ptrdiff_t difference_type;
+
+	Range_Iterator() {}
+	explicit Range_Iterator(const Cursor &p_cursor) : m_cursor(p_cursor) {}
+
+	inline reference operator*() const { return m_cursor.get(); }
+	inline Range_Iterator &operator++() { m_cursor.next(); return *this; }
+	inline Range_Iterator operator++(int) { Range_Iterator it(*this); m_cursor.next(); return it; }
+	inline bool operator==(const Range_Iterator &p_rhs) const { return m_cursor == p_rhs.m_cursor; }
+	inline bool operator!=(const Range_Iterator &p_rhs) const { return !(m_cursor == p_rhs.m_cursor); }
+
+	/**
+	 * \brief Member access, which also works when the reference is a proxy returned by value
+	 */
+	class Arrow {
+	public:
+		explicit Arrow(reference p_ref) : m_ref(p_ref) {}
+		pointer operator->() const { return &m_ref; }
+	private:
+		reference m_ref;
+	};
+	inline Arrow operator->() const { return Arrow(m_cursor.get()); }
+
+private:
+	Cursor m_cursor;
+};
+
+/**
+ * \class Value_Cursor
+ * \brief Turns a cursor over vertex descriptors into a cursor over the data of the vertices, with Graph::value
+ */
+template<typename T, typename Graph, typename Cursor>
+class Value_Cursor {
+public:
+	typedef T value_type;
+	typedef const T &reference;
+
+	Value_Cursor() : m_graph(NULL) {}
+	Value_Cursor(const Graph *p_graph, const Cursor &p_cursor) : m_graph(p_graph), m_cursor(p_cursor) {}
+
+	inline reference get() const { return m_graph->value(m_cursor.get()); }
+	inline void next() { m_cursor.next(); }
+	inline bool operator==(const Value_Cursor &p_rhs) const { return m_cursor == p_rhs.m_cursor; }
+
+private:
+	const Graph *m_graph;
+	Cursor m_cursor;
+};
+
+/**
+ * \class Weighted_Cursor
+ * \brief Pairs each element of a cursor with the weight of the current edge, read with Cursor::weight()
+ */
+template<typename Cursor, typename W>
+class Weighted_Cursor {
+public:
+	typedef std::pair<typename Cursor::value_type, W> value_type;
+	typedef value_type reference;
+
+	Weighted_Cursor() {}
+	explicit Weighted_Cursor(const Cursor &p_cursor) : m_cursor(p_cursor) {}
+
+	inline reference get() const { return reference(m_cursor.get(), m_cursor.weight()); }
+	inline void next() { m_cursor.next(); }
+	inline bool operator==(const Weighted_Cursor &p_rhs) const { return m_cursor == p_rhs.m_cursor; }
+
+private:
+	Cursor m_cursor;
+};
+
+/**
+ * \class Range
+ * \brief A pair of iterators usable in a range-based for loop. Nothing is copied or allocated:
+ * the elements are read from the graph as the range is walked.
+ */
+template<typename Iterator>
+class Range {
+public:
+	typedef Iterator iterator;
+	typedef Iterator const_iterator;
+
+	Range(const Iterator &p_begin, const Iterator &p_end) : m_begin(p_begin), m_end(p_end) {}
+
+	inline Iterator begin() const { return m_begin; }
+	inline Iterator end() const { return m_end; }
+	inline bool empty() const { return m_begin == m_end; }
+
+private:
+	Iterator m_begin;
+	Iterator m_end;
+};
+
+} // namespace SGL
+
+#endif /* RANGE_H_ */
@@ -0,0 +1,94 @@
+//! \file ReadOnlyGraph.h
+//! \brief Declaration of the base of the read-only graphs, with what they share above their storage
+//! \version 0.1
+
+#ifndef READONLYGRAPH_H_
+#define READONLYGRAPH_H_
+
+#include "AbstractGraph.h"
+#include "VertexIndex.h"
+#include "components.h"
+
+namespace SGL {
+
+/**
+ * \class Read_Only_Graph
+ *
+ * \brief Base of the graphs which can't be modified (Compressed_Sparse_Row, Compressed_Graph, Mapped_Graph).
+ * It holds what they do the same way above their storage: the counts, the configuration, the vertex lookup and the
+ * vertex-based queries, each answered through the descriptor-based method of the graph.
+ * Graph is the derived class. It must have, reachable from here (it declares this class a friend):
+ * - m_index (a Vertex_Index<T>) and m_nbEdges,
+ * - value(Vertex_Descriptor), inDegree(Vertex_Descriptor), outDegree(Vertex_Descriptor)
+ *   and hasEdge(Vertex_Descriptor, Vertex_Descriptor).
+ */
+template<typename T, typename Graph>
+class Read_Only_Graph : public AbstractGraph<T> {
+public:
+	////////////////////////////////////////////////////////////////
+	// Getters (const)
+	////////////////////////////////////////////////////////////////
+	/**
+	 * \brief Returns the number of vertices in the graph
+	 * \return the number of vertices in the graph
+	 */
+	inline unsigned nbVertices() const { return this->m_nbVertices; }
+
+	/**
+	 * \brief Returns the number of edges in the graph (each undirected edge counted once)
+	 * \return the number of edges in the graph
+	 */
+	inline unsigned nbEdges() const { return _graph().m_nbEdges; }
+
+	/**
+	 * \brief Alias of the nbVertices method
+	 * "order" is the mathematical term for "number of vertices"
+	 * \return the number of vertices in the graph
+	 */
+	inline unsigned int order() const { return nbVertices(); }
+
+	/**
+	 * \brief Alias of the nbEdges method
+	 * "size" is the mathematical term for "number of edges" (not to be mistaken with order, the number of vertices)
+	 * \return the number of edges in the graph
+	 */
+	inline unsigned int size() const { return nbEdges(); }
+
+	/**
+	 * \brief Retrieve the configuration of the graph
+	 * \return the configuration of the graph
+	 */
+	inline configuration getConfiguration() const { return this->m_config; }
+
+	/**
+	 * \brief Lets the user know whether a graph has a given configuration (e.g. if it's directed, weighted...)
+	 * \param[in] p_config the configuration we want to know the graph has or not
+	 * \return true if the graph holds this configuration
+	 */
+	inline bool hasConfiguration(configuration p_config) const { return (this->m_config & p_config); }
+
+	bool hasVertex(const T &) const;
+	bool vertexIsSource(const T &) const;
+	bool vertexIsSink(const T &) const;
+	unsigned vertexInDegree(const T &) const;
+	unsigned vertexOutDegree(const T &) const;
+	bool hasEdge(const T &, const T &) const;
+
+	////////////////////////////////////////////////////////////////
+	// Vertex descriptors: no vertex lookup
+	////////////////////////////////////////////////////////////////
+	Vertex_Descriptor descriptor(const T &) const;
+
+protected:
+	bool _find(const T &, unsigned &) const;
+	unsigned _index(const T &p_v) const;
+
+private:
+	inline const Graph &_graph() const { return static_cast<const Graph &>(*this); }
+};
+
+}
+
+#include "ReadOnlyGraph.hpp"
+
+#endif /* READONLYGRAPH_H_ */
@@ -0,0 +1,97 @@
+//! \file ReadOnlyGraph.hpp
+//! \brief Definition of the methods shared by the read-only graphs
+//! \version 0.1
+
+#include <stdexcept>
+
+#include "ReadOnlyGraph.h"
+
+using namespace std;
+
+namespace SGL {
+
+template<typename T, typename Graph>
+bool Read_Only_Graph<T, Graph>::hasVertex(const T &p_v) const {
+	unsigned idx;
+
+	return _find(p_v, idx);
+}
+
+template<typename T, typename Graph>
+bool Read_Only_Graph<T, Graph>::vertexIsSource(const T &p_v) const {
+	if (hasConfiguration(UNDIRECTED)) {
+		throw logic_error("vertexIsSource: the graph is undirected");
+	}
+	return (vertexInDegree(p_v) == 0);
+}
+
+template<typename T, typename Graph>
+bool Read_Only_Graph<T, Graph>::vertexIsSink(const T &p_v) const {
+	if (hasConfiguration(UNDIRECTED)) {
+		throw logic_error("vertexIsSink: the graph is undirected");
+	}
+	return (vertexOutDegree(p_v) == 0);
+}
+
+template<typename T, typename Graph>
+unsigned Read_Only_Graph<T, Graph>::vertexInDegree(const T &p_v) const {
+	return _graph().inDegree(descriptor(p_v)); // throws logic error if the elem's not in the graph
+}
+
+template<typename T, typename Graph>
+unsigned Read_Only_Graph<T, Graph>::vertexOutDegree(const T &p_v) const {
+	return _graph().outDegree(descriptor(p_v)); // throws logic error if the elem's not in the graph
+}
+
+template<typename T, typename Graph>
+bool Read_Only_Graph<T, Graph>::hasEdge(const T &p_src, const T &p_dest) const {
+	unsigned src_idx, dest_idx;
+
+	if (!_find(p_src, src_idx) || !_find(p_dest, dest_idx)) {
+		throw logic_error("hasEdge: one of the vertices isn't in the graph");
+	}
+	return _graph().hasEdge(Vertex_Descriptor(src_idx), Vertex_Descriptor(dest_idx));
+}
+
+/**
+ * \brief Returns the descriptor of a vertex, to use the methods which don't look the vertex up
+ * \param[in] p_v the vertex
+ * \exception logic_error if the vertex isn't in the graph
+ * \return the descriptor of the vertex
+ */
+template<typename T, typename Graph>
+Vertex_Descriptor Read_Only_Graph<T, Graph>::descriptor(const T &p_v) const {
+	return Vertex_Descriptor(_index(p_v)); // throws logic error if the elem's not in the graph
+}
+
+template<typename T, typename Graph>
+unsigned Read_Only_Graph<T, Graph>::_index(const T &p_v) const {
+	unsigned idx;
+
+	if (!_find(p_v, idx)) {
+		throw logic_error("Vertex not in the graph");
+	}
+	return idx;
+}
+
+/**
+ * \brief Looks up the index of a vertex, without throwing
+ * \param[out] p_idx the index of the vertex, if found
+ * \return true if the vertex is in the graph
+ */
+template<typename T, typename Graph>
+bool Read_Only_Graph<T, Graph>::_find(const T &p_v, unsigned &p_idx) const {
+	if (_graph().m_index.isEnabled()) {
+		return _graph().m_index.find(p_v, p_idx);
+	}
+	// no hasher for this vertex type: linear search
+	for (unsigned pos = 0; pos < this->m_nbVertices; pos++) {
+		if (_graph().value(Vertex_Descriptor(pos)) == p_v) {
+			p_idx = pos;
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace SGL
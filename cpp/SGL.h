@@ -14,5 +14,16 @@
 #include "components.h"
 #include "AdjacencyMatrix.h"
 #include "AdjacencyList.h"
+#include "CompressedSparseRow.h"
+#if defined(__unix__) || defined(__APPLE__)
+# include "MappedGraph.h" // POSIX mmap
+#endif
+#include "CompressedGraph.h"
+#include "GraphBuilder.h"
+#include "GraphLoader.h"
+#include "GraphWriter.h"
+
+#include "Algorithms.h"
+#include "PropertyMap.h"
 
 #endif
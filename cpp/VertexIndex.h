@@ -0,0 +1,135 @@
+//! \file VertexIndex.h
+//! \brief Hash index from vertex data to internal vertex indexes, shared by the graph classes
+//! \version 0.1
+
+#ifndef VERTEXINDEX_H_
+#define VERTEXINDEX_H_
+
+#include <string>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+
+namespace SGL {
+
+/**
+ * \class Vertex_Hash
+ * \brief Hasher used by the graphs to index their vertices.
+ * Arithmetic types, pointers and std::string are hashed out of the box.
+ * To get constant-time vertex lookups with your own vertex type, specialize this class for it,
+ * with a static "enabled" member set to true and a const operator() returning a std::size_t.
+ * Vertex types without a hasher fall back to a linear search with operator==.
+ */
+template<typename T, typename Enable = void>
+struct Vertex_Hash {
+	static const bool enabled = false;
+};
+
+template<typename T>
+struct Vertex_Hash<T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_pointer<T>::value>::type> : public std::hash<T> {
+	static const bool enabled = true;
+};
+
+template<>
+struct Vertex_Hash<std::string> : public std::hash<std::string> {
+	static const bool enabled = true;
+};
+
+/**
+ * \class Vertex_Descriptor
+ * \brief Handle on a vertex of a graph: its internal index, wrapped so that it can't be mistaken for vertex data.
+ * It is obtained with descriptor() and turned back into the vertex data with value(), and lets the
+ * descriptor-based methods of the graphs skip the vertex lookup.
+ * A descriptor stays valid until a vertex is deleted from its graph
+ * (until compact() for an Adjacency_List with DEFERRED_DELETION, whose deletions don't renumber the vertices).
+ */
+class Vertex_Descriptor {
+public:
+	Vertex_Descriptor() : m_idx(~0u) {}
+	explicit Vertex_Descriptor(unsigned p_idx) : m_idx(p_idx) {}
+
+	/**
+	 * \brief The internal index of the vertex, lower than the indexBound() of its graph.
+	 * Handy to store per-vertex data in a plain vector.
+	 */
+	inline unsigned index() const { return m_idx; }
+
+	inline bool operator==(const Vertex_Descriptor &p_rhs) const { return m_idx == p_rhs.m_idx; }
+	inline bool operator!=(const Vertex_Descriptor &p_rhs) const { return m_idx != p_rhs.m_idx; }
+	inline bool operator<(const Vertex_Descriptor &p_rhs) const { return m_idx < p_rhs.m_idx; }
+
+private:
+	unsigned m_idx;
+};
+
+/**
+ * \class Vertex_Index
+ * \brief Maps the data of each vertex to its index in the internal containers of a graph.
+ * The graph is responsible for keeping it in sync when vertices are added, removed or renumbered.
+ */
+template<typename T, bool Hashed = Vertex_Hash<T>::enabled>
+class Vertex_Index {
+public:
+	/**
+	 * \brief Tells whether the index is actually used (i.e. T has a hasher)
+	 */
+	static bool isEnabled() { return true; }
+
+	/**
+	 * \brief Looks up the index of a vertex
+	 * \param[in] p_v the vertex data to search
+	 * \param[out] p_idx the index of the vertex, if found
+	 * \return true if the vertex is in the index
+	 */
+	bool find(const T &p_v, unsigned &p_idx) const {
+		typename Map::const_iterator it = m_map.find(p_v);
+
+		if (it == m_map.end()) {
+			return false;
+		}
+		p_idx = it->second;
+		return true;
+	}
+
+	void insert(const T &p_v, unsigned p_idx) { m_map[p_v] = p_idx; }
+	void erase(const T &p_v) { m_map.erase(p_v); }
+	void clear() { m_map.clear(); }
+	void reserve(unsigned p_nb) { m_map.reserve(p_nb); }
+
+	/**
+	 * \brief Renumbering after the deletion of a vertex: every index above the given one is shifted by one
+	 * \param[in] p_idx the index of the deleted vertex
+	 */
+	void shiftAbove(unsigned p_idx) {
+		for (typename Map::iterator it = m_map.begin(); it != m_map.end(); ++it) {
+			if (it->second > p_idx) {
+				it->second--;
+			}
+		}
+	}
+
+private:
+	typedef std::unordered_map<T, unsigned, Vertex_Hash<T> > Map;
+
+	Map m_map; /*!< vertex data -> internal index */
+};
+
+/**
+ * \brief Index of the vertex types with no hasher: it stores nothing, and the graphs do a linear search instead.
+ */
+template<typename T>
+class Vertex_Index<T, false> {
+public:
+	static bool isEnabled() { return false; }
+
+	bool find(const T &, unsigned &) const { return false; }
+	void insert(const T &, unsigned) {}
+	void erase(const T &) {}
+	void clear() {}
+	void reserve(unsigned) {}
+	void shiftAbove(unsigned) {}
+};
+
+} // namespace SGL
+
+#endif /* VERTEXINDEX_H_ */
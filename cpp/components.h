@@ -29,7 +29,9 @@ typedef enum Configuration {
 	WEIGHTED = 8,
 	NOT_WEIGHTED = 16,
 	ADJACENCY_MATRIX = 32,
-	ADJACENCY_LIST = 64
+	ADJACENCY_LIST = 64,
+	REVERSE_ADJACENCY = 128, /*!< Adjacency_List only: also index the edges coming to each vertex (predecessors in O(in-degree)) */
+	DEFERRED_DELETION = 256 /*!< Adjacency_List only: deleteVertex leaves a tombstone, renumbering is deferred to compact() */
 } Configuration;
 
 /** \typedef typedef int configuration
@@ -6,6 +6,8 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <string>
+#include <type_traits>
 #include "gtest/gtest.h"
 #include "AdjacencyList.h"
 
@@ -31,6 +33,13 @@ void AdjacencyListTest::addVertices(int p_nbr, int p_from) {
 	}
 }
 
+// a vertex type with no Vertex_Hash specialization
+struct Unhashed {
+	Unhashed(int p_v) : m_v(p_v) {}
+	bool operator==(const Unhashed &p_rhs) const { return m_v == p_rhs.m_v; }
+	int m_v;
+};
+
 TEST_F(AdjacencyListTest, constructor) {
 	EXPECT_TRUE(list.nbVertices() == 0);
 	EXPECT_TRUE(list.nbEdges() == 0);
@@ -58,6 +67,20 @@ TEST_F(AdjacencyListTest, deleteVertex) {
 	EXPECT_THROW(list.deleteVertex(42), logic_error);
 }
 
+TEST_F(AdjacencyListTest, deleteVertexEdges) {
+	addVertices(5, 42);
+	list.addEdge(42, 43);
+	list.addEdge(42, 44);
+	list.addEdge(42, 45);
+	list.addEdge(42, 46);
+	list.deleteVertex(44);
+	// only the edge to the deleted vertex is removed
+	EXPECT_EQ(3u, list.vertexOutDegree(42));
+	EXPECT_TRUE(list.hasEdge(42, 43));
+	EXPECT_TRUE(list.hasEdge(42, 45));
+	EXPECT_TRUE(list.hasEdge(42, 46));
+}
+
 TEST_F(AdjacencyListTest, hasVertex) {
 	EXPECT_FALSE(list.hasVertex(42));
 	list.addVertex(42);
@@ -69,6 +92,31 @@ TEST_F(AdjacencyListTest, hasVertex) {
 	EXPECT_TRUE(list.hasVertex(43));
 }
 
+TEST_F(AdjacencyListTest, vertexIndex) {
+	addVertices(5, 42);
+	list.addEdge(45, 46);
+	list.deleteVertex(43);
+	// the vertices after the deleted one have been renumbered
+	EXPECT_FALSE(list.hasVertex(43));
+	EXPECT_TRUE(list.hasVertex(42));
+	EXPECT_TRUE(list.hasVertex(44));
+	EXPECT_TRUE(list.hasEdge(45, 46));
+	list.addVertex(43);
+	list.addEdge(43, 46);
+	EXPECT_TRUE(list.hasEdge(43, 46));
+	EXPECT_FALSE(list.hasEdge(45, 43));
+
+	Adjacency_List<Unhashed> unhashed;
+
+	unhashed.addVertex(Unhashed(1));
+	unhashed.addVertex(Unhashed(2));
+	EXPECT_THROW(unhashed.addVertex(Unhashed(1)), logic_error);
+	unhashed.addEdge(Unhashed(1), Unhashed(2));
+	unhashed.deleteVertex(Unhashed(1));
+	EXPECT_FALSE(unhashed.hasVertex(Unhashed(1)));
+	EXPECT_TRUE(unhashed.hasVertex(Unhashed(2)));
+}
+
 TEST_F(AdjacencyListTest, vertexInDegree) {
 	list.addVertex(42);
 	EXPECT_TRUE(list.vertexInDegree(42) == 0);
@@ -86,6 +134,169 @@ TEST_F(AdjacencyListTest, vertexInDegree) {
 	EXPECT_THROW(list.vertexInDegree(42), logic_error);
 }
 
+TEST_F(AdjacencyListTest, reverseAdjacency) {
+	Adjacency_List<int> reverse(REVERSE_ADJACENCY);
+
+	for (int i = 42; i < 46; i++) {
+		reverse.addVertex(i);
+	}
+	reverse.addEdge(43, 42);
+	reverse.addEdge(44, 42);
+	reverse.addEdge(42, 42);
+	reverse.addEdge(42, 45);
+	EXPECT_EQ(3u, reverse.vertexInDegree(42));
+	EXPECT_EQ(1u, reverse.vertexInDegree(45));
+	EXPECT_TRUE(reverse.vertexIsSource(43));
+	EXPECT_FALSE(reverse.vertexIsSource(45));
+
+	vector<int> predecessors = reverse.vertexPredecessors(42);
+
+	EXPECT_EQ(3u, predecessors.size());
+	EXPECT_NE(std::find(predecessors.begin(), predecessors.end(), 44), predecessors.end());
+	reverse.deleteEdge(44, 42);
+	EXPECT_EQ(2u, reverse.vertexInDegree(42));
+	reverse.deleteVertex(43);
+	EXPECT_EQ(1u, reverse.vertexInDegree(42));
+	EXPECT_EQ(1u, reverse.vertexInDegree(45));
+	predecessors = reverse.vertexPredecessors(45);
+	ASSERT_EQ(1u, predecessors.size());
+	EXPECT_EQ(42, predecessors[0]);
+
+	// same answers without the index
+	addVertices(3, 42);
+	list.addEdge(43, 42);
+	list.addEdge(44, 42);
+	EXPECT_EQ(2u, list.vertexInDegree(42));
+	EXPECT_EQ(2u, list.vertexPredecessors(42).size());
+}
+
+TEST_F(AdjacencyListTest, edgeCounters) {
+	Adjacency_List<int> undirected(UNDIRECTED);
+
+	for (int i = 42; i < 46; i++) {
+		undirected.addVertex(i);
+	}
+	undirected.addEdge(42, 43);
+	undirected.addEdge(42, 42);
+	undirected.addEdge(44, 42);
+	// both directions of an undirected edge are listed, a loop once
+	EXPECT_EQ(5u, undirected.nbEdges());
+	EXPECT_EQ(undirected.edges().size(), undirected.size());
+	EXPECT_EQ(4u, undirected.vertexOutDegree(42));
+	EXPECT_EQ(4u, undirected.vertexInDegree(42));
+	EXPECT_EQ(1u, undirected.vertexInDegree(43));
+	undirected.deleteEdge(42, 42);
+	EXPECT_EQ(4u, undirected.nbEdges());
+	EXPECT_EQ(2u, undirected.vertexOutDegree(42));
+	undirected.addEdge(42, 42);
+	undirected.deleteVertex(43);
+	EXPECT_EQ(3u, undirected.nbEdges());
+	EXPECT_EQ(3u, undirected.vertexOutDegree(42));
+	undirected.deleteVertex(42);
+	EXPECT_EQ(0u, undirected.nbEdges());
+	EXPECT_EQ(0u, undirected.vertexOutDegree(44));
+
+	addVertices(3, 42);
+	list.addEdge(42, 43);
+	list.addEdge(43, 43);
+	list.addEdge(44, 43);
+	EXPECT_EQ(3u, list.nbEdges());
+	EXPECT_EQ(3u, list.vertexInDegree(43));
+	list.deleteVertex(42);
+	EXPECT_EQ(2u, list.size());
+	EXPECT_EQ(2u, list.vertexInDegree(43));
+	EXPECT_EQ(1u, list.vertexOutDegree(43));
+	list.deleteVertex(43);
+	EXPECT_EQ(0u, list.size());
+	EXPECT_EQ(0u, list.vertexOutDegree(44));
+}
+
+TEST_F(AdjacencyListTest, deferredDeletion) {
+	Adjacency_List<int> deferred(DEFERRED_DELETION);
+
+	for (int i = 42; i < 47; i++) {
+		deferred.addVertex(i);
+	}
+	deferred.addEdge(42, 43);
+	deferred.addEdge(42, 44);
+	deferred.addEdge(44, 44);
+	deferred.addEdge(45, 44);
+	deferred.addEdge(44, 46);
+	deferred.deleteVertex(44);
+	EXPECT_EQ(4u, deferred.nbVertices());
+	EXPECT_FALSE(deferred.hasVertex(44));
+	EXPECT_THROW(deferred.deleteVertex(44), logic_error);
+	// the edges going to the deleted vertex are ignored until they are actually removed
+	EXPECT_EQ(1u, deferred.nbEdges());
+	EXPECT_EQ(1u, deferred.edges().size());
+	EXPECT_EQ(1u, deferred.vertexOutDegree(42));
+	EXPECT_EQ(1u, deferred.vertexNeighborhood(42).size());
+	EXPECT_TRUE(deferred.vertexIsSink(45));
+	EXPECT_EQ(0u, deferred.vertexInDegree(46));
+	EXPECT_EQ(4u, deferred.vertices().size());
+
+	// the slot is reused by the next vertex, which doesn't inherit the old edges
+	deferred.addVertex(47);
+	EXPECT_EQ(5u, deferred.nbVertices());
+	EXPECT_FALSE(deferred.hasEdge(42, 47));
+	EXPECT_FALSE(deferred.hasEdge(45, 47));
+	EXPECT_EQ(0u, deferred.vertexInDegree(47));
+	deferred.addEdge(45, 47);
+	EXPECT_EQ(2u, deferred.nbEdges());
+
+	deferred.deleteVertex(43);
+	deferred.compact();
+	EXPECT_EQ(4u, deferred.nbVertices());
+	EXPECT_EQ(1u, deferred.nbEdges());
+	EXPECT_TRUE(deferred.hasEdge(45, 47));
+	EXPECT_FALSE(deferred.hasVertex(43));
+	EXPECT_EQ(0u, deferred.vertexOutDegree(42));
+	deferred.addVertex(43);
+	deferred.addEdge(43, 42);
+	EXPECT_EQ(5u, deferred.vertices().size());
+	EXPECT_TRUE(deferred.hasEdge(43, 42));
+
+	// the source of a stale edge deleted in turn: the edge is only taken off the counters once
+	Adjacency_List<int> chain(DEFERRED_DELETION);
+
+	for (int i = 1; i < 4; i++) {
+		chain.addVertex(i);
+	}
+	chain.addEdge(1, 2);
+	chain.addEdge(3, 2);
+	chain.deleteVertex(2);
+	chain.deleteVertex(1);
+	EXPECT_EQ(0u, chain.nbEdges());
+	EXPECT_TRUE(chain.edges().empty());
+	EXPECT_EQ(0u, chain.vertexOutDegree(3));
+	chain.addVertex(4);
+	chain.addEdge(3, 4);
+	chain.addVertex(5);
+	chain.compact();
+	EXPECT_EQ(3u, chain.nbVertices());
+	EXPECT_EQ(1u, chain.nbEdges());
+	EXPECT_EQ(1u, chain.vertexInDegree(4));
+	EXPECT_EQ(1u, chain.edges().size());
+
+	// undirected: the other direction of the edges is removed right away
+	Adjacency_List<int> undirected(UNDIRECTED | DEFERRED_DELETION);
+
+	for (int i = 42; i < 45; i++) {
+		undirected.addVertex(i);
+	}
+	undirected.addEdge(42, 43);
+	undirected.addEdge(43, 43);
+	undirected.addEdge(43, 44);
+	undirected.deleteVertex(43);
+	EXPECT_EQ(0u, undirected.nbEdges());
+	EXPECT_EQ(0u, undirected.vertexOutDegree(42));
+	undirected.addVertex(45);
+	undirected.addEdge(42, 45);
+	undirected.compact();
+	EXPECT_EQ(2u, undirected.nbEdges());
+	EXPECT_TRUE(undirected.hasEdge(45, 42));
+}
+
 TEST_F(AdjacencyListTest, vertexOutDegree) {
 	list.addVertex(42);
 	EXPECT_TRUE(list.vertexOutDegree(42) == 0);
@@ -228,6 +439,351 @@ TEST_F(AdjacencyListTest, hasEdge) {
 	EXPECT_FALSE(list.hasEdge(42, 43));
 }
 
+TEST_F(AdjacencyListTest, ranges) {
+	Adjacency_List<int> deferred(DEFERRED_DELETION);
+
+	EXPECT_TRUE(list.vertexRange().empty());
+	EXPECT_TRUE(list.edgeRange().empty());
+	EXPECT_THROW(list.neighborRange(42), logic_error);
+	for (int i = 42; i < 47; i++) {
+		deferred.addVertex(i);
+	}
+	deferred.addEdge(42, 43);
+	deferred.addEdge(42, 44);
+	deferred.addEdge(44, 42);
+	deferred.addEdge(45, 46);
+	deferred.addEdge(46, 46);
+	deferred.deleteVertex(43);
+
+	// the tombstone and the stale edge going to it are skipped
+	Adjacency_List<int>::vertex_range vertices = deferred.vertexRange();
+	EXPECT_EQ(deferred.vertices(), vector<int>(vertices.begin(), vertices.end()));
+	EXPECT_EQ(4, std::distance(vertices.begin(), vertices.end()));
+
+	Adjacency_List<int>::neighbor_range neighbors = deferred.neighborRange(42);
+	ASSERT_FALSE(neighbors.empty());
+	EXPECT_EQ(44, *neighbors.begin());
+	EXPECT_EQ(1, std::distance(neighbors.begin(), neighbors.end()));
+	EXPECT_FALSE(deferred.neighborRange(46).empty());
+
+	Adjacency_List<int>::edge_range edges = deferred.edgeRange();
+	vector<pair<int, int> > listed(edges.begin(), edges.end());
+	EXPECT_EQ(deferred.edges(), listed);
+	EXPECT_EQ(deferred.nbEdges(), listed.size());
+	EXPECT_EQ(42, edges.begin()->first);
+	EXPECT_EQ(44, edges.begin()->second);
+}
+
+TEST_F(AdjacencyListTest, descriptors) {
+	addVertices(4, 42);
+	EXPECT_THROW(list.descriptor(46), logic_error);
+
+	Vertex_Descriptor a = list.descriptor(42);
+	Vertex_Descriptor b = list.descriptor(43);
+	Vertex_Descriptor c = list.descriptor(44);
+
+	EXPECT_EQ(42, list.value(a));
+	EXPECT_TRUE(a != b);
+	EXPECT_LT(c.index(), list.indexBound());
+	list.addEdge(a, b);
+	list.addEdge(a, c);
+	list.addEdge(c, c);
+	EXPECT_THROW(list.addEdge(a, b), logic_error);
+	EXPECT_TRUE(list.hasEdge(42, 43));
+	EXPECT_TRUE(list.hasEdge(a, c));
+	EXPECT_FALSE(list.hasEdge(b, a));
+	EXPECT_EQ(2u, list.outDegree(a));
+	EXPECT_EQ(2u, list.inDegree(c));
+
+	Adjacency_List<int>::adjacent_range neighbors = list.neighbors(a);
+	vector<Vertex_Descriptor> adjacents(neighbors.begin(), neighbors.end());
+	ASSERT_EQ(2u, adjacents.size());
+	EXPECT_EQ(b, adjacents[0]);
+	EXPECT_EQ(c, adjacents[1]);
+	list.deleteEdge(a, b);
+	EXPECT_THROW(list.deleteEdge(a, b), logic_error);
+	EXPECT_EQ(1u, list.outDegree(a));
+
+	// with deferred deletion, the descriptors of the other vertices survive a vertex deletion
+	Adjacency_List<int> deferred(DEFERRED_DELETION);
+
+	deferred.addVertex(1);
+	deferred.addVertex(2);
+	deferred.addVertex(3);
+	Vertex_Descriptor three = deferred.descriptor(3);
+	deferred.addEdge(deferred.descriptor(1), three);
+	deferred.deleteVertex(2);
+	EXPECT_EQ(3, deferred.value(three));
+	EXPECT_EQ(1u, deferred.inDegree(three));
+	EXPECT_EQ(3u, deferred.indexBound());
+}
+
+TEST_F(AdjacencyListTest, policies) {
+	// the direction is fixed by the policy, whatever the flags say
+	Adjacency_List<int, Undirected, Unweighted> undirected;
+	Adjacency_List<int, Directed> directed(UNDIRECTED | REVERSE_ADJACENCY);
+
+	EXPECT_TRUE(undirected.hasConfiguration(UNDIRECTED));
+	EXPECT_FALSE(directed.hasConfiguration(UNDIRECTED));
+	for (int i = 42; i < 45; i++) {
+		undirected.addVertex(i);
+		directed.addVertex(i);
+	}
+	undirected.addEdge(42, 43);
+	undirected.addEdge(44, 44);
+	directed.addEdge(42, 43);
+	directed.addEdge(44, 43);
+	EXPECT_TRUE(undirected.hasEdge(43, 42));
+	EXPECT_FALSE(directed.hasEdge(43, 42));
+	EXPECT_EQ(2u, undirected.vertexOutDegree(44));
+	EXPECT_EQ(3u, undirected.nbEdges());
+	EXPECT_THROW(undirected.vertexIsSink(42), logic_error);
+	EXPECT_EQ(2u, directed.vertexPredecessors(43).size());
+	undirected.deleteEdge(43, 42);
+	EXPECT_FALSE(undirected.hasEdge(42, 43));
+
+	Adjacency_List<int, Directed> copy(directed);
+	EXPECT_TRUE(copy.hasEdge(44, 43));
+}
+
+TEST_F(AdjacencyListTest, highDegree) {
+	// enough edges on the hub to go over the hash threshold of its edge set, and back under it
+	addVertices(200, 0);
+	for (int i = 0; i < 200; i += 2) {
+		list.addEdge(0, i);
+	}
+	EXPECT_THROW(list.addEdge(0, 100), logic_error);
+	EXPECT_EQ(100u, list.vertexOutDegree(0));
+	for (int i = 0; i < 200; i++) {
+		EXPECT_EQ(i % 2 == 0, list.hasEdge(0, i));
+	}
+	for (int i = 0; i < 190; i += 4) {
+		list.deleteEdge(0, i);
+	}
+	EXPECT_THROW(list.deleteEdge(0, 4), logic_error);
+	for (int i = 0; i < 200; i++) {
+		EXPECT_EQ(i % 2 == 0 && (i % 4 != 0 || i >= 190), list.hasEdge(0, i));
+	}
+	list.deleteVertex(2);
+	EXPECT_FALSE(list.hasVertex(2));
+	EXPECT_TRUE(list.hasEdge(0, 6));
+	EXPECT_FALSE(list.hasEdge(0, 8));
+	EXPECT_TRUE(list.hasEdge(0, 192));
+	EXPECT_EQ(51u, list.vertexOutDegree(0));
+	EXPECT_EQ(51u, list.edges().size());
+	for (int i = 3; i < 198; i++) {
+		if (list.hasEdge(0, i)) {
+			list.deleteEdge(0, i);
+		}
+	}
+	EXPECT_EQ(1u, list.vertexOutDegree(0));
+	EXPECT_TRUE(list.hasEdge(0, 198));
+
+	Adjacency_List<int> undirected(UNDIRECTED);
+
+	for (int i = 0; i < 100; i++) {
+		undirected.addVertex(i);
+		undirected.addEdge(0, i);
+	}
+	EXPECT_THROW(undirected.addEdge(50, 0), logic_error);
+	undirected.deleteEdge(60, 0);
+	EXPECT_FALSE(undirected.hasEdge(0, 60));
+	EXPECT_TRUE(undirected.hasEdge(61, 0));
+	EXPECT_EQ(100u, undirected.vertexOutDegree(0));
+}
+
+TEST_F(AdjacencyListTest, weights) {
+	Adjacency_List<int, Directed, Weighted<double> > weighted;
+	Adjacency_List<int, Undirected, Weighted<double> > undirected;
+
+	EXPECT_TRUE(weighted.hasConfiguration(WEIGHTED));
+	for (int i = 0; i < 50; i++) {
+		weighted.addVertex(i);
+		undirected.addVertex(i);
+	}
+	// enough edges on vertex 0 to hash its edge set
+	for (int i = 1; i < 50; i++) {
+		weighted.addEdge(0, i, i / 2.0);
+	}
+	weighted.addEdge(1, 0);
+	EXPECT_THROW(weighted.addEdge(0, 1, 3.0), logic_error);
+	EXPECT_DOUBLE_EQ(0.5, weighted.edgeWeight(0, 1));
+	EXPECT_DOUBLE_EQ(24.5, weighted.edgeWeight(0, 49));
+	EXPECT_DOUBLE_EQ(0.0, weighted.edgeWeight(1, 0));
+	EXPECT_THROW(weighted.edgeWeight(2, 0), logic_error);
+	weighted.setEdgeWeight(0, 49, -1.0);
+	EXPECT_DOUBLE_EQ(-1.0, weighted.edgeWeight(0, 49));
+	EXPECT_THROW(weighted.setEdgeWeight(2, 0, 1.0), logic_error);
+
+	// the weights follow their edges when the edge sets are reorganized
+	weighted.deleteEdge(0, 1);
+	weighted.deleteVertex(10);
+	EXPECT_DOUBLE_EQ(-1.0, weighted.edgeWeight(0, 49));
+	EXPECT_DOUBLE_EQ(15.0, weighted.edgeWeight(0, 30));
+
+	double total = 0;
+	unsigned count = 0;
+	Adjacency_List<int, Directed, Weighted<double> >::weighted_range range = weighted.weightedNeighbors(weighted.descriptor(0));
+
+	for (Adjacency_List<int, Directed, Weighted<double> >::weighted_range::iterator it = range.begin(); it != range.end(); ++it) {
+		EXPECT_DOUBLE_EQ(weighted.edgeWeight(0, weighted.value(it->first)), it->second);
+		total += it->second;
+		count++;
+	}
+	EXPECT_EQ(47u, count);
+	EXPECT_DOUBLE_EQ((1225 - 1 - 10 - 49) / 2.0 - 1.0, total);
+
+	Adjacency_List<int, Directed, Weighted<double> > copy(weighted);
+	EXPECT_DOUBLE_EQ(-1.0, copy.edgeWeight(0, 49));
+
+	// both directions of an undirected edge share the weight
+	undirected.addEdge(3, 4, 2.5);
+	undirected.addEdge(5, 5, 1.5);
+	EXPECT_DOUBLE_EQ(2.5, undirected.edgeWeight(4, 3));
+	undirected.setEdgeWeight(4, 3, 7.0);
+	EXPECT_DOUBLE_EQ(7.0, undirected.edgeWeight(3, 4));
+	EXPECT_DOUBLE_EQ(1.5, undirected.edgeWeight(5, 5));
+
+	// unweighted edges weigh 1
+	addVertices(3, 0);
+	list.addEdge(0, 1);
+	EXPECT_EQ(1u, list.edgeWeight(0, 1));
+	EXPECT_EQ(1u, list.weightedNeighbors(list.descriptor(0)).begin()->second);
+	EXPECT_FALSE(list.hasConfiguration(WEIGHTED));
+}
+
+TEST_F(AdjacencyListTest, bulkInsertion) {
+	vector<int> vertices;
+	vector<pair<int, int> > edges;
+
+	for (int i = 0; i < 100; i++) {
+		vertices.push_back(i);
+		edges.push_back(make_pair(0, i));
+		if (i > 0) {
+			edges.push_back(make_pair(i, (i + 1) % 100));
+		}
+	}
+	list.addVertices(vertices.begin(), vertices.end());
+	list.addEdges(edges.begin(), edges.end());
+	EXPECT_EQ(100u, list.nbVertices());
+	EXPECT_EQ(199u, list.nbEdges());
+	EXPECT_EQ(100u, list.vertexOutDegree(0));
+	EXPECT_EQ(2u, list.vertexInDegree(2));
+	EXPECT_TRUE(list.hasEdge(42, 43));
+	EXPECT_FALSE(list.hasEdge(43, 42));
+
+	// same contents and order as the one-by-one insertions
+	Adjacency_List<int> single;
+
+	for (unsigned i = 0; i < vertices.size(); i++) {
+		single.addVertex(vertices[i]);
+	}
+	for (unsigned i = 0; i < edges.size(); i++) {
+		single.addEdge(edges[i].first, edges[i].second);
+	}
+	EXPECT_EQ(single.vertices(), list.vertices());
+	EXPECT_EQ(single.edges(), list.edges());
+
+	// a bad batch leaves the graph untouched
+	int dupVertices[] = { 100, 101, 100 };
+	int oldVertex[] = { 102, 5 };
+	pair<int, int> dupEdges[] = { make_pair(1, 2), make_pair(1, 2) };
+	pair<int, int> oldEdge[] = { make_pair(2, 1), make_pair(42, 43) };
+	pair<int, int> missing[] = { make_pair(2, 1), make_pair(42, 1000) };
+
+	EXPECT_THROW(list.addVertices(dupVertices, dupVertices + 3), logic_error);
+	EXPECT_THROW(list.addVertices(oldVertex, oldVertex + 2), logic_error);
+	EXPECT_THROW(list.addEdges(dupEdges, dupEdges + 2), logic_error);
+	EXPECT_THROW(list.addEdges(oldEdge, oldEdge + 2), logic_error);
+	EXPECT_THROW(list.addEdges(missing, missing + 2), logic_error);
+	EXPECT_EQ(100u, list.nbVertices());
+	EXPECT_EQ(199u, list.nbEdges());
+	EXPECT_FALSE(list.hasVertex(101));
+	EXPECT_FALSE(list.hasEdge(2, 1));
+
+	// in an undirected graph, (a, b) and (b, a) are the same edge
+	Adjacency_List<int> undirected(UNDIRECTED);
+	pair<int, int> both[] = { make_pair(1, 2), make_pair(2, 1) };
+	pair<int, int> loops[] = { make_pair(1, 1), make_pair(0, 2) };
+
+	undirected.addVertices(vertices.begin(), vertices.begin() + 3);
+	EXPECT_THROW(undirected.addEdges(both, both + 2), logic_error);
+	EXPECT_EQ(0u, undirected.nbEdges());
+	undirected.addEdges(loops, loops + 2);
+	EXPECT_EQ(3u, undirected.nbEdges());
+	EXPECT_EQ(2u, undirected.vertexOutDegree(1));
+	EXPECT_TRUE(undirected.hasEdge(2, 0));
+
+	Adjacency_List<Unhashed> unhashed;
+	Unhashed values[] = { 1, 2, 1 };
+
+	EXPECT_THROW(unhashed.addVertices(values, values + 3), logic_error);
+	unhashed.addVertices(values, values + 2);
+	EXPECT_EQ(2u, unhashed.nbVertices());
+}
+
+TEST_F(AdjacencyListTest, arenaAllocator) {
+	typedef Adjacency_List<int, Runtime_Direction, Unweighted, Arena_Allocator<unsigned> > Arena_List;
+	Arena_List arena(REVERSE_ADJACENCY | DEFERRED_DELETION);
+	Adjacency_List<int> heap(REVERSE_ADJACENCY | DEFERRED_DELETION);
+
+	// the same operations on both lists, with hashed edge sets on vertex 0
+	for (int i = 0; i < 200; i++) {
+		arena.addVertex(i);
+		heap.addVertex(i);
+	}
+	for (int i = 1; i < 200; i++) {
+		arena.addEdge(0, i);
+		heap.addEdge(0, i);
+		arena.addEdge(i, (i * 7) % 200);
+		heap.addEdge(i, (i * 7) % 200);
+	}
+	for (int i = 1; i < 200; i += 3) {
+		arena.deleteEdge(0, i);
+		heap.deleteEdge(0, i);
+	}
+	for (int i = 10; i < 200; i += 10) {
+		arena.deleteVertex(i);
+		heap.deleteVertex(i);
+	}
+	arena.addVertex(1000);
+	heap.addVertex(1000);
+	arena.addEdge(1000, 0);
+	heap.addEdge(1000, 0);
+	EXPECT_EQ(heap.edges(), arena.edges());
+	arena.compact();
+	heap.compact();
+	EXPECT_EQ(heap.vertices(), arena.vertices());
+	EXPECT_EQ(heap.edges(), arena.edges());
+	EXPECT_EQ(heap.vertexPredecessors(0), arena.vertexPredecessors(0));
+
+	// copies and assignments get their own arena
+	Arena_List copy(arena);
+	Arena_List assigned;
+
+	assigned = copy;
+	copy.clear();
+	EXPECT_EQ(0u, copy.nbVertices());
+	EXPECT_FALSE(copy.hasVertex(0));
+	copy.addVertex(1);
+	copy.addVertex(2);
+	copy.addEdge(1, 2);
+	EXPECT_EQ(1u, copy.nbEdges());
+	EXPECT_EQ(heap.edges(), assigned.edges());
+	EXPECT_EQ(heap.edges(), arena.edges());
+
+	// the freed blocks are reused by the next requests of the same size
+	Arena pool;
+	void *block = pool.allocate(24);
+
+	EXPECT_EQ(static_cast<size_t>(Arena::SLAB_SIZE), pool.capacity());
+	pool.deallocate(block, 24);
+	EXPECT_EQ(block, pool.allocate(32));
+	EXPECT_NE(block, pool.allocate(32));
+	pool.deallocate(pool.allocate(Arena::MAX_BLOCK + 1), Arena::MAX_BLOCK + 1); // from the heap
+	EXPECT_EQ(static_cast<size_t>(Arena::SLAB_SIZE), pool.capacity());
+}
+
 TEST_F(AdjacencyListTest, display) {
 	cout << list;
 	addVertices(6, 42);
@@ -301,3 +857,139 @@ TEST_F(AdjacencyListTest, AssignmentOperator) {
 	copy = list;
 	EXPECT_TRUE(copy == list);
 }
+
+TEST_F(AdjacencyListTest, MoveSemantics) {
+	Adjacency_List<string> words(REVERSE_ADJACENCY);
+	string heavy(100, 'x');
+
+	words.addVertex(std::move(heavy));
+	words.emplaceVertex(3, 'a');
+	words.emplaceVertex("b");
+	EXPECT_THROW(words.emplaceVertex(3, 'a'), logic_error);
+	EXPECT_TRUE(words.hasVertex(string(100, 'x')));
+	EXPECT_TRUE(words.hasVertex("aaa"));
+	words.addEdge("aaa", "b");
+
+	// the moved graph keeps everything, the source is left empty and usable
+	Adjacency_List<string> moved(std::move(words));
+
+	EXPECT_EQ(3u, moved.nbVertices());
+	EXPECT_TRUE(moved.hasEdge("aaa", "b"));
+	EXPECT_EQ(1u, moved.vertexPredecessors("b").size());
+	EXPECT_EQ(0u, words.nbVertices());
+	EXPECT_EQ(0u, words.nbEdges());
+	EXPECT_TRUE(words.hasConfiguration(REVERSE_ADJACENCY));
+	words.addVertex("b");
+	EXPECT_TRUE(words.hasVertex("b"));
+
+	moved = std::move(words);
+	EXPECT_EQ(1u, moved.nbVertices());
+	EXPECT_FALSE(moved.hasVertex("aaa"));
+	EXPECT_EQ(0u, words.nbVertices());
+
+	// an arena-backed list moves its arena along
+	Adjacency_List<int, Runtime_Direction, Unweighted, Arena_Allocator<unsigned> > arena;
+
+	for (int i = 0; i < 50; i++) {
+		arena.addVertex(i);
+	}
+	for (int i = 1; i < 50; i++) {
+		arena.addEdge(0, i);
+	}
+	Adjacency_List<int, Runtime_Direction, Unweighted, Arena_Allocator<unsigned> > arenaMoved(std::move(arena));
+
+	arenaMoved.deleteVertex(10);
+	EXPECT_EQ(48u, arenaMoved.vertexOutDegree(0));
+	arena.addVertex(1);
+	arena.addVertex(2);
+	arena.addEdge(1, 2);
+	EXPECT_EQ(1u, arena.nbEdges());
+
+	// moving allocates nothing, the arena of the source is only created with its next vertex
+	EXPECT_TRUE(std::is_nothrow_move_constructible<Adjacency_List<string> >::value);
+	EXPECT_TRUE(std::is_nothrow_move_assignable<Adjacency_List<string> >::value);
+	EXPECT_TRUE((std::is_nothrow_move_constructible<Adjacency_List<int, Directed, Unweighted, Arena_Allocator<unsigned> > >::value));
+	EXPECT_TRUE((std::is_nothrow_move_assignable<Adjacency_List<int, Directed, Unweighted, Arena_Allocator<unsigned> > >::value));
+	arenaMoved = std::move(arena);
+	arena = std::move(arenaMoved); // both sources without an arena
+	EXPECT_EQ(1u, arena.nbEdges());
+	arenaMoved.clear();
+	arenaMoved.addVertex(3);
+	EXPECT_TRUE(arenaMoved.hasVertex(3));
+}
+
+TEST_F(AdjacencyListTest, fingerprint) {
+	Adjacency_List<int> deferred(DEFERRED_DELETION);
+	Adjacency_List<int> reversed(DEFERRED_DELETION | REVERSE_ADJACENCY);
+	Adjacency_List<int> *graphs[3] = { &list, &deferred, &reversed };
+
+	EXPECT_EQ(Adjacency_List<int>().fingerprint(), list.fingerprint());
+	for (unsigned g = 0; g < 3; g++) {
+		for (int i = 42; i < 47; i++) {
+			graphs[g]->addVertex(i);
+		}
+		graphs[g]->addEdge(42, 43);
+		graphs[g]->addEdge(44, 43);
+		graphs[g]->addEdge(43, 43);
+		graphs[g]->addEdge(43, 45);
+		graphs[g]->deleteVertex(43);
+	}
+	// deletions, tombstones and stale edges end up with the same graph
+	Adjacency_List<int> expected;
+
+	for (int i = 42; i < 47; i++) {
+		if (i != 43) {
+			expected.addVertex(i);
+		}
+	}
+	for (unsigned g = 0; g < 3; g++) {
+		EXPECT_EQ(expected.fingerprint(), graphs[g]->fingerprint());
+		EXPECT_TRUE(*graphs[g] == expected);
+	}
+	deferred.compact();
+	deferred.addVertex(43);
+	deferred.addEdge(42, 43);
+	reversed.addVertex(43);
+	reversed.addEdge(42, 43);
+	EXPECT_TRUE(deferred == reversed);
+	EXPECT_TRUE(deferred.equals(reversed));
+	reversed.deleteEdge(42, 43);
+	reversed.addEdge(43, 42);
+	EXPECT_FALSE(deferred == reversed);
+	EXPECT_NE(deferred.fingerprint(), reversed.fingerprint());
+	deferred.clear();
+	EXPECT_EQ(Adjacency_List<int>().fingerprint(), deferred.fingerprint());
+
+	// the fingerprint recomputed between the deletion of a destination and of the source of its stale edge
+	Adjacency_List<int> chain(DEFERRED_DELETION);
+	Adjacency_List<int> alone;
+
+	for (int i = 1; i < 4; i++) {
+		chain.addVertex(i);
+	}
+	chain.addEdge(1, 2);
+	chain.deleteVertex(2);
+	chain.fingerprint();
+	chain.deleteVertex(1);
+	alone.addVertex(3);
+	EXPECT_EQ(alone.fingerprint(), chain.fingerprint());
+	EXPECT_TRUE(chain.equals(alone));
+	EXPECT_TRUE(chain == alone);
+
+	// no Vertex_Hash: the vertices and edges are compared one by one
+	Adjacency_List<Unhashed> unhashed;
+	Adjacency_List<Unhashed> other;
+
+	unhashed.addVertex(Unhashed(1));
+	unhashed.addVertex(Unhashed(2));
+	other.addVertex(Unhashed(2));
+	other.addVertex(Unhashed(1));
+	unhashed.addEdge(Unhashed(1), Unhashed(2));
+	other.addEdge(Unhashed(2), Unhashed(1));
+	EXPECT_EQ(unhashed.fingerprint(), other.fingerprint());
+	EXPECT_FALSE(unhashed.equals(other));
+	other.deleteEdge(Unhashed(2), Unhashed(1));
+	other.addEdge(Unhashed(1), Unhashed(2));
+	EXPECT_TRUE(unhashed.equals(other));
+	EXPECT_TRUE(unhashed == other);
+}
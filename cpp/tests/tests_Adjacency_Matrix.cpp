@@ -7,6 +7,9 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <string>
+#include <set>
+#include <type_traits>
 #include "gtest/gtest.h"
 #include "AdjacencyMatrix.h"
 
@@ -26,6 +29,13 @@ public:
 
 AdjacencyMatrixTest::AdjacencyMatrixTest() : directed_matrix(), undirected_matrix(UNDIRECTED) {}
 
+// a vertex type with no Vertex_Hash specialization
+struct Unhashed {
+	Unhashed(int p_v) : m_v(p_v) {}
+	bool operator==(const Unhashed &p_rhs) const { return m_v == p_rhs.m_v; }
+	int m_v;
+};
+
 TEST_F(AdjacencyMatrixTest, constructor) {
 	EXPECT_TRUE(directed_matrix.nbVertices() == 0);
 	EXPECT_TRUE(directed_matrix.nbEdges() == 0);
@@ -134,6 +144,32 @@ TEST_F(AdjacencyMatrixTest, hasVertex) {
 	EXPECT_TRUE(undirected_matrix.hasVertex(42));
 }
 
+TEST_F(AdjacencyMatrixTest, vertexIndex) {
+	for (int i = 42; i < 47; i++) {
+		directed_matrix.addVertex(i);
+	}
+	directed_matrix.addEdge(45, 46);
+	directed_matrix.deleteVertex(43);
+	// the vertices after the deleted one have been renumbered
+	EXPECT_FALSE(directed_matrix.hasVertex(43));
+	EXPECT_TRUE(directed_matrix.hasVertex(44));
+	EXPECT_TRUE(directed_matrix.hasEdge(45, 46));
+	directed_matrix.addVertex(43);
+	directed_matrix.addEdge(43, 46);
+	EXPECT_TRUE(directed_matrix.hasEdge(43, 46));
+	EXPECT_FALSE(directed_matrix.hasEdge(45, 43));
+
+	Adjacency_Matrix<Unhashed> unhashed(UNDIRECTED);
+
+	unhashed.addVertex(Unhashed(1));
+	unhashed.addVertex(Unhashed(2));
+	EXPECT_THROW(unhashed.addVertex(Unhashed(1)), logic_error);
+	unhashed.addEdge(Unhashed(1), Unhashed(2));
+	unhashed.deleteVertex(Unhashed(1));
+	EXPECT_FALSE(unhashed.hasVertex(Unhashed(1)));
+	EXPECT_TRUE(unhashed.hasVertex(Unhashed(2)));
+}
+
 TEST_F(AdjacencyMatrixTest, vertexInDegree) {
 	directed_matrix.addVertex(42);
 	EXPECT_TRUE(directed_matrix.vertexInDegree(42) == 0);
@@ -536,6 +572,213 @@ TEST_F(AdjacencyMatrixTest, hasEdge) {
 	EXPECT_TRUE(undirected_matrix.hasEdge(44, 47));
 }
 
+TEST_F(AdjacencyMatrixTest, manyVertices) {
+	// enough vertices to span several words per row
+	for (int i = 0; i < 150; i++) {
+		directed_matrix.addVertex(i);
+	}
+	for (int i = 0; i < 150; i++) {
+		directed_matrix.addEdge(i, (i * 7 + 1) % 150);
+		if (i % 10 == 0) {
+			directed_matrix.addEdge(i, 149);
+		}
+	}
+	EXPECT_EQ(165u, directed_matrix.nbEdges());
+	EXPECT_EQ(2u, directed_matrix.vertexOutDegree(70));
+	EXPECT_EQ(16u, directed_matrix.vertexInDegree(149));
+	EXPECT_EQ(165u, directed_matrix.edges().size());
+
+	// deleting a vertex removes its row and its column
+	directed_matrix.deleteVertex(70);
+	directed_matrix.deleteVertex(3);
+	EXPECT_EQ(148u, directed_matrix.nbVertices());
+	EXPECT_EQ(160u, directed_matrix.nbEdges());
+	EXPECT_EQ(15u, directed_matrix.vertexInDegree(149));
+	for (int i = 0; i < 150; i++) {
+		int dest = (i * 7 + 1) % 150;
+
+		if (i != 70 && i != 3 && dest != 70 && dest != 3) {
+			EXPECT_TRUE(directed_matrix.hasEdge(i, dest));
+		}
+	}
+	EXPECT_FALSE(directed_matrix.hasEdge(148, 149));
+}
+
+TEST_F(AdjacencyMatrixTest, reserveVertices) {
+	directed_matrix.reserveVertices(200);
+	undirected_matrix.reserveVertices(200);
+	for (int i = 0; i < 300; i++) {
+		directed_matrix.addVertex(i);
+		undirected_matrix.addVertex(i);
+		if (i > 0) {
+			directed_matrix.addEdge(i - 1, i);
+			undirected_matrix.addEdge(i - 1, i);
+		}
+	}
+	EXPECT_EQ(300u, directed_matrix.nbVertices());
+	EXPECT_EQ(299u, directed_matrix.nbEdges());
+	EXPECT_EQ(299u, undirected_matrix.nbEdges());
+	for (int i = 1; i < 300; i++) {
+		EXPECT_TRUE(directed_matrix.hasEdge(i - 1, i));
+		EXPECT_FALSE(directed_matrix.hasEdge(i, i - 1));
+		EXPECT_TRUE(undirected_matrix.hasEdge(i, i - 1));
+	}
+}
+
+TEST_F(AdjacencyMatrixTest, bulkInsertion) {
+	vector<int> vertices;
+	vector<pair<int, int> > edges;
+
+	for (int i = 0; i < 300; i++) {
+		vertices.push_back(i);
+		if (i > 0) {
+			edges.push_back(make_pair(i - 1, i));
+		}
+	}
+	directed_matrix.addVertices(vertices.begin(), vertices.end());
+	undirected_matrix.addVertices(vertices.begin(), vertices.end());
+	directed_matrix.addEdges(edges.begin(), edges.end());
+	undirected_matrix.addEdges(edges.begin(), edges.end());
+	EXPECT_EQ(300u, directed_matrix.nbVertices());
+	EXPECT_EQ(299u, directed_matrix.nbEdges());
+	EXPECT_EQ(299u, undirected_matrix.nbEdges());
+	EXPECT_TRUE(directed_matrix.hasEdge(148, 149));
+	EXPECT_FALSE(directed_matrix.hasEdge(149, 148));
+	EXPECT_TRUE(undirected_matrix.hasEdge(149, 148));
+
+	// a bad batch leaves the graph untouched
+	int dupVertices[] = { 300, 301, 300 };
+	int oldVertex[] = { 302, 5 };
+	pair<int, int> dupEdges[] = { make_pair(1, 0), make_pair(2, 0), make_pair(1, 0) };
+	pair<int, int> oldEdge[] = { make_pair(1, 0), make_pair(42, 43) };
+	pair<int, int> missing[] = { make_pair(1, 0), make_pair(42, 1000) };
+	pair<int, int> reversed[] = { make_pair(5, 7), make_pair(7, 5) };
+
+	EXPECT_THROW(directed_matrix.addVertices(dupVertices, dupVertices + 3), logic_error);
+	EXPECT_THROW(directed_matrix.addVertices(oldVertex, oldVertex + 2), logic_error);
+	EXPECT_THROW(directed_matrix.addEdges(dupEdges, dupEdges + 3), logic_error);
+	EXPECT_THROW(directed_matrix.addEdges(oldEdge, oldEdge + 2), logic_error);
+	EXPECT_THROW(directed_matrix.addEdges(missing, missing + 2), logic_error);
+	EXPECT_THROW(undirected_matrix.addEdges(reversed, reversed + 2), logic_error);
+	EXPECT_EQ(300u, directed_matrix.nbVertices());
+	EXPECT_FALSE(directed_matrix.hasVertex(301));
+	EXPECT_EQ(299u, directed_matrix.nbEdges());
+	EXPECT_FALSE(directed_matrix.hasEdge(1, 0));
+	EXPECT_FALSE(directed_matrix.hasEdge(2, 0));
+	EXPECT_EQ(299u, undirected_matrix.nbEdges());
+	EXPECT_FALSE(undirected_matrix.hasEdge(5, 7));
+	directed_matrix.addEdges(reversed, reversed + 2);
+	EXPECT_EQ(301u, directed_matrix.nbEdges());
+}
+
+TEST_F(AdjacencyMatrixTest, weights) {
+	Adjacency_Matrix<int, Runtime_Direction, Weighted<int> > weighted;
+	Adjacency_Matrix<int, Runtime_Direction, Weighted<int> > undirected(UNDIRECTED);
+
+	EXPECT_TRUE(weighted.hasConfiguration(WEIGHTED));
+	for (int i = 0; i < 100; i++) {
+		weighted.addVertex(i);
+		undirected.addVertex(i);
+	}
+	for (int i = 1; i < 100; i++) {
+		weighted.addEdge(0, i, 10 * i);
+		undirected.addEdge(i - 1, i, i);
+	}
+	weighted.addEdge(1, 0);
+	EXPECT_THROW(weighted.addEdge(0, 1, 3), logic_error);
+	EXPECT_THROW(weighted.addEdge(0, 100, 3), logic_error);
+	EXPECT_EQ(10, weighted.edgeWeight(0, 1));
+	EXPECT_EQ(0, weighted.edgeWeight(1, 0));
+	EXPECT_THROW(weighted.edgeWeight(2, 0), logic_error);
+	weighted.setEdgeWeight(0, 99, -1);
+	EXPECT_EQ(-1, weighted.edgeWeight(0, 99));
+	EXPECT_THROW(weighted.setEdgeWeight(2, 0, 1), logic_error);
+
+	// deleting a vertex renumbers the cells of the weights
+	weighted.deleteVertex(50);
+	undirected.deleteVertex(50);
+	EXPECT_EQ(-1, weighted.edgeWeight(0, 99));
+	EXPECT_EQ(510, weighted.edgeWeight(0, 51));
+	EXPECT_EQ(52, undirected.edgeWeight(52, 51));
+	EXPECT_EQ(49, undirected.edgeWeight(48, 49));
+	EXPECT_FALSE(undirected.hasEdge(49, 51));
+
+	// a deleted edge forgets its weight
+	weighted.deleteEdge(0, 2);
+	weighted.addEdge(0, 2);
+	EXPECT_EQ(0, weighted.edgeWeight(0, 2));
+
+	int total = 0;
+	Adjacency_Matrix<int, Runtime_Direction, Weighted<int> >::weighted_range range = undirected.weightedNeighbors(undirected.descriptor(20));
+
+	for (Adjacency_Matrix<int, Runtime_Direction, Weighted<int> >::weighted_range::iterator it = range.begin(); it != range.end(); ++it) {
+		total += it->second;
+	}
+	EXPECT_EQ(20 + 21, total);
+	undirected.setEdgeWeight(21, 20, 5);
+	EXPECT_EQ(5, undirected.edgeWeight(20, 21));
+
+	Adjacency_Matrix<int, Runtime_Direction, Weighted<int> > copy(weighted);
+	Adjacency_Matrix<int, Runtime_Direction, Weighted<int> > assigned;
+
+	assigned = copy;
+	EXPECT_EQ(-1, copy.edgeWeight(0, 99));
+	EXPECT_EQ(-1, assigned.edgeWeight(0, 99));
+
+	Adjacency_Matrix<int, Directed, Weighted<double> > fixed;
+
+	fixed.addVertex(1);
+	fixed.addVertex(2);
+	fixed.addEdge(1, 2, 0.25);
+	EXPECT_DOUBLE_EQ(0.25, fixed.edgeWeight(1, 2));
+
+	// unweighted edges weigh 1
+	directed_matrix.addVertex(1);
+	directed_matrix.addEdge(1, 1);
+	EXPECT_EQ(1u, directed_matrix.edgeWeight(1, 1));
+}
+
+TEST_F(AdjacencyMatrixTest, manyVerticesUndirected) {
+	vector<set<int> > reference(150);
+
+	for (int i = 0; i < 150; i++) {
+		undirected_matrix.addVertex(i);
+	}
+	for (int i = 0; i < 150; i++) {
+		int dest = (i * 7 + 1) % 150;
+
+		if (!undirected_matrix.hasEdge(i, dest)) {
+			undirected_matrix.addEdge(i, dest);
+			reference[i].insert(dest);
+			reference[dest].insert(i);
+		}
+	}
+	undirected_matrix.deleteVertex(70);
+	undirected_matrix.deleteVertex(3);
+	EXPECT_EQ(148u, undirected_matrix.nbVertices());
+
+	unsigned nbEdges = 0;
+
+	for (int i = 0; i < 150; i++) {
+		if (i == 70 || i == 3) {
+			continue;
+		}
+		vector<int> neighbors = undirected_matrix.vertexNeighborhood(i);
+		set<int> expected;
+
+		for (set<int>::const_iterator it = reference[i].begin(); it != reference[i].end(); ++it) {
+			if (*it != 70 && *it != 3) {
+				expected.insert(*it);
+				nbEdges += (*it <= i);
+			}
+		}
+		EXPECT_EQ(expected, set<int>(neighbors.begin(), neighbors.end()));
+		EXPECT_EQ(expected.size() + expected.count(i), undirected_matrix.vertexOutDegree(i));
+	}
+	EXPECT_EQ(nbEdges, undirected_matrix.nbEdges());
+	EXPECT_EQ(nbEdges, undirected_matrix.edges().size());
+}
+
 //TEST_F(AdjacencyMatrixTest, display) {
 //	cout << matrix;
 //	addVertices(6, 42);
@@ -555,6 +798,125 @@ TEST_F(AdjacencyMatrixTest, hasEdge) {
 //	cout << matrix;
 //}
 
+TEST_F(AdjacencyMatrixTest, ranges) {
+	// sparse rows over several words, so that whole empty words get skipped
+	for (int i = 0; i < 200; i++) {
+		directed_matrix.addVertex(i);
+		undirected_matrix.addVertex(i);
+	}
+	for (int i = 0; i < 200; i += 67) {
+		directed_matrix.addEdge(0, i);
+		directed_matrix.addEdge(i, 199);
+		undirected_matrix.addEdge(130, i);
+		undirected_matrix.addEdge(i, 199);
+	}
+	EXPECT_TRUE(directed_matrix.neighborRange(1).empty());
+	EXPECT_THROW(directed_matrix.neighborRange(200), logic_error);
+
+	vector<int> vertices(directed_matrix.vertexRange().begin(), directed_matrix.vertexRange().end());
+	EXPECT_EQ(directed_matrix.vertices(), vertices);
+
+	Adjacency_Matrix<int>::neighbor_range neighbors = directed_matrix.neighborRange(0);
+	vector<int> expected;
+	expected.push_back(0);
+	expected.push_back(67);
+	expected.push_back(134);
+	expected.push_back(199);
+	EXPECT_EQ(expected, vector<int>(neighbors.begin(), neighbors.end()));
+
+	// the undirected neighbors come from the row of the vertex, then from its column
+	undirected_matrix.addEdge(130, 130);
+	neighbors = undirected_matrix.neighborRange(130);
+	expected[2] = 130;
+	expected[3] = 134;
+	EXPECT_EQ(expected, vector<int>(neighbors.begin(), neighbors.end()));
+	EXPECT_EQ(undirected_matrix.vertexNeighborhood(130), vector<int>(neighbors.begin(), neighbors.end()));
+
+	// the edge ranges list the same edges as edges(), in the same order
+	Adjacency_Matrix<int>::edge_range edges = directed_matrix.edgeRange();
+	vector<pair<int, int> > listed(edges.begin(), edges.end());
+	EXPECT_EQ(directed_matrix.edges(), listed);
+	EXPECT_EQ(6u, listed.size());
+	edges = undirected_matrix.edgeRange();
+	listed.assign(edges.begin(), edges.end());
+	EXPECT_EQ(undirected_matrix.edges(), listed);
+	EXPECT_EQ(undirected_matrix.nbEdges(), listed.size());
+	EXPECT_EQ(130, edges.begin()->first);
+	EXPECT_EQ(0, edges.begin()->second);
+}
+
+TEST_F(AdjacencyMatrixTest, descriptors) {
+	for (int i = 42; i < 46; i++) {
+		directed_matrix.addVertex(i);
+		undirected_matrix.addVertex(i);
+	}
+	EXPECT_THROW(directed_matrix.descriptor(46), logic_error);
+
+	Vertex_Descriptor a = directed_matrix.descriptor(42);
+	Vertex_Descriptor b = directed_matrix.descriptor(43);
+	Vertex_Descriptor c = directed_matrix.descriptor(44);
+
+	EXPECT_EQ(43, directed_matrix.value(b));
+	EXPECT_EQ(4u, directed_matrix.indexBound());
+	directed_matrix.addEdge(a, b);
+	directed_matrix.addEdge(c, a);
+	EXPECT_THROW(directed_matrix.addEdge(a, b), logic_error);
+	EXPECT_TRUE(directed_matrix.hasEdge(42, 43));
+	EXPECT_FALSE(directed_matrix.hasEdge(b, a));
+	EXPECT_EQ(1u, directed_matrix.outDegree(a));
+	EXPECT_EQ(1u, directed_matrix.inDegree(a));
+	directed_matrix.deleteEdge(c, a);
+	EXPECT_THROW(directed_matrix.deleteEdge(c, a), logic_error);
+	EXPECT_EQ(0u, directed_matrix.inDegree(a));
+
+	// undirected: a loop counts twice, and the neighbors come in index order
+	a = undirected_matrix.descriptor(42);
+	c = undirected_matrix.descriptor(44);
+	undirected_matrix.addEdge(c, a);
+	undirected_matrix.addEdge(c, c);
+	undirected_matrix.addEdge(c, undirected_matrix.descriptor(45));
+	EXPECT_TRUE(undirected_matrix.hasEdge(a, c));
+	EXPECT_EQ(4u, undirected_matrix.outDegree(c));
+
+	Adjacency_Matrix<int>::adjacent_range neighbors = undirected_matrix.neighbors(c);
+	vector<Vertex_Descriptor> adjacents(neighbors.begin(), neighbors.end());
+	ASSERT_EQ(3u, adjacents.size());
+	EXPECT_EQ(a, adjacents[0]);
+	EXPECT_EQ(c, adjacents[1]);
+	EXPECT_EQ(45, undirected_matrix.value(adjacents[2]));
+}
+
+TEST_F(AdjacencyMatrixTest, policies) {
+	// the direction is fixed by the policy, whatever the flags say
+	Adjacency_Matrix<int, Undirected, Unweighted> undirected;
+	Adjacency_Matrix<int, Directed> directed(UNDIRECTED);
+
+	EXPECT_TRUE(undirected.hasConfiguration(UNDIRECTED));
+	EXPECT_FALSE(directed.hasConfiguration(UNDIRECTED));
+	for (int i = 42; i < 45; i++) {
+		undirected.addVertex(i);
+		directed.addVertex(i);
+		undirected_matrix.addVertex(i);
+	}
+	undirected.addEdge(42, 43);
+	undirected.addEdge(44, 44);
+	undirected_matrix.addEdge(42, 43);
+	undirected_matrix.addEdge(44, 44);
+	directed.addEdge(42, 43);
+	EXPECT_TRUE(undirected.hasEdge(43, 42));
+	EXPECT_FALSE(directed.hasEdge(43, 42));
+	EXPECT_EQ(2u, undirected.vertexOutDegree(44));
+	EXPECT_THROW(undirected.vertexIsSource(42), logic_error);
+	EXPECT_TRUE(directed.vertexIsSource(42));
+	EXPECT_EQ(undirected_matrix.edges(), undirected.edges());
+	EXPECT_EQ(undirected_matrix.vertexNeighborhood(43), undirected.vertexNeighborhood(43));
+	undirected.deleteVertex(43);
+	EXPECT_EQ(1u, undirected.nbEdges());
+
+	Adjacency_Matrix<int, Undirected> copy(undirected);
+	EXPECT_TRUE(copy.hasEdge(44, 44));
+}
+
 TEST_F(AdjacencyMatrixTest, CopyConstructor) {
 	Adjacency_Matrix<int>	copy(directed_matrix);
 
@@ -669,4 +1031,62 @@ TEST_F(AdjacencyMatrixTest, AssignmentOperator) {
 	EXPECT_TRUE(copy == directed_matrix);
 }
 
-
+TEST_F(AdjacencyMatrixTest, MoveSemantics) {
+	Adjacency_Matrix<string> words(UNDIRECTED);
+	string heavy(100, 'x');
+
+	words.addVertex(std::move(heavy));
+	words.emplaceVertex(3, 'a');
+	words.emplaceVertex("b");
+	EXPECT_THROW(words.emplaceVertex("b"), logic_error);
+	EXPECT_TRUE(words.hasVertex(string(100, 'x')));
+	words.addEdge("aaa", "b");
+
+	// the moved graph keeps everything, the source is left empty and usable
+	Adjacency_Matrix<string> moved(std::move(words));
+
+	EXPECT_EQ(3u, moved.nbVertices());
+	EXPECT_TRUE(moved.hasEdge("b", "aaa"));
+	EXPECT_EQ(0u, words.nbVertices());
+	EXPECT_EQ(0u, words.nbEdges());
+	words.addVertex("c");
+	words.addVertex("d");
+	words.addEdge("d", "c");
+	EXPECT_TRUE(words.hasEdge("c", "d")); // still undirected
+
+	moved = std::move(words);
+	EXPECT_EQ(2u, moved.nbVertices());
+	EXPECT_TRUE(moved.hasEdge("c", "d"));
+	EXPECT_FALSE(moved.hasVertex("aaa"));
+	EXPECT_EQ(0u, words.nbVertices());
+
+	// moving allocates nothing: the source shares an empty matrix until its next vertex
+	EXPECT_TRUE(std::is_nothrow_move_constructible<Adjacency_Matrix<string> >::value);
+	EXPECT_TRUE(std::is_nothrow_move_assignable<Adjacency_Matrix<string> >::value);
+	Adjacency_Matrix<string> copy(words);
+	Adjacency_Matrix<string> empty(std::move(words));
+
+	EXPECT_TRUE(copy.edges().empty());
+	EXPECT_TRUE(empty.hasConfiguration(UNDIRECTED));
+	EXPECT_TRUE(words.vertices().empty());
+	EXPECT_EQ(Adjacency_Matrix<string>(UNDIRECTED).fingerprint(), words.fingerprint());
+	words.reserveVertices(10);
+	copy.addVertex("a");
+	EXPECT_EQ(0u, empty.nbVertices());
+	EXPECT_EQ(0u, words.nbVertices());
+
+	Adjacency_Matrix<int, Directed> directed;
+
+	directed.addVertex(1);
+	directed.addVertex(2);
+	directed.addEdge(1, 2);
+	Adjacency_Matrix<int, Directed> directedMoved(std::move(directed));
+
+	directed = std::move(directedMoved);
+	EXPECT_TRUE(directed.hasEdge(1, 2));
+	directedMoved.addVertex(2);
+	directedMoved.addVertex(1);
+	directedMoved.addEdge(2, 1);
+	EXPECT_FALSE(directedMoved.hasEdge(1, 2));
+	EXPECT_FALSE(directed.hasEdge(2, 1));
+}
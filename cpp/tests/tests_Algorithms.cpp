@@ -0,0 +1,118 @@
+//! \file tests_Algorithms.cpp
+//! \brief Generic algorithms unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm>
+#include "gtest/gtest.h"
+#include "SGL.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  AlgorithmsTest fixture
+// *****************************************************************************
+class AlgorithmsTest: public ::testing::Test {
+public:
+	Adjacency_List<int> list;
+	Adjacency_Matrix<int> matrix;
+	Adjacency_List<int, Undirected> undirected_list;
+
+protected:
+	void SetUp();
+};
+
+// the same graph in every class: 0->1, 0->2, 1->3, 2->3, 3->4, 5->0 (5 can't be reached from 0)
+void AlgorithmsTest::SetUp() {
+	int edges[][2] = { { 0, 1 }, { 0, 2 }, { 1, 3 }, { 2, 3 }, { 3, 4 }, { 5, 0 } };
+
+	for (int i = 0; i < 6; i++) {
+		list.addVertex(i);
+		matrix.addVertex(i);
+		undirected_list.addVertex(i);
+	}
+	for (unsigned i = 0; i < 6; i++) {
+		list.addEdge(edges[i][0], edges[i][1]);
+		matrix.addEdge(edges[i][0], edges[i][1]);
+		undirected_list.addEdge(edges[i][0], edges[i][1]);
+	}
+}
+
+// collects the visited vertices (and their depth, when there's one)
+struct Collector {
+	Collector(vector<int> &p_order) : m_order(p_order) {}
+	void operator()(Vertex_Descriptor p_v) const { m_order.push_back(p_v.index()); }
+	void operator()(Vertex_Descriptor p_v, unsigned p_depth) const { m_order.push_back(p_v.index() * 10 + p_depth); }
+	vector<int> &m_order;
+};
+
+TEST_F(AlgorithmsTest, staticGraphConcept) {
+	EXPECT_TRUE(Is_Static_Graph<Adjacency_List<int> >::value);
+	EXPECT_TRUE((Is_Static_Graph<Adjacency_Matrix<int, Directed> >::value));
+	EXPECT_TRUE(Is_Static_Graph<Compressed_Sparse_Row<int> >::value);
+	EXPECT_FALSE(Is_Static_Graph<AbstractGraph<int> >::value);
+	EXPECT_FALSE(Is_Static_Graph<int>::value);
+}
+
+TEST_F(AlgorithmsTest, breadthFirstSearch) {
+	vector<int> fromList, fromMatrix, fromCSR;
+	Compressed_Sparse_Row<int> csr(list);
+
+	breadthFirstSearch(list, list.descriptor(0), Collector(fromList));
+	breadthFirstSearch(matrix, matrix.descriptor(0), Collector(fromMatrix));
+	breadthFirstSearch(csr, csr.descriptor(0), Collector(fromCSR));
+	// vertex * 10 + depth
+	int expected[] = { 0, 11, 21, 32, 43 };
+	EXPECT_EQ(vector<int>(expected, expected + 5), fromList);
+	EXPECT_EQ(fromList, fromMatrix);
+	EXPECT_EQ(fromList, fromCSR);
+
+	vector<int> undirected;
+	breadthFirstSearch(undirected_list, undirected_list.descriptor(4), Collector(undirected));
+	EXPECT_EQ(6u, undirected.size());
+	EXPECT_EQ(54, undirected.back());
+}
+
+TEST_F(AlgorithmsTest, depthFirstSearch) {
+	vector<int> fromList, fromMatrix;
+
+	depthFirstSearch(list, list.descriptor(0), Collector(fromList));
+	depthFirstSearch(matrix, matrix.descriptor(0), Collector(fromMatrix));
+	int expected[] = { 0, 1, 3, 4, 2 };
+	EXPECT_EQ(vector<int>(expected, expected + 5), fromList);
+	EXPECT_EQ(fromList, fromMatrix);
+
+	vector<int> fromSink;
+	depthFirstSearch(list, list.descriptor(4), Collector(fromSink));
+	EXPECT_EQ(1u, fromSink.size());
+
+	// a long path doesn't use the call stack
+	Adjacency_List<int> path;
+	for (int i = 0; i < 20000; i++) {
+		path.addVertex(i);
+		if (i > 0) {
+			path.addEdge(path.descriptor(i - 1), path.descriptor(i));
+		}
+	}
+	vector<int> order;
+	depthFirstSearch(path, path.descriptor(0), Collector(order));
+	EXPECT_EQ(20000u, order.size());
+	EXPECT_EQ(19999, order.back());
+}
+
+TEST_F(AlgorithmsTest, shortestPathLengths) {
+	vector<unsigned> lengths = shortestPathLengths(matrix, matrix.descriptor(0));
+
+	ASSERT_EQ(6u, lengths.size());
+	EXPECT_EQ(0u, lengths[0]);
+	EXPECT_EQ(1u, lengths[2]);
+	EXPECT_EQ(2u, lengths[3]);
+	EXPECT_EQ(3u, lengths[4]);
+	EXPECT_EQ(UNREACHABLE, lengths[5]);
+
+	lengths = shortestPathLengths(undirected_list, undirected_list.descriptor(5));
+	EXPECT_EQ(3u, lengths[3]);
+	EXPECT_EQ(4u, lengths[4]);
+}
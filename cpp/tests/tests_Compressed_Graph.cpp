@@ -0,0 +1,246 @@
+//! \file tests_Compressed_Graph.cpp
+//! \brief Compressed_Graph class unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "CompressedGraph.h"
+#include "GraphBuilder.h"
+#include "GraphLoader.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  CompressedGraphTest fixture
+// *****************************************************************************
+class CompressedGraphTest: public ::testing::Test {
+public:
+	CompressedGraphTest() : undirected_list(UNDIRECTED), path("tests_Compressed_Graph.txt") {}
+	Adjacency_List<int> list;
+	Adjacency_List<int> undirected_list;
+	string path;
+
+protected:
+	void SetUp();
+	void TearDown() { std::remove(path.c_str()); }
+	static void expectSameGraph(const Compressed_Sparse_Row<int> &, const Compressed_Graph<int> &);
+};
+
+// 2000 vertices, each with a few runs of consecutive neighbors, scattered neighbors, sometimes a loop
+void CompressedGraphTest::SetUp() {
+	for (int i = 0; i < 2000; i++) {
+		list.addVertex(i);
+		undirected_list.addVertex(i);
+	}
+	for (int i = 0; i < 2000; i++) {
+		vector<int> dests;
+
+		for (int d = 1; d <= i % 9; d++) {
+			dests.push_back((i + d) % 2000); // a run, as long as MIN_INTERVAL from i % 9 == 4
+		}
+		for (int d = 0; d < i % 5; d++) {
+			dests.push_back((i * 37 + d * 311) % 2000);
+		}
+		if (i % 3 == 0) {
+			dests.push_back(i / 2 + 500); // a long gap backwards or forwards
+		}
+		if (i % 7 == 0) {
+			dests.push_back(i);
+		}
+		for (unsigned pos = 0; pos < dests.size(); pos++) {
+			if (!list.hasEdge(i, dests[pos])) {
+				list.addEdge(i, dests[pos]);
+			}
+			if (!undirected_list.hasEdge(i, dests[pos])) {
+				undirected_list.addEdge(i, dests[pos]);
+			}
+		}
+	}
+}
+
+// the compressed graph answers like the CSR built from the same source
+void CompressedGraphTest::expectSameGraph(const Compressed_Sparse_Row<int> &p_expected, const Compressed_Graph<int> &p_graph) {
+	vector<unsigned> indexes;
+
+	EXPECT_EQ(p_expected.getConfiguration(), p_graph.getConfiguration());
+	EXPECT_EQ(p_expected.nbVertices(), p_graph.nbVertices());
+	EXPECT_EQ(p_expected.nbEdges(), p_graph.nbEdges());
+	EXPECT_EQ(p_expected.vertices(), p_graph.vertices());
+	EXPECT_EQ(p_expected.edges(), p_graph.edges());
+	EXPECT_EQ(p_expected.fingerprint(), p_graph.fingerprint());
+	for (unsigned v = 0; v < p_expected.indexBound(); v++) {
+		Vertex_Descriptor vd(v);
+		Compressed_Sparse_Row<int>::adjacent_range expected = p_expected.neighbors(vd);
+		Compressed_Graph<int>::adjacent_range adjacents = p_graph.neighbors(vd);
+		Compressed_Graph<int>::adjacent_range::iterator it = adjacents.begin();
+		unsigned pos = 0;
+
+		ASSERT_EQ(p_expected.value(vd), p_graph.value(vd));
+		EXPECT_EQ(p_expected.inDegree(vd), p_graph.inDegree(vd));
+		EXPECT_EQ(p_expected.outDegree(vd), p_graph.outDegree(vd));
+		p_graph.neighborIndexes(vd, indexes);
+		for (Compressed_Sparse_Row<int>::adjacent_range::iterator e = expected.begin(); e != expected.end(); ++e, ++it, pos++) {
+			ASSERT_TRUE(it != adjacents.end());
+			ASSERT_EQ((*e).index(), (*it).index());
+			ASSERT_LT(pos, indexes.size());
+			ASSERT_EQ((*e).index(), indexes[pos]);
+		}
+		EXPECT_TRUE(it == adjacents.end());
+		EXPECT_EQ(pos, indexes.size());
+	}
+	for (int i = 0; i < 2000; i += 13) {
+		EXPECT_EQ(p_expected.vertexNeighborhood(i, true), p_graph.vertexNeighborhood(i, true));
+		for (int j = 0; j < 2000; j++) {
+			ASSERT_EQ(p_expected.hasEdge(i, j), p_graph.hasEdge(i, j));
+		}
+	}
+}
+
+TEST_F(CompressedGraphTest, conversions) {
+	Compressed_Sparse_Row<int> csr(list);
+	Compressed_Sparse_Row<int> undirected_csr(undirected_list);
+	Compressed_Graph<int> compressed(csr);
+	Compressed_Graph<int> undirected_compressed(undirected_list);
+	Adjacency_Matrix<int> matrix;
+	Compressed_Graph<int> empty(UNDIRECTED);
+
+	expectSameGraph(csr, compressed);
+	expectSameGraph(undirected_csr, undirected_compressed);
+	EXPECT_EQ(list.fingerprint(), compressed.fingerprint());
+	EXPECT_EQ(undirected_list.fingerprint(), undirected_compressed.fingerprint());
+
+	matrix.addVertex(3);
+	matrix.addVertex(1);
+	matrix.addEdge(3, 1);
+	matrix.addEdge(1, 1);
+	Compressed_Graph<int> small(matrix);
+
+	EXPECT_EQ(2u, small.nbEdges());
+	EXPECT_TRUE(small.hasEdge(3, 1));
+	EXPECT_FALSE(small.hasEdge(1, 3));
+	EXPECT_TRUE(small.vertexIsSource(3));
+	EXPECT_EQ(matrix.fingerprint(), small.fingerprint());
+
+	EXPECT_EQ(0u, empty.nbVertices());
+	EXPECT_EQ(0u, empty.encodedSize());
+	EXPECT_TRUE(empty.edges().empty());
+	EXPECT_THROW(empty.vertexOutDegree(1), logic_error);
+	EXPECT_THROW(empty.hasEdge(1, 2), logic_error);
+
+	// moved graphs keep their lists without allocating, the source is left empty
+	EXPECT_TRUE(std::is_nothrow_move_constructible<Compressed_Graph<int> >::value);
+	EXPECT_TRUE(std::is_nothrow_move_assignable<Compressed_Graph<int> >::value);
+	Compressed_Graph<int> moved(std::move(compressed));
+	Compressed_Sparse_Row<int> movedCsr(std::move(csr));
+
+	EXPECT_EQ(movedCsr.nbEdges(), moved.nbEdges());
+	EXPECT_EQ(0u, compressed.nbVertices());
+	EXPECT_EQ(0u, Compressed_Graph<int>(csr).nbVertices());
+	csr = std::move(movedCsr);
+	compressed = std::move(moved);
+	EXPECT_EQ(csr.edges(), compressed.edges());
+}
+
+TEST_F(CompressedGraphTest, encoding) {
+	Adjacency_List<int> ranges;
+	Compressed_Sparse_Row<int> csr;
+
+	// 0 -> 1..1000 and 1000 -> 0..999: one interval each
+	for (int i = 0; i <= 1000; i++) {
+		ranges.addVertex(i);
+	}
+	for (int i = 1; i <= 1000; i++) {
+		ranges.addEdge(0, i);
+		ranges.addEdge(1000, i - 1);
+	}
+	Compressed_Graph<int> compressed(ranges);
+
+	EXPECT_EQ(2000u, compressed.nbEdges());
+	EXPECT_EQ(1000u, compressed.vertexOutDegree(0));
+	EXPECT_TRUE(compressed.hasEdge(0, 1000));
+	EXPECT_FALSE(compressed.hasEdge(0, 0));
+	EXPECT_TRUE(compressed.hasEdge(1000, 0));
+	EXPECT_FALSE(compressed.hasEdge(1000, 1000));
+	// per list: degree, interval count, start, length; 1 byte per other vertex (degree 0)
+	EXPECT_GT(2 * 12 + 999u, compressed.encodedSize());
+
+	// 500 -> the even indexes (one-byte gaps, decoded 8 or 16 at a time) and the squares (longer gaps, mixed in),
+	// 2 -> two intervals one index apart, then a residual
+	for (int i = 0; i < 1000; i += 2) {
+		ranges.addEdge(500, i);
+	}
+	for (int i = 1; i * i < 1000; i += 2) {
+		ranges.addEdge(500, i * i);
+	}
+	for (int i = 10; i < 23; i++) {
+		if (i != 15 && i != 21) {
+			ranges.addEdge(2, i);
+		}
+	}
+	csr = Compressed_Sparse_Row<int>(ranges);
+	Compressed_Graph<int> mixed(csr);
+	vector<unsigned> indexes;
+
+	for (int v = 0; v <= 1000; v++) {
+		mixed.neighborIndexes(Vertex_Descriptor(v), indexes);
+		ASSERT_EQ(csr.outDegree(Vertex_Descriptor(v)), indexes.size());
+		for (unsigned pos = 0; pos < indexes.size(); pos++) {
+			ASSERT_TRUE(csr.hasEdge(Vertex_Descriptor(v), Vertex_Descriptor(indexes[pos])));
+			ASSERT_TRUE(pos == 0 || indexes[pos - 1] < indexes[pos]);
+			ASSERT_TRUE(mixed.hasEdge(Vertex_Descriptor(v), Vertex_Descriptor(indexes[pos])));
+		}
+	}
+	EXPECT_EQ(csr.edges(), mixed.edges());
+	EXPECT_EQ(csr.fingerprint(), mixed.fingerprint());
+
+	// the scattered lists need at most 5 bytes per neighbor, most of the fixture's gaps take one or two
+	Compressed_Graph<int> fixture(list);
+
+	EXPECT_GT(3 * fixture.nbEdges(), fixture.encodedSize());
+	EXPECT_LT(fixture.nbEdges(), fixture.encodedSize());
+}
+
+TEST_F(CompressedGraphTest, builder) {
+	Graph_Builder<int> builder(4);
+	Compressed_Graph<int> built(UNDIRECTED);
+	Compressed_Graph<int> loaded;
+	ofstream out(path.c_str(), ios::binary);
+
+	for (int i = 0; i < 2000; i++) {
+		builder.addVertex(i);
+	}
+	vector<pair<int, int> > edges = undirected_list.edges();
+
+	for (unsigned pos = 0; pos < edges.size(); pos++) {
+		builder.addEdge(edges[pos].first, edges[pos].second);
+	}
+	builder.build(built);
+	expectSameGraph(Compressed_Sparse_Row<int>(undirected_list), built);
+	EXPECT_THROW(builder.build(built), logic_error);
+
+	edges = list.edges();
+	for (unsigned pos = 0; pos < edges.size(); pos++) {
+		out << edges[pos].first << ' ' << edges[pos].second << '\n';
+	}
+	out.close();
+	Graph_Loader<int>(4, 1000).load(path, loaded);
+	EXPECT_EQ(list.nbEdges(), loaded.nbEdges());
+	EXPECT_EQ(list.fingerprint(), loaded.fingerprint());
+}
+
+TEST_F(CompressedGraphTest, immutable) {
+	Compressed_Graph<int> compressed(list);
+
+	EXPECT_THROW(compressed.addVertex(2000), logic_error);
+	EXPECT_THROW(compressed.deleteVertex(0), logic_error);
+	EXPECT_THROW(compressed.addEdge(0, 1), logic_error);
+	EXPECT_THROW(compressed.deleteEdge(0, 1), logic_error);
+	EXPECT_THROW(compressed.descriptor(2000), logic_error);
+	EXPECT_EQ(Compressed_Sparse_Row<int>(list).edges(), compressed.edges());
+}
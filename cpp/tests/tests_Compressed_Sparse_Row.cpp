@@ -0,0 +1,338 @@
+//! \file tests_Compressed_Sparse_Row.cpp
+//! \brief Compressed_Sparse_Row class unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "CompressedSparseRow.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  CompressedSparseRowTest fixture
+// *****************************************************************************
+class CompressedSparseRowTest: public ::testing::Test {
+public:
+	CompressedSparseRowTest();
+	Adjacency_List<int> list;
+	Adjacency_List<int> undirected_list;
+	Adjacency_Matrix<int> matrix;
+	Adjacency_Matrix<int> undirected_matrix;
+
+protected:
+	void SetUp();
+};
+
+CompressedSparseRowTest::CompressedSparseRowTest() : undirected_list(UNDIRECTED), undirected_matrix(UNDIRECTED) {}
+
+// the same small graph in the four source graphs: 42->43, 42->45, 43->42, 44->44, 45->43
+void CompressedSparseRowTest::SetUp() {
+	int edges[][2] = { { 42, 45 }, { 42, 43 }, { 43, 42 }, { 44, 44 }, { 45, 43 } };
+
+	for (int i = 42; i < 47; i++) {
+		list.addVertex(i);
+		undirected_list.addVertex(i);
+		matrix.addVertex(i);
+		undirected_matrix.addVertex(i);
+	}
+	for (unsigned i = 0; i < 5; i++) {
+		list.addEdge(edges[i][0], edges[i][1]);
+		matrix.addEdge(edges[i][0], edges[i][1]);
+		if (!undirected_list.hasEdge(edges[i][0], edges[i][1])) {
+			undirected_list.addEdge(edges[i][0], edges[i][1]);
+			undirected_matrix.addEdge(edges[i][0], edges[i][1]);
+		}
+	}
+}
+
+TEST_F(CompressedSparseRowTest, constructor) {
+	Compressed_Sparse_Row<int> empty;
+
+	EXPECT_TRUE(empty.nbVertices() == 0);
+	EXPECT_TRUE(empty.nbEdges() == 0);
+	EXPECT_FALSE(empty.hasVertex(42));
+
+	Compressed_Sparse_Row<int> fromList(list);
+	Compressed_Sparse_Row<int> fromMatrix(matrix);
+
+	EXPECT_EQ(5u, fromList.nbVertices());
+	EXPECT_EQ(5u, fromList.nbEdges());
+	EXPECT_EQ(5u, fromMatrix.nbVertices());
+	EXPECT_EQ(5u, fromMatrix.nbEdges());
+	EXPECT_EQ(fromList.edges(), fromMatrix.edges());
+
+	// moving allocates nothing, and the source is left an empty graph
+	EXPECT_TRUE(std::is_nothrow_move_constructible<Compressed_Sparse_Row<int> >::value);
+	EXPECT_TRUE(std::is_nothrow_move_assignable<Compressed_Sparse_Row<int> >::value);
+	Compressed_Sparse_Row<int> moved(std::move(fromList));
+
+	EXPECT_EQ(5u, moved.nbEdges());
+	EXPECT_EQ(0u, fromList.nbVertices());
+	EXPECT_FALSE(fromList.hasVertex(42));
+	EXPECT_TRUE(Adjacency_List<int>(fromList).edges().empty());
+	fromList = std::move(moved);
+	EXPECT_EQ(fromMatrix.edges(), fromList.edges());
+}
+
+TEST_F(CompressedSparseRowTest, immutable) {
+	Compressed_Sparse_Row<int> csr(list);
+
+	EXPECT_THROW(csr.addVertex(1), logic_error);
+	EXPECT_THROW(csr.deleteVertex(42), logic_error);
+	EXPECT_THROW(csr.addEdge(42, 44), logic_error);
+	EXPECT_THROW(csr.deleteEdge(42, 43), logic_error);
+}
+
+TEST_F(CompressedSparseRowTest, directedQueries) {
+	Compressed_Sparse_Row<int> csr(list);
+
+	EXPECT_THROW(csr.hasEdge(42, 41), logic_error);
+	EXPECT_THROW(csr.vertexInDegree(41), logic_error);
+	EXPECT_TRUE(csr.hasEdge(42, 43));
+	EXPECT_TRUE(csr.hasEdge(42, 45));
+	EXPECT_TRUE(csr.hasEdge(44, 44));
+	EXPECT_FALSE(csr.hasEdge(43, 45));
+	EXPECT_EQ(2u, csr.vertexOutDegree(42));
+	EXPECT_EQ(2u, csr.vertexInDegree(43));
+	EXPECT_TRUE(csr.vertexIsSource(46));
+	EXPECT_TRUE(csr.vertexIsSink(46));
+	EXPECT_FALSE(csr.vertexIsSource(45));
+
+	// the neighbors are sorted by index
+	vector<int> neighbors = csr.vertexNeighborhood(42);
+
+	ASSERT_EQ(2u, neighbors.size());
+	EXPECT_EQ(43, neighbors[0]);
+	EXPECT_EQ(45, neighbors[1]);
+	EXPECT_EQ(3u, csr.vertexNeighborhood(42, true).size());
+	EXPECT_EQ(1u, csr.vertexNeighborhood(44, true).size());
+}
+
+// a vertex type with no Vertex_Hash specialization: the vertices are looked up by a linear search
+struct Unhashed {
+	Unhashed(int p_v) : m_v(p_v) {}
+	bool operator==(const Unhashed &p_rhs) const { return m_v == p_rhs.m_v; }
+	int m_v;
+};
+
+TEST_F(CompressedSparseRowTest, lookup) {
+	Compressed_Sparse_Row<int> csr(list);
+	Adjacency_List<Unhashed> unhashedList;
+
+	EXPECT_TRUE(csr.hasVertex(46));
+	EXPECT_FALSE(csr.hasVertex(41));
+	EXPECT_EQ(4u, csr.descriptor(46).index());
+	EXPECT_THROW(csr.descriptor(41), logic_error);
+
+	unhashedList.addVertex(Unhashed(1));
+	unhashedList.addVertex(Unhashed(2));
+	unhashedList.addEdge(Unhashed(2), Unhashed(1));
+	Compressed_Sparse_Row<Unhashed> unhashed(unhashedList);
+
+	EXPECT_TRUE(unhashed.hasVertex(Unhashed(2)));
+	EXPECT_FALSE(unhashed.hasVertex(Unhashed(3)));
+	EXPECT_TRUE(unhashed.hasEdge(Unhashed(2), Unhashed(1)));
+	EXPECT_FALSE(unhashed.hasEdge(Unhashed(1), Unhashed(2)));
+	EXPECT_THROW(unhashed.hasEdge(Unhashed(1), Unhashed(3)), logic_error);
+	EXPECT_EQ(1u, unhashed.vertexInDegree(Unhashed(1)));
+}
+
+TEST_F(CompressedSparseRowTest, undirectedQueries) {
+	Compressed_Sparse_Row<int> fromList(undirected_list);
+	Compressed_Sparse_Row<int> fromMatrix(undirected_matrix);
+
+	EXPECT_THROW(fromList.vertexIsSource(42), logic_error);
+	EXPECT_EQ(4u, fromList.nbEdges());
+	EXPECT_EQ(4u, fromMatrix.nbEdges());
+	EXPECT_EQ(fromList.edges(), fromMatrix.edges());
+	EXPECT_TRUE(fromMatrix.hasEdge(43, 42));
+	EXPECT_TRUE(fromMatrix.hasEdge(43, 45));
+	EXPECT_TRUE(fromMatrix.hasEdge(45, 43));
+	EXPECT_EQ(2u, fromMatrix.vertexOutDegree(44)); // a loop counts twice
+	EXPECT_EQ(undirected_matrix.vertexOutDegree(43), fromMatrix.vertexOutDegree(43));
+	EXPECT_EQ(undirected_list.vertexOutDegree(43), fromList.vertexOutDegree(43));
+	EXPECT_EQ(fromList.vertexNeighborhood(43), fromMatrix.vertexNeighborhood(43));
+}
+
+TEST_F(CompressedSparseRowTest, deferredDeletion) {
+	Adjacency_List<int> deferred(DEFERRED_DELETION);
+
+	for (int i = 42; i < 45; i++) {
+		deferred.addVertex(i);
+	}
+	deferred.addEdge(42, 43);
+	deferred.addEdge(44, 43);
+	deferred.addEdge(44, 42);
+	deferred.deleteVertex(43);
+
+	// the tombstones and the edges going to them are left out
+	Compressed_Sparse_Row<int> csr(deferred);
+
+	EXPECT_EQ(2u, csr.nbVertices());
+	EXPECT_EQ(1u, csr.nbEdges());
+	EXPECT_TRUE(csr.hasEdge(44, 42));
+	EXPECT_FALSE(csr.hasVertex(43));
+}
+
+TEST_F(CompressedSparseRowTest, policies) {
+	Adjacency_Matrix<int, Undirected> matrix;
+
+	matrix.addVertex(1);
+	matrix.addVertex(2);
+	matrix.addEdge(2, 1);
+
+	Compressed_Sparse_Row<int> csr(matrix);
+
+	EXPECT_TRUE(csr.hasConfiguration(UNDIRECTED));
+	EXPECT_TRUE(csr.hasEdge(1, 2));
+	EXPECT_EQ(1u, csr.nbEdges());
+}
+
+TEST_F(CompressedSparseRowTest, conversions) {
+	Compressed_Sparse_Row<int> csr(list);
+	Adjacency_Matrix<int> fromList(list);
+	Adjacency_List<int> fromMatrix(matrix);
+	Adjacency_List<int> fromCsr(csr);
+	Adjacency_Matrix<int> matrixFromCsr(csr);
+	Adjacency_Matrix<int> undirectedFromList(undirected_list);
+	Adjacency_List<int> undirectedFromMatrix(undirected_matrix);
+
+	EXPECT_EQ(matrix.vertices(), fromList.vertices());
+	EXPECT_EQ(matrix.nbEdges(), fromList.nbEdges());
+	EXPECT_EQ(matrix.nbEdges(), matrixFromCsr.nbEdges());
+	EXPECT_EQ(list.nbEdges(), fromMatrix.nbEdges());
+	EXPECT_EQ(list.nbEdges(), fromCsr.nbEdges());
+	EXPECT_EQ(undirected_matrix.nbEdges(), undirectedFromList.nbEdges());
+	EXPECT_EQ(undirected_list.nbEdges(), undirectedFromMatrix.nbEdges());
+	for (int i = 42; i < 47; i++) {
+		EXPECT_EQ(list.vertexInDegree(i), fromMatrix.vertexInDegree(i));
+		EXPECT_EQ(list.vertexOutDegree(i), fromCsr.vertexOutDegree(i));
+		EXPECT_EQ(list.vertexInDegree(i), fromCsr.vertexInDegree(i));
+		EXPECT_EQ(undirected_list.vertexOutDegree(i), undirectedFromMatrix.vertexOutDegree(i));
+		for (int j = 42; j < 47; j++) {
+			EXPECT_EQ(matrix.hasEdge(i, j), fromList.hasEdge(i, j));
+			EXPECT_EQ(matrix.hasEdge(i, j), matrixFromCsr.hasEdge(i, j));
+			EXPECT_EQ(list.hasEdge(i, j), fromMatrix.hasEdge(i, j));
+			EXPECT_EQ(list.hasEdge(i, j), fromCsr.hasEdge(i, j));
+			EXPECT_EQ(undirected_matrix.hasEdge(i, j), undirectedFromList.hasEdge(i, j));
+			EXPECT_EQ(undirected_list.hasEdge(i, j), undirectedFromMatrix.hasEdge(i, j));
+		}
+	}
+	// the converted graphs are complete graphs of their own
+	fromMatrix.addEdge(46, 42);
+	fromMatrix.deleteVertex(43);
+	EXPECT_FALSE(fromMatrix.hasVertex(43));
+	EXPECT_EQ(1u, fromMatrix.vertexInDegree(42));
+	EXPECT_THROW((Adjacency_Matrix<int, Directed>(undirected_list).nbVertices()), logic_error);
+
+	EXPECT_THROW((Adjacency_List<int, Undirected>(matrix).nbVertices()), logic_error);
+
+	// tombstones, reverse index and weights
+	Adjacency_List<int, Directed, Weighted<double> > weighted(DEFERRED_DELETION);
+
+	for (int i = 1; i < 5; i++) {
+		weighted.addVertex(i);
+	}
+	weighted.addEdge(1, 2, 0.5);
+	weighted.addEdge(3, 4, 1.5);
+	weighted.addEdge(4, 2, 2.5);
+	weighted.deleteVertex(3);
+
+	Adjacency_Matrix<int, Directed, Weighted<double> > weightedMatrix(weighted);
+	Adjacency_Matrix<int, Directed> unweightedMatrix(weighted);
+
+	weightedMatrix.reserveVertices(10); // the conversion must not have left the storage inconsistent
+	EXPECT_EQ(3u, weightedMatrix.nbVertices());
+	EXPECT_EQ(2u, weightedMatrix.nbEdges());
+	EXPECT_EQ(2.5, weightedMatrix.edgeWeight(4, 2));
+	EXPECT_EQ(1u, unweightedMatrix.edgeWeight(1, 2));
+
+	Adjacency_List<int, Directed, Weighted<double> > back(weightedMatrix);
+	Adjacency_Matrix<int> reversed(REVERSE_ADJACENCY);
+
+	EXPECT_EQ(0.5, back.edgeWeight(1, 2));
+	reversed.addVertex(1);
+	reversed.addVertex(2);
+	reversed.addEdge(1, 2);
+	EXPECT_EQ(vector<int>(1, 1), Adjacency_List<int>(reversed).vertexPredecessors(2));
+}
+
+TEST_F(CompressedSparseRowTest, matrixCopy) {
+	Adjacency_Matrix<int> copy(matrix);
+	Adjacency_Matrix<int, Undirected, Weighted<int> > weighted;
+
+	matrix.deleteEdge(42, 43);
+	EXPECT_TRUE(copy.hasEdge(42, 43));
+	EXPECT_EQ(5u, copy.nbEdges());
+	copy.addVertex(1);
+	copy.addEdge(1, 42);
+	EXPECT_FALSE(matrix.hasVertex(1));
+	weighted.addVertex(1);
+	weighted.addVertex(2);
+	weighted.addEdge(1, 2, 7);
+
+	Adjacency_Matrix<int, Undirected, Weighted<int> > weightedCopy(weighted);
+
+	EXPECT_EQ(7, weightedCopy.edgeWeight(2, 1));
+}
+
+TEST_F(CompressedSparseRowTest, equality) {
+	Compressed_Sparse_Row<int> csr(list);
+	Compressed_Sparse_Row<int> undirectedCsr(undirected_list);
+	Adjacency_List<int> fromMatrix(matrix);
+
+	// the same graph gives the same fingerprint in every representation
+	EXPECT_EQ(list.fingerprint(), matrix.fingerprint());
+	EXPECT_EQ(list.fingerprint(), csr.fingerprint());
+	EXPECT_EQ(list.fingerprint(), fromMatrix.fingerprint());
+	EXPECT_EQ(undirected_list.fingerprint(), undirected_matrix.fingerprint());
+	EXPECT_EQ(undirected_list.fingerprint(), undirectedCsr.fingerprint());
+	EXPECT_NE(list.fingerprint(), undirected_list.fingerprint());
+	EXPECT_TRUE(list.equals(matrix));
+	EXPECT_TRUE(matrix.equals(csr));
+	EXPECT_TRUE(undirected_matrix.equals(undirected_list));
+	EXPECT_TRUE(undirectedCsr.equals(undirected_matrix));
+	EXPECT_FALSE(list.equals(undirected_list));
+	EXPECT_TRUE(fromMatrix == list);
+
+	// the fingerprints kept up to date match the ones computed from scratch
+	list.deleteVertex(43);
+	matrix.deleteVertex(43);
+	undirected_list.deleteVertex(42);
+	undirected_matrix.deleteVertex(42);
+	EXPECT_EQ(list.fingerprint(), matrix.fingerprint());
+	EXPECT_EQ(list.fingerprint(), Compressed_Sparse_Row<int>(list).fingerprint());
+	EXPECT_EQ(undirected_list.fingerprint(), Compressed_Sparse_Row<int>(undirected_matrix).fingerprint());
+	EXPECT_TRUE(list.equals(matrix));
+	EXPECT_TRUE(undirected_list.equals(undirected_matrix));
+	EXPECT_FALSE(fromMatrix == list);
+
+	// an edge in the other direction makes a different graph
+	list.addEdge(46, 42);
+	matrix.addEdge(42, 46);
+	EXPECT_EQ(list.nbEdges(), matrix.nbEdges());
+	EXPECT_NE(list.fingerprint(), matrix.fingerprint());
+	EXPECT_FALSE(list.equals(matrix));
+	matrix.deleteEdge(42, 46);
+	matrix.addEdge(46, 42);
+	EXPECT_TRUE(list.equals(matrix));
+
+	// the order of insertion doesn't matter
+	Adjacency_Matrix<int> reordered;
+
+	for (int i = 46; i > 41; i--) {
+		if (i != 43) {
+			reordered.addVertex(i);
+		}
+	}
+	reordered.addEdge(46, 42);
+	reordered.addEdge(42, 45);
+	reordered.addEdge(44, 44);
+	EXPECT_TRUE(reordered == matrix);
+	reordered.deleteEdge(44, 44);
+	EXPECT_FALSE(reordered == matrix);
+}
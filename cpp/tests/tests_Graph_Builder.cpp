@@ -0,0 +1,198 @@
+//! \file tests_Graph_Builder.cpp
+//! \brief Graph_Builder class unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include "gtest/gtest.h"
+#include "GraphBuilder.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  GraphBuilderTest fixture
+// *****************************************************************************
+class GraphBuilderTest: public ::testing::Test {
+public:
+	GraphBuilderTest() : builder(4) {}
+	Graph_Builder<int> builder;
+
+protected:
+	static void produce(Graph_Builder<int> *p_builder, int p_thread, int p_nbThreads);
+};
+
+// ring of 100000 vertices (several tasks per pass) plus chords to 0, each edge added twice, shared out between the threads
+void GraphBuilderTest::produce(Graph_Builder<int> *p_builder, int p_thread, int p_nbThreads) {
+	Graph_Builder<int>::Producer producer(*p_builder);
+
+	for (int repeat = 0; repeat < 2; repeat++) {
+		for (int i = p_thread; i < 100000; i += p_nbThreads) {
+			producer.addEdge(i, (i + 1) % 100000);
+			if (i % 10 == 0) {
+				producer.addEdge(i, 0);
+			}
+		}
+	}
+}
+
+TEST_F(GraphBuilderTest, directed) {
+	Adjacency_List<int> list;
+	Adjacency_List<int> expected;
+
+	builder.addVertex(2000); // isolated
+	builder.addEdge(5, 3);
+	builder.addEdge(5, 1);
+	builder.addEdge(5, 3);
+	builder.addEdge(1, 1);
+	builder.build(list);
+	EXPECT_EQ(4u, list.nbVertices());
+	EXPECT_EQ(3u, list.nbEdges());
+	EXPECT_EQ(2u, list.vertexOutDegree(5));
+	EXPECT_EQ(2u, list.vertexInDegree(1));
+	EXPECT_TRUE(list.hasEdge(1, 1));
+	EXPECT_FALSE(list.hasEdge(3, 5));
+	EXPECT_EQ(0u, list.vertexInDegree(2000));
+	EXPECT_THROW(list.addEdge(5, 1), logic_error);
+	list.addEdge(3, 5);
+	EXPECT_EQ(4u, list.nbEdges());
+
+	// the builder is empty again, and won't fill a graph that isn't
+	builder.addEdge(7, 8);
+	EXPECT_THROW(builder.build(list), logic_error);
+	builder.build(expected);
+	EXPECT_EQ(2u, expected.nbVertices());
+}
+
+TEST_F(GraphBuilderTest, undirected) {
+	Adjacency_List<int> list(UNDIRECTED);
+	Compressed_Sparse_Row<int> csr(UNDIRECTED);
+
+	builder.addEdge(1, 2);
+	builder.addEdge(2, 1);
+	builder.addEdge(3, 3);
+	builder.addEdge(2, 3);
+	builder.build(list);
+	EXPECT_EQ(5u, list.nbEdges()); // both directions of 1-2 and 2-3, the loop once
+	EXPECT_TRUE(list.hasEdge(1, 2));
+	EXPECT_TRUE(list.hasEdge(3, 2));
+	EXPECT_EQ(3u, list.vertexOutDegree(3));
+	EXPECT_EQ(3u, list.vertexInDegree(3));
+
+	builder.addEdge(1, 2);
+	builder.addEdge(2, 1);
+	builder.addEdge(3, 3);
+	builder.addEdge(2, 3);
+	builder.build(csr);
+	EXPECT_EQ(3u, csr.nbEdges());
+	EXPECT_TRUE(csr.hasEdge(2, 1));
+	EXPECT_TRUE(csr.hasEdge(3, 3));
+	EXPECT_EQ(2u, csr.vertexOutDegree(2));
+}
+
+TEST_F(GraphBuilderTest, producers) {
+	const int nbThreads = 4;
+	vector<thread> threads;
+	Compressed_Sparse_Row<int> csr;
+	Adjacency_List<int> reference;
+
+	for (int t = 0; t < nbThreads; t++) {
+		threads.push_back(thread(produce, &builder, t, nbThreads));
+	}
+	for (int t = 0; t < nbThreads; t++) {
+		threads[t].join();
+	}
+	builder.build(csr);
+	for (int i = 0; i < 100000; i++) {
+		reference.addVertex(i);
+	}
+	for (int i = 0; i < 100000; i++) {
+		reference.addEdge(i, (i + 1) % 100000);
+		if (i % 10 == 0 && !reference.hasEdge(i, 0)) {
+			reference.addEdge(i, 0);
+		}
+	}
+	EXPECT_EQ(reference.nbVertices(), csr.nbVertices());
+	EXPECT_EQ(reference.nbEdges(), csr.nbEdges());
+	for (int i = 0; i < 100000; i++) {
+		EXPECT_EQ(reference.vertexOutDegree(i), csr.vertexOutDegree(i));
+		EXPECT_EQ(reference.vertexInDegree(i), csr.vertexInDegree(i));
+	}
+	vector<pair<int, int> > built = csr.edges();
+	vector<pair<int, int> > expected = reference.edges();
+
+	sort(built.begin(), built.end());
+	sort(expected.begin(), expected.end());
+	EXPECT_EQ(expected, built);
+}
+
+TEST_F(GraphBuilderTest, reverseAdjacency) {
+	Adjacency_List<int> list(REVERSE_ADJACENCY);
+	vector<int> predecessors;
+
+	builder.addEdge(1, 3);
+	builder.addEdge(2, 3);
+	builder.addEdge(3, 1);
+	builder.build(list);
+	predecessors = list.vertexPredecessors(3);
+	sort(predecessors.begin(), predecessors.end());
+	EXPECT_EQ(2u, predecessors.size());
+	EXPECT_EQ(1, predecessors[0]);
+	EXPECT_EQ(2, predecessors[1]);
+	list.deleteVertex(2);
+	EXPECT_EQ(1u, list.vertexPredecessors(3).size());
+}
+
+TEST_F(GraphBuilderTest, arenaList) {
+	Adjacency_List<int, Undirected, Unweighted, Arena_Allocator<unsigned> > list;
+	Adjacency_List<int, Undirected> reference;
+
+	for (int i = 0; i < 1000; i++) {
+		builder.addEdge(i, (i * 3) % 1000);
+	}
+	builder.build(list);
+	for (int i = 0; i < 1000; i++) {
+		builder.addEdge(i, (i * 3) % 1000);
+	}
+	builder.build(reference);
+	EXPECT_EQ(reference.nbEdges(), list.nbEdges());
+	EXPECT_EQ(reference.edges(), list.edges());
+	list.deleteVertex(3);
+	EXPECT_FALSE(list.hasVertex(3));
+	EXPECT_EQ(1u, list.vertexOutDegree(1)); // 667-1 is left
+}
+
+TEST_F(GraphBuilderTest, weights) {
+	Adjacency_List<int, Undirected, Weighted<double> > list;
+	Adjacency_Matrix<int, Directed, Weighted<int> > matrix;
+	Adjacency_List<int> unweighted;
+	Graph_Builder<int>::Producer producer(builder);
+
+	builder.addEdge(1, 2); // before the first weighted edge
+	builder.addEdge(2, 3, 0.5);
+	builder.addEdge(3, 2, 0.25); // the same undirected edge, lighter
+	builder.addEdge(1, 1, 4);
+	producer.addEdge(3, 4);
+	producer.addEdge(4, 5, -2);
+	producer.flush();
+	builder.build(list);
+	EXPECT_EQ(9u, list.nbEdges()); // both directions, the loop once
+	EXPECT_EQ(Graph_Builder<int>::DEFAULT_WEIGHT, list.edgeWeight(2, 1));
+	EXPECT_EQ(0.25, list.edgeWeight(2, 3));
+	EXPECT_EQ(0.25, list.edgeWeight(3, 2));
+	EXPECT_EQ(4, list.edgeWeight(1, 1));
+	EXPECT_EQ(-2, list.edgeWeight(5, 4));
+
+	builder.addEdge(1, 2, 2.75);
+	builder.addEdge(2, 1);
+	builder.build(matrix);
+	EXPECT_EQ(2, matrix.edgeWeight(1, 2)); // converted to the weight type
+	EXPECT_EQ(1, matrix.edgeWeight(2, 1));
+
+	// dropped by an unweighted graph
+	builder.addEdge(1, 2, 2.75);
+	builder.build(unweighted);
+	EXPECT_EQ(1u, unweighted.nbEdges());
+}
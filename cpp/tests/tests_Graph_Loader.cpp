@@ -0,0 +1,189 @@
+//! \file tests_Graph_Loader.cpp
+//! \brief Graph_Loader class unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "GraphLoader.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  GraphLoaderTest fixture
+// *****************************************************************************
+class GraphLoaderTest: public ::testing::Test {
+public:
+	GraphLoaderTest() : loader(4, 16), path("tests_Graph_Loader.txt") {}
+	Graph_Loader<int> loader; // chunks of 16 bytes: a few lines each, some cut in the middle
+	string path;
+
+protected:
+	void TearDown() { std::remove(path.c_str()); }
+	void write(const string &p_content) { ofstream(path.c_str(), ios::binary) << p_content; }
+};
+
+TEST_F(GraphLoaderTest, edgeList) {
+	Adjacency_List<int> list;
+	Adjacency_List<short> shorts;
+
+	write("# a SNAP header, longer than a chunk: FromNodeId ToNodeId\n"
+			"1\t2\n"
+			"\n"
+			"1 3 0.5\r\n" // a weight, a Windows end of line
+			"3,1\n"
+			"  -7   3  \n"
+			"% another comment\n"
+			"1 2\n"
+			"4 4"); // no end of line
+	loader.load(path, list);
+	EXPECT_EQ(5u, list.nbVertices());
+	EXPECT_EQ(5u, list.nbEdges()); // 1->2 read twice
+	EXPECT_TRUE(list.hasEdge(1, 2));
+	EXPECT_TRUE(list.hasEdge(1, 3));
+	EXPECT_TRUE(list.hasEdge(3, 1));
+	EXPECT_TRUE(list.hasEdge(-7, 3));
+	EXPECT_TRUE(list.hasEdge(4, 4));
+	EXPECT_FALSE(list.hasEdge(2, 1));
+	EXPECT_THROW(loader.load(path, list), logic_error);
+
+	// the vertices must fit in the vertex type
+	write("1 2\n70000 1\n");
+	EXPECT_THROW(Graph_Loader<short>().load(path, shorts), runtime_error);
+}
+
+TEST_F(GraphLoaderTest, bigEdgeList) {
+	Compressed_Sparse_Row<int> csr(UNDIRECTED);
+	Adjacency_Matrix<int, Directed> matrix;
+	ofstream out(path.c_str(), ios::binary);
+
+	// ring of 20000 vertices plus chords to 0, each edge once each way
+	for (int i = 0; i < 20000; i++) {
+		out << i << ' ' << (i + 1) % 20000 << '\n' << (i + 1) % 20000 << ' ' << i << '\n';
+		if (i % 10 == 0 && i > 1) {
+			out << i << '\t' << 0 << '\n';
+		}
+	}
+	out.close();
+	Graph_Loader<int>(4, 1000).load(path, csr);
+	EXPECT_EQ(20000u, csr.nbVertices());
+	EXPECT_EQ(21999u, csr.nbEdges());
+	EXPECT_TRUE(csr.hasEdge(19999, 0));
+	EXPECT_TRUE(csr.hasEdge(0, 19990));
+	EXPECT_EQ(3u, csr.vertexOutDegree(12340));
+
+	Graph_Loader<int>(3, 777).load(path, matrix);
+	EXPECT_EQ(20000u, matrix.nbVertices());
+	EXPECT_EQ(41999u, matrix.nbEdges());
+	EXPECT_TRUE(matrix.hasEdge(19990, 0));
+	EXPECT_FALSE(matrix.hasEdge(0, 19990));
+}
+
+TEST_F(GraphLoaderTest, matrixMarket) {
+	Adjacency_Matrix<int, Directed> matrix;
+	Adjacency_List<int> undirected_list(UNDIRECTED);
+	vector<int> vertices;
+
+	write("%%MatrixMarket matrix coordinate pattern symmetric\n"
+			"% a comment\n"
+			"%\n"
+			"5 5 4\n"
+			"2 1\n"
+			"3 1\n"
+			"3 3\n"
+			"4 2\n");
+	loader.load(path, matrix, Graph_Loader<int>::MATRIX_MARKET);
+	vertices = matrix.vertices();
+	EXPECT_EQ(vector<int>({ 1, 2, 3, 4, 5 }), vertices); // all the rows, in order, isolated ones included
+	EXPECT_EQ(7u, matrix.nbEdges()); // both ways, the loop once
+	EXPECT_TRUE(matrix.hasEdge(1, 2));
+	EXPECT_TRUE(matrix.hasEdge(2, 1));
+	EXPECT_TRUE(matrix.hasEdge(3, 3));
+	EXPECT_TRUE(matrix.hasEdge(2, 4));
+
+	write("%%MatrixMarket matrix coordinate real general\n"
+			"3 3 3\n"
+			"1 2 0.25\n"
+			"2 1 -1e-3\n"
+			"2 3 7\n");
+	loader.load(path, undirected_list, Graph_Loader<int>::MATRIX_MARKET);
+	EXPECT_EQ(3u, undirected_list.nbVertices());
+	EXPECT_TRUE(undirected_list.hasEdge(3, 2));
+	EXPECT_EQ(1u, undirected_list.vertexOutDegree(1)); // 1-2 is there twice
+}
+
+TEST_F(GraphLoaderTest, weights) {
+	Adjacency_List<int, Directed, Weighted<double> > list;
+	Adjacency_Matrix<int, Directed, Weighted<float> > matrix;
+	Adjacency_List<int, Undirected, Weighted<double> > pattern;
+	Adjacency_List<int, Undirected, Weighted<double> > invalid;
+
+	write("1 2 0.25\n"
+			"2 3 7.5\n"
+			"3 1\n" // no weight
+			"4 4 -1.5e2 whatever\n"
+			"4 5 +12345678901234567890123\n" // more digits than a double holds
+			"5 6 3.\n"
+			"6 7 .125E-1\n");
+	loader.load(path, list);
+	EXPECT_EQ(0.25, list.edgeWeight(1, 2));
+	EXPECT_EQ(7.5, list.edgeWeight(2, 3));
+	EXPECT_EQ(Graph_Builder<int>::DEFAULT_WEIGHT, list.edgeWeight(3, 1));
+	EXPECT_EQ(-150, list.edgeWeight(4, 4));
+	EXPECT_EQ(12345678901234567890123.0, list.edgeWeight(4, 5));
+	EXPECT_EQ(3, list.edgeWeight(5, 6));
+	EXPECT_EQ(0.0125, list.edgeWeight(6, 7));
+
+	// the values of a skew-symmetric matrix, the opposite one mirrored
+	write("%%MatrixMarket matrix coordinate real skew-symmetric\n"
+			"3 3 2\n"
+			"2 1 0.5\n"
+			"3 2 -4\n");
+	loader.load(path, matrix, Graph_Loader<int>::MATRIX_MARKET);
+	EXPECT_EQ(4u, matrix.nbEdges());
+	EXPECT_EQ(0.5f, matrix.edgeWeight(2, 1));
+	EXPECT_EQ(-0.5f, matrix.edgeWeight(1, 2));
+	EXPECT_EQ(4.f, matrix.edgeWeight(2, 3));
+
+	// no values in a pattern matrix
+	write("%%MatrixMarket matrix coordinate pattern general\n"
+			"2 2 1\n"
+			"2 1 3\n");
+	loader.load(path, pattern, Graph_Loader<int>::MATRIX_MARKET);
+	EXPECT_EQ(Graph_Builder<int>::DEFAULT_WEIGHT, pattern.edgeWeight(1, 2));
+
+	write("1 2 0.5x\n");
+	EXPECT_THROW(loader.load(path, invalid), runtime_error);
+	write("1 2 e3\n");
+	EXPECT_THROW(loader.load(path, invalid), runtime_error);
+}
+
+TEST_F(GraphLoaderTest, invalidFiles) {
+	Adjacency_List<int> list;
+	Compressed_Sparse_Row<int> csr;
+
+	EXPECT_THROW(loader.load("no_such_file.txt", list), runtime_error);
+	write("1 2\n3 three\n4 5\n");
+	EXPECT_THROW(loader.load(path, list), runtime_error);
+	write("1 2\n3\n");
+	EXPECT_THROW(loader.load(path, list), runtime_error);
+	write("1 2x\n");
+	EXPECT_THROW(loader.load(path, list), runtime_error);
+	EXPECT_EQ(0u, list.nbVertices()); // untouched by the failures
+
+	write("1 2\n");
+	EXPECT_THROW(loader.load(path, list, Graph_Loader<int>::MATRIX_MARKET), runtime_error);
+	write("%%MatrixMarket matrix array real general\n2 2\n1\n0\n0\n1\n");
+	EXPECT_THROW(loader.load(path, list, Graph_Loader<int>::MATRIX_MARKET), runtime_error);
+	write("%%MatrixMarket matrix coordinate pattern general\n2 2 3\n1 2\n2 1\n");
+	EXPECT_THROW(loader.load(path, list, Graph_Loader<int>::MATRIX_MARKET), runtime_error);
+	write("%%MatrixMarket matrix coordinate pattern general\n2 2 1\n1 3\n");
+	EXPECT_THROW(loader.load(path, csr, Graph_Loader<int>::MATRIX_MARKET), runtime_error);
+	write("%%MatrixMarket matrix coordinate pattern general\n2 2 1\n0 1\n");
+	EXPECT_THROW(loader.load(path, csr, Graph_Loader<int>::MATRIX_MARKET), runtime_error);
+	EXPECT_EQ(0u, csr.nbVertices());
+}
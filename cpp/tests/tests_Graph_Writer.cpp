@@ -0,0 +1,118 @@
+//! \file tests_Graph_Writer.cpp
+//! \brief Graph_Writer class unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "GraphWriter.h"
+#include "GraphLoader.h"
+#include "CompressedSparseRow.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  GraphWriterTest fixture
+// *****************************************************************************
+class GraphWriterTest: public ::testing::Test {
+public:
+	GraphWriterTest() : undirected_matrix(UNDIRECTED), path("tests_Graph_Writer.txt") {}
+	Adjacency_Matrix<int> matrix;
+	Adjacency_Matrix<int> undirected_matrix;
+	string path;
+
+protected:
+	void SetUp();
+	void TearDown() { std::remove(path.c_str()); }
+};
+
+void GraphWriterTest::SetUp() {
+	for (int i = -1; i < 3; i++) {
+		matrix.addVertex(i);
+		undirected_matrix.addVertex(i);
+	}
+	matrix.addEdge(-1, 0);
+	matrix.addEdge(0, -1);
+	matrix.addEdge(1, 1);
+	undirected_matrix.addEdge(-1, 0);
+	undirected_matrix.addEdge(1, 1);
+	undirected_matrix.addEdge(1, 0);
+}
+
+TEST_F(GraphWriterTest, formats) {
+	ostringstream dot, edges, adjacency, undirected_dot, undirected_edges;
+
+	Graph_Writer<Adjacency_Matrix<int> >(matrix).write(dot, Graph_Writer<Adjacency_Matrix<int> >::DOT);
+	EXPECT_EQ("digraph {\n\t-1;\n\t-1 -> 0;\n\t0;\n\t0 -> -1;\n\t1;\n\t1 -> 1;\n\t2;\n}\n", dot.str());
+	Graph_Writer<Adjacency_Matrix<int> >(matrix).write(edges, Graph_Writer<Adjacency_Matrix<int> >::EDGE_LIST);
+	EXPECT_EQ("# Directed graph: 4 vertices\n-1\t0\n0\t-1\n1\t1\n", edges.str());
+	Graph_Writer<Adjacency_Matrix<int> >(matrix).write(adjacency, Graph_Writer<Adjacency_Matrix<int> >::ADJACENCY);
+	EXPECT_EQ("-1: 0\n0: -1\n1: 1\n2:\n", adjacency.str());
+
+	// each undirected edge once, but all the neighbors in the adjacency
+	Graph_Writer<Adjacency_Matrix<int> >(undirected_matrix).write(undirected_dot, Graph_Writer<Adjacency_Matrix<int> >::DOT);
+	EXPECT_EQ("graph {\n\t-1;\n\t-1 -- 0;\n\t0;\n\t0 -- 1;\n\t1;\n\t1 -- 1;\n\t2;\n}\n", undirected_dot.str());
+	Graph_Writer<Adjacency_Matrix<int> >(undirected_matrix).write(undirected_edges, Graph_Writer<Adjacency_Matrix<int> >::EDGE_LIST);
+	EXPECT_EQ("# Undirected graph, each edge once: 4 vertices\n-1\t0\n0\t1\n1\t1\n", undirected_edges.str());
+
+	// the matrix output operator
+	ostringstream repr;
+
+	repr << undirected_matrix;
+	EXPECT_EQ("Undirected matrix: 4 vertices, 3 edges\n-1: 0\n0: -1 1\n1: 0 1\n2:\n", repr.str());
+}
+
+TEST_F(GraphWriterTest, labels) {
+	Adjacency_Matrix<string> strings;
+	Adjacency_List<int> list(DEFERRED_DELETION);
+	ostringstream dot, adjacency;
+
+	strings.addVertex("a \"b\"");
+	strings.addVertex("c\\d");
+	strings.addEdge("a \"b\"", "c\\d");
+	Graph_Writer<Adjacency_Matrix<string> >(strings).write(dot, Graph_Writer<Adjacency_Matrix<string> >::DOT);
+	EXPECT_EQ("digraph {\n\t\"a \\\"b\\\"\";\n\t\"a \\\"b\\\"\" -> \"c\\\\d\";\n\t\"c\\\\d\";\n}\n", dot.str());
+
+	// the tombstones and the edges going to them are skipped
+	list.addVertex(7);
+	list.addVertex(8);
+	list.addEdge(7, 8);
+	list.addEdge(8, 7);
+	list.deleteVertex(7);
+	Graph_Writer<Adjacency_List<int> >(list).write(adjacency, Graph_Writer<Adjacency_List<int> >::ADJACENCY);
+	EXPECT_EQ("8:\n", adjacency.str());
+}
+
+TEST_F(GraphWriterTest, parallel) {
+	Adjacency_List<int> list;
+	Adjacency_List<int> loaded;
+	ostringstream sequential, parallel;
+
+	// more vertices than a chunk: the text is formatted in several pieces
+	for (int i = 0; i < 50000; i++) {
+		list.addVertex(i);
+	}
+	for (int i = 0; i < 50000; i++) {
+		list.addEdge(i, (i * 7 + 3) % 50000);
+		if (i % 3 == 0 && (i * 11) % 50000 != (i * 7 + 3) % 50000) {
+			list.addEdge(i, (i * 11) % 50000);
+		}
+	}
+	Compressed_Sparse_Row<int> csr(list);
+
+	Graph_Writer<Compressed_Sparse_Row<int> >(csr, 1).write(sequential, Graph_Writer<Compressed_Sparse_Row<int> >::DOT);
+	Graph_Writer<Compressed_Sparse_Row<int> >(csr, 4, 1000).write(parallel, Graph_Writer<Compressed_Sparse_Row<int> >::DOT);
+	EXPECT_EQ(sequential.str(), parallel.str());
+
+	// the edge list reads back as the same graph
+	Graph_Writer<Adjacency_List<int> >(list, 4).write(path, Graph_Writer<Adjacency_List<int> >::EDGE_LIST);
+	Graph_Loader<int>(4).load(path, loaded);
+	EXPECT_TRUE(loaded.equals(list));
+
+	EXPECT_THROW(Graph_Writer<Adjacency_List<int> >(list).write("no_such_directory/graph.txt",
+			Graph_Writer<Adjacency_List<int> >::DOT), runtime_error);
+}
@@ -0,0 +1,155 @@
+//! \file tests_Mapped_Graph.cpp
+//! \brief Mapped_Graph class and graph file unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "gtest/gtest.h"
+#include "MappedGraph.h"
+#include "CompressedSparseRow.h"
+#include "Algorithms.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  MappedGraphTest fixture
+// *****************************************************************************
+class MappedGraphTest: public ::testing::Test {
+public:
+	MappedGraphTest();
+	Adjacency_List<int> list;
+	Adjacency_Matrix<int> undirected_matrix;
+	const string path;
+
+protected:
+	void SetUp();
+	void TearDown();
+	template<typename Graph> static void expectSameGraph(const Compressed_Sparse_Row<int> &, const Graph &);
+};
+
+MappedGraphTest::MappedGraphTest() : list(DEFERRED_DELETION), undirected_matrix(UNDIRECTED), path("tests_Mapped_Graph.sglg") {}
+
+// 42->43, 42->45, 43->42, 44->44, 45->43 (and a tombstone in the list), undirected in the matrix
+void MappedGraphTest::SetUp() {
+	int edges[][2] = { { 42, 45 }, { 42, 43 }, { 43, 42 }, { 44, 44 }, { 45, 43 } };
+
+	for (int i = 41; i < 47; i++) {
+		list.addVertex(i);
+		undirected_matrix.addVertex(i);
+	}
+	list.addEdge(41, 42);
+	list.addEdge(43, 41);
+	list.deleteVertex(41);
+	undirected_matrix.deleteVertex(41);
+	for (unsigned i = 0; i < 5; i++) {
+		list.addEdge(edges[i][0], edges[i][1]);
+		if (!undirected_matrix.hasEdge(edges[i][0], edges[i][1])) {
+			undirected_matrix.addEdge(edges[i][0], edges[i][1]);
+		}
+	}
+}
+
+void MappedGraphTest::TearDown() {
+	std::remove(path.c_str());
+}
+
+// the mapped graph answers like the CSR built from the same source
+template<typename Graph>
+void MappedGraphTest::expectSameGraph(const Compressed_Sparse_Row<int> &p_expected, const Graph &p_graph) {
+	EXPECT_EQ(p_expected.getConfiguration(), p_graph.getConfiguration());
+	EXPECT_EQ(p_expected.nbVertices(), p_graph.nbVertices());
+	EXPECT_EQ(p_expected.nbEdges(), p_graph.nbEdges());
+	EXPECT_EQ(p_expected.vertices(), p_graph.vertices());
+	EXPECT_EQ(p_expected.edges(), p_graph.edges());
+	EXPECT_EQ(p_expected.fingerprint(), p_graph.fingerprint());
+	for (int i = 42; i < 47; i++) {
+		EXPECT_EQ(p_expected.vertexInDegree(i), p_graph.vertexInDegree(i));
+		EXPECT_EQ(p_expected.vertexOutDegree(i), p_graph.vertexOutDegree(i));
+		EXPECT_EQ(p_expected.vertexNeighborhood(i, true), p_graph.vertexNeighborhood(i, true));
+		for (int j = 42; j < 47; j++) {
+			EXPECT_EQ(p_expected.hasEdge(i, j), p_graph.hasEdge(i, j));
+		}
+	}
+}
+
+TEST_F(MappedGraphTest, list) {
+	Mapped_Graph<int> empty;
+
+	EXPECT_EQ(0u, empty.nbVertices());
+	EXPECT_FALSE(empty.hasVertex(42));
+	EXPECT_TRUE(empty.edges().empty());
+
+	list.save(path);
+
+	Mapped_Graph<int> mapped(path);
+
+	expectSameGraph(Compressed_Sparse_Row<int>(list), mapped);
+	EXPECT_FALSE(mapped.hasVertex(41));
+	EXPECT_TRUE(mapped.equals(list));
+	EXPECT_TRUE(list.equals(mapped));
+	EXPECT_EQ(2u, shortestPathLengths(mapped, mapped.descriptor(45))[mapped.descriptor(42).index()]);
+	EXPECT_THROW(mapped.addVertex(1), logic_error);
+	EXPECT_THROW(mapped.deleteEdge(42, 43), logic_error);
+
+	// the mapping outlives the file name, and moves with the graph
+	std::remove(path.c_str());
+	empty = std::move(mapped);
+	EXPECT_EQ(0u, mapped.nbVertices());
+	EXPECT_EQ(5u, empty.nbEdges());
+	EXPECT_TRUE(empty.hasEdge(45, 43));
+}
+
+TEST_F(MappedGraphTest, matrix) {
+	Adjacency_Matrix<int, Directed> directed;
+
+	undirected_matrix.save(path);
+
+	Mapped_Graph<int> mapped(path);
+
+	expectSameGraph(Compressed_Sparse_Row<int>(undirected_matrix), mapped);
+	EXPECT_TRUE(mapped.hasEdge(43, 45));
+	EXPECT_TRUE(mapped.hasEdge(45, 43));
+	EXPECT_EQ(2u, mapped.vertexOutDegree(44)); // a loop counts twice
+	EXPECT_TRUE(mapped.equals(undirected_matrix));
+
+	// mapping another file replaces the graph
+	for (int i = 0; i < 130; i++) {
+		directed.addVertex(i);
+	}
+	for (int i = 0; i < 130; i++) {
+		directed.addEdge(i, (i * 7) % 130);
+	}
+	directed.save(path);
+	// the file was replaced, not rewritten in place: the old mapping still reads the previous graph
+	expectSameGraph(Compressed_Sparse_Row<int>(undirected_matrix), mapped);
+	mapped.mapFile(path);
+	EXPECT_FALSE(mapped.hasConfiguration(UNDIRECTED));
+	EXPECT_EQ(130u, mapped.nbEdges());
+	EXPECT_TRUE(mapped.hasEdge(129, (129 * 7) % 130));
+	EXPECT_FALSE(mapped.hasEdge((129 * 7) % 130, 129));
+	EXPECT_TRUE(mapped.equals(directed));
+}
+
+TEST_F(MappedGraphTest, invalidFiles) {
+	Mapped_Graph<int> mapped;
+
+	EXPECT_THROW(mapped.mapFile("no_such_file.sglg"), runtime_error);
+	EXPECT_THROW(list.save("no_such_directory/" + path), runtime_error);
+	list.save(path);
+	EXPECT_THROW(Mapped_Graph<double> wrongType(path), logic_error);
+
+	// truncated file
+	ifstream in(path.c_str(), ios::binary);
+	string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+	in.close();
+	ofstream(path.c_str(), ios::binary).write(content.data(), content.size() - 8);
+	EXPECT_THROW(mapped.mapFile(path), logic_error);
+	ofstream(path.c_str(), ios::binary).write("SGLG", 4);
+	EXPECT_THROW(mapped.mapFile(path), logic_error);
+	EXPECT_EQ(0u, mapped.nbVertices()); // untouched by the failures
+}
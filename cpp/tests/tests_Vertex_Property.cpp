@@ -0,0 +1,134 @@
+//! \file tests_Vertex_Property.cpp
+//! \brief Vertex_Property class unit tests
+//! \version 0.1
+
+#include <stdexcept>
+#include <numeric>
+#include "gtest/gtest.h"
+#include "SGL.h"
+
+using namespace SGL;
+using namespace std;
+
+//*********************************FIXTURES************************************
+//*****************************************************************************
+//  VertexPropertyTest fixture
+// *****************************************************************************
+class VertexPropertyTest: public ::testing::Test {
+public:
+	Adjacency_List<int> list;
+	Adjacency_Matrix<int> matrix;
+
+protected:
+	void SetUp();
+};
+
+// vertices 0 to 4 in both graphs, with the edges 0->1, 1->2, 3->4
+void VertexPropertyTest::SetUp() {
+	for (int i = 0; i < 5; i++) {
+		list.addVertex(i);
+		matrix.addVertex(i);
+	}
+	list.addEdge(0, 1);
+	list.addEdge(1, 2);
+	list.addEdge(3, 4);
+	matrix.addEdge(0, 1);
+	matrix.addEdge(1, 2);
+	matrix.addEdge(3, 4);
+}
+
+TEST_F(VertexPropertyTest, listFollowsVertices) {
+	Vertex_Property<double> rank(list, 1.5);
+	Vertex_Property<int> label(list);
+
+	EXPECT_EQ(5u, rank.size());
+	EXPECT_EQ(7.5, accumulate(rank.begin(), rank.end(), 0.0));
+	for (int i = 0; i < 5; i++) {
+		label[list.descriptor(i)] = i * 10;
+	}
+	list.addVertex(5);
+	EXPECT_EQ(6u, label.size());
+	EXPECT_EQ(0, label[list.descriptor(5)]);
+	EXPECT_EQ(1.5, rank[list.descriptor(5)]);
+	list.deleteVertex(1); // the vertices above are shifted, and their values with them
+	EXPECT_EQ(5u, label.size());
+	EXPECT_EQ(20, label[list.descriptor(2)]);
+	EXPECT_EQ(40, label[list.descriptor(4)]);
+	EXPECT_EQ(0, label[list.descriptor(5)]);
+	list.addEdge(5, 0); // edges don't move the vertices
+	EXPECT_EQ(0, label[list.descriptor(0)]);
+	EXPECT_EQ(30, label[list.descriptor(3)]);
+}
+
+TEST_F(VertexPropertyTest, listDeferredDeletion) {
+	Adjacency_List<int> deferred(DEFERRED_DELETION);
+	Vertex_Property<int> label(deferred, -1);
+
+	for (int i = 0; i < 6; i++) {
+		deferred.addVertex(i);
+		label[deferred.descriptor(i)] = i;
+	}
+	deferred.deleteVertex(1);
+	deferred.deleteVertex(3);
+	EXPECT_EQ(6u, label.size()); // tombstones keep their slot
+	deferred.addVertex(10); // reuses a slot, with the default value
+	EXPECT_EQ(-1, label[deferred.descriptor(10)]);
+	EXPECT_EQ(6u, label.size());
+	label[deferred.descriptor(10)] = 10;
+	deferred.compact();
+	EXPECT_EQ(5u, label.size());
+	EXPECT_EQ(deferred.indexBound(), label.size());
+	EXPECT_EQ(0, label[deferred.descriptor(0)]);
+	EXPECT_EQ(2, label[deferred.descriptor(2)]);
+	EXPECT_EQ(4, label[deferred.descriptor(4)]);
+	EXPECT_EQ(5, label[deferred.descriptor(5)]);
+	EXPECT_EQ(10, label[deferred.descriptor(10)]);
+}
+
+TEST_F(VertexPropertyTest, matrixFollowsVertices) {
+	Vertex_Property<int> label(matrix);
+	vector<int> batch;
+
+	for (int i = 0; i < 5; i++) {
+		label[matrix.descriptor(i)] = i * 10;
+	}
+	batch.push_back(7);
+	batch.push_back(8);
+	matrix.addVertices(batch.begin(), batch.end());
+	EXPECT_EQ(7u, label.size());
+	EXPECT_EQ(0, label[matrix.descriptor(8)]);
+	matrix.deleteVertex(0);
+	EXPECT_EQ(6u, label.size());
+	EXPECT_EQ(10, label[matrix.descriptor(1)]);
+	EXPECT_EQ(40, label[matrix.descriptor(4)]);
+}
+
+TEST_F(VertexPropertyTest, copiesAndLifetime) {
+	Vertex_Property<int> label(list, 3);
+	Adjacency_List<int> other(list);
+
+	// a copy of the graph has no property attached
+	other.addVertex(5);
+	EXPECT_EQ(5u, label.size());
+	{
+		Vertex_Property<int> copy(label); // a copy of the property follows the same graph
+		list.addVertex(6);
+		EXPECT_EQ(6u, copy.size());
+	}
+	list.addVertex(7); // the copy has been detached
+	EXPECT_EQ(7u, label.size());
+	// an assigned graph gets new vertices: its properties are reset
+	list = other;
+	EXPECT_EQ(6u, label.size());
+	EXPECT_EQ(3, label[list.descriptor(5)]);
+
+	Vertex_Property<int> *orphan;
+	{
+		Adjacency_Matrix<int> local;
+
+		local.addVertex(1);
+		orphan = new Vertex_Property<int>(local, 2);
+	}
+	EXPECT_EQ(1u, orphan->size()); // the graph is gone, the values stay
+	delete orphan;
+}